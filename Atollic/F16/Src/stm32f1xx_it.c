@@ -40,7 +40,7 @@
 /* USER CODE BEGIN Includes */
 #include "system.h"		//-- HandleControlIT
 #include "limits.h"		//-- HandleLimitIT
-#include "stepper.h"	//-- HandleStepSetIT and HandleStepResetIT
+#include "stepper.h"	//-- HandleStepSetIT, HandleStepResetIT and HandleStepDMAIT
 #include "serial.h"		//-- HandleUartIT
 /* USER CODE END Includes */
 
@@ -289,7 +289,6 @@ void TIM2_IRQHandler(void)
   if ((TIM2->SR & 0x0001) != 0)                  // check interrupt source
   {
 	TIM2->SR &= ~(1 << 0);                          // clear UIF flag
-	TIM2->CNT = 0;
 	HandleStepSetIT();
   }
 
@@ -359,6 +358,24 @@ void EXTI15_10_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+#ifdef STEP_PULSE_DMA
+/**
+  * @brief This function handles DMA1 channel2 global interrupt (step pulse BSRR stream).
+  */
+void DMA1_Channel2_IRQHandler(void)
+{
+  if (LL_DMA_IsActiveFlag_HT2(DMA1))
+    {
+    LL_DMA_ClearFlag_HT2(DMA1);
+    HandleStepDMAIT(0);		//-- first half sent, refill it
+    }
+  if (LL_DMA_IsActiveFlag_TC2(DMA1))
+    {
+    LL_DMA_ClearFlag_TC2(DMA1);
+    HandleStepDMAIT(1);		//-- second half sent, refill it
+    }
+}
+#endif
 
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -313,7 +313,6 @@ void TIM5_IRQHandler(void)
   if (LL_TIM_IsActiveFlag_UPDATE(TIM5))
 	{
 	LL_TIM_ClearFlag_UPDATE(TIM5);
-	LL_TIM_SetCounter(TIM5, 0);
     HandleStepSetIT();
 	}
 
@@ -437,6 +437,7 @@
 // user-supplied step pulse time, the total time must not exceed 127us. Reported successful
 // values for certain setups have ranged from 5 to 20us.
 // #define STEP_PULSE_DELAY 10 // Step pulse delay in microseconds. Default disabled.
+// NOTE: On STM32 this maps to STEP_DIR_SETUP_NS and needs STEP_PULSE_ONE_SHOT, see below.
 
 // The number of linear motions in the planner buffer to be planned at any give time. The vast
 // majority of RAM that Grbl uses is based on this buffer size. Only increase if there is extra
@@ -450,7 +451,8 @@
 // fixed time defined by ACCELERATION_TICKS_PER_SECOND. They are computed such that the planner
 // block velocity profile is traced exactly. The size of this buffer governs how much step
 // execution lead time there is for other Grbl processes have to compute and do their thing
-// before having to come back and refill this buffer, currently at ~50msec of step moves.
+// before having to come back and refill this buffer, currently at ~6msec of step moves with 32
+// segments of 200usec. Not used with SEGMENT_BUFFER_ARENA, which sizes it from the $60 depth.
 // #define SEGMENT_BUFFER_SIZE 6 // Uncomment to override default in stepper.h.
 
 // Line buffer size from the serial input stream to be executed. Also, governs the size of
@@ -728,7 +730,389 @@
  */
 
 
+// #define ENABLE_PREP_PROFILE
+/* ---------------------------------------------------------------------------------------
+ * Profile the step segment generator, st_prep_buffer(), against its time budget
+ *   every segment lasts 1/ACCELERATION_TICKS_PER_SECOND, 200us at 5000, and the segment buffer
+ *   must be refilled within that while parsing, planning and reporting share the main loop.
+ *
+ *   CPU cycles spent per generated segment are kept per ramp type, using the DWT cycle counter.
+ *   The fewest segments seen left in the buffer while stepping and the number of times the
+ *   buffer ran dry with motion still pending show how much headroom is left.
+ *
+ * $P   prints the profile and starts a new one, allowed while running
+ *      [PREP:ACCEL,<segments>,<avg cycles>,<max cycles>]  one line per ramp type
+ *      [PREPBUF:<low water>,<buffer size>,<underruns>,<cycles per segment>]
+ */
+
+
+// #define ENABLE_STEP_ISR_PROFILE
+/* ---------------------------------------------------------------------------------------
+ * Profile the stepper driver interrupt, HandleStepSetIT(), to validate the maximum step rate
+ *   of each board. Always on once compiled in: a DWT cycle count and a few compares per tick.
+ *
+ *   ISR durations are binned in a histogram of powers of two, bin 0 below 64 cycles and
+ *   bin 7 at 4096 cycles and above. Also counted are
+ *     overruns   : the next tick was already pending when the ISR finished
+ *     latency    : the most step timer ticks from the update to the ISR entry. The timer
+ *                  free-runs, so latency moves a step edge without stretching the period
+ *     reentries  : ticks dropped by the busy flag
+ *
+ * Adds a realtime status report field, restarted by $P
+ *   |ISR:<max cycles>,<average cycles>,<overruns>,<latency>,<reentries>,<bin 0>,...,<bin 7>
+ *   Every '?' reply grows by these 13 values. For bench work only: senders that parse the status
+ *   line strictly may not accept it.
+ */
+
+// #define STEP_PULSE_DMA
+/* ---------------------------------------------------------------------------------------
+ * Emit step pulses by DMA instead of the step set/reset interrupts. F13 and F16 only.
+ *
+ *   The segment Bresenham runs ahead of the motor and writes, tick by tick, the GPIO BSRR word
+ *   and the timer interval of each edge into a circular buffer. The step timer update requests
+ *   stream both back into STEP_GPIO_Port->BSRR and STEP_SET_TIMER->ARR, so the CPU only runs
+ *   at the half and complete transfer interrupts to refill the buffer, every 64 edges.
+ *
+ *   Needs ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING. Homing and probing keep the interrupt driver,
+ *   since both must stop on the very step a switch triggers. The machine position runs ahead of the
+ *   motor by up to one buffer, steps not yet output are taken back out when motion is aborted.
+ *   For the same reason feed holds and overrides take effect up to one buffer later, at most
+ *   64 steps.
+ *   Not available on F46: DMA1 is the only controller mapped to TIM5 and it cannot reach the
+ *   AHB1 GPIO ports.
+ *
+ *   The CubeMX projects do not configure DMA1, Step_DMA_Init() sets it up at run time.
+ *   Compare the pulse train with the interrupt driver on the host: make -C sim compare
+ */
+
+#if defined(STM32F1) && !defined(ST_PREP_FLOAT)
+#define ST_PREP_FIXED_POINT
+#endif
+/* ---------------------------------------------------------------------------------------
+ * Run the segment generator, st_prep_buffer(), in integer arithmetic. Default on the F1, whose
+ *   Cortex-M3 has no FPU and pays a soft-float call for every float operation of the ramp.
+ *   Define ST_PREP_FLOAT to keep the float path.
+ *
+ *   Distances are counted in steps as Q32.32, speeds in steps per timer tick as Q.40 and the
+ *   acceleration in steps per tick squared as Q.60, so segment times come out directly in
+ *   timer ticks. Step counts are exact by construction. Floats remain only where a block
+ *   profile is computed, once per block or override, and in the mm values mirrored back
+ *   to the planner.
+ *
+ *   Both paths step the same positions. Both round step periods up to whole ticks and take the
+ *   excess back from the following segments, so it does not add up to a rate error. The float path
+ *   is the less exact one: it keeps the distance left as a float total, rounded on every ramp
+ *   pass, which moves its steps by a part of their interval. The part left at a stop carries
+ *   over to every later step, so the two drift apart by up to 0.8ms over sim/ovr.nc.
+ *   Check the step output against the float path on the host: make -C sim prepcheck, which fails
+ *   when a step is off by more than its interval plus PREP_TOL, 1us by default, from the steps
+ *   since the axis last slowed down.
+ */
+
+#if defined(STM32F4) && !defined(STEP_TIMER_16BIT)
+#define STEP_TIMER_32BIT
+#endif
+/* ---------------------------------------------------------------------------------------
+ * Time steps with the full 32-bit period of the F4 step timer, TIM5, at 84MHz. Default on the
+ *   F4, define STEP_TIMER_16BIT to keep the 16-bit timing of the F1 boards.
+ *
+ *   A 16-bit period tops out at 0.78ms. The top AMASS level stretches that by 2^MAX_AMASS_LEVEL,
+ *   32x at the default of 5 levels, so step periods over 25ms used to be clamped to it. Very slow
+ *   feeds on fine-pitched axes such as rotary axes or slow probing ran too fast. With 32 bits any
+ *   step period up to 51s is exact and the AMASS levels only select the smoothing, not the timer
+ *   range.
+ *
+ *   Compare the step timing of both modes at low feed rates on the host: make -C sim slowfeed,
+ *   which steps every 120ms by default, past the 16-bit clamp.
+ */
+
+// #define S_CURVE_ACCELERATION
+/* ---------------------------------------------------------------------------------------
+ * Jerk-limited (S-curve) acceleration. Each acceleration and deceleration ramp of the step
+ *   segment generator ramps its acceleration up and back down at the block jerk, instead of
+ *   switching it on and off. Adds the per-axis jerk settings $140-$145 in mm/sec^3, limited
+ *   along the line direction like the accelerations. An axis set to 0 does not limit jerk.
+ *
+ *   The $120-$125 accelerations remain the peak acceleration. Each ramp lasts longer than at
+ *   constant acceleration by acceleration/jerk, the time to ramp the acceleration up and down,
+ *   and covers the matching extra distance, which the planner includes in its junction and
+ *   entry speeds. A speed change too small to reach the acceleration is a pure jerk ramp of
+ *   2*sqrt(speed change/jerk). Each ramp ends with zero acceleration where the next one starts.
+ *   A ramp interrupted by a feed hold or an override restarts from zero acceleration.
+ *
+ *   Ramps are shaped by the float segment generator, so the F1 boards also need ST_PREP_FLOAT.
+ *   Changes the settings layout, so enabling it restores the default settings.
+ */
+
+// #define INPUT_SHAPING
+/* ---------------------------------------------------------------------------------------
+ * Input shaping against frame resonance. The acceleration of each ramp is convolved with the
+ *   impulses of a ZV, ZVD or MZV shaper tuned to the resonance of the moving axes, so that the
+ *   vibration excited where the acceleration starts is cancelled where it stops, instead of
+ *   ringing on after the ramp. Per-axis settings:
+ *     $150-$155 shaper: 0 none, 1 ZV, 2 ZVD, 3 MZV
+ *     $160-$165 resonance frequency in Hz
+ *     $170-$175 damping ratio, 0 to below 1 (0.05-0.1 for a typical gantry)
+ *   The shapers of all axes moving in a block are combined, up to three different ones.
+ *   The shaped ramp keeps the $120-$125 acceleration and lasts the shaper duration longer,
+ *   covering the matching extra distance, which the planner includes in its junction and
+ *   entry speeds. Combines with S_CURVE_ACCELERATION. Shaper durations at 40Hz: ZV 12.5ms,
+ *   MZV 18.8ms, ZVD 25ms.
+ *   Not shaped: the change of direction at a junction, which changes the axis speeds at once
+ *   within the junction deviation, and the cut where a feed hold or an override interrupts a
+ *   ramp. The ramp that follows the cut is shaped.
+ *
+ *   Measure the residual vibration on a modelled mass-spring axis: make -C sim resonance
+ *   F1 boards need ST_PREP_FLOAT. Changes the settings layout, so enabling it restores the
+ *   default settings.
+ */
+
+// #define STEP_PULSE_ONE_SHOT
+// #define STEP_DIR_SETUP_NS 2000
+/* ---------------------------------------------------------------------------------------
+ * Step pulse timed by the reset timer in one-pulse mode instead of the reset interrupt. The
+ *   step interrupt writes the direction pins and restarts the timer; its compare match after
+ *   the direction setup time and its update at the end of the pulse each trigger a DMA write
+ *   of the step and idle words to the step port BSRR. One interrupt per step instead of two,
+ *   and the pulse width no longer depends on interrupt latency.
+ *   STEP_DIR_SETUP_NS: delay from the direction write to the step edge, in nanoseconds,
+ *   rounded up to timer ticks, at least one tick. Setup plus $0 must stay below the shortest
+ *   step period, or pulses are cut short and steps are lost.
+ *   F13 and F16 only: on F46 the reset timer requests DMA1, which cannot reach the GPIO ports.
+ *   Check the step edges against the reset interrupt: make -C sim pulsecheck PROG=job.nc
+ */
+
+#define ADAPTIVE_SEGMENT_DURATION
+/* ---------------------------------------------------------------------------------------
+ * Long segments while cruising. A segment normally lasts 1/ACCELERATION_TICKS_PER_SECOND,
+ *   200us, wherever it is in the velocity profile, so a long cruise costs the segment
+ *   generator thousands of identical iterations. A segment that starts in cruise lasts up to a
+ *   quarter of the segment buffer time instead, about 1.5ms with 32 segments, and ends early
+ *   where the deceleration starts. Acceleration and deceleration ramps, and with them the laser
+ *   power of LASER_MODE, keep the short segments.
+ *
+ *   While cruising, the segment buffer is filled to the motion time its SEGMENT_BUFFER_SIZE-1
+ *   short segments hold, or the $60 depth with SEGMENT_BUFFER_ARENA, beyond the executing
+ *   segment, rather than to a number of entries, so feed holds and overrides start within the
+ *   same time as before. With STEP_PULSE_DMA it also
+ *   holds at least half a DMA buffer of ISR ticks, since a refill takes them at once.
+ *   A G1X200F3000 move takes 2500 segments instead of 19374.
+ */
+
+#define SEGMENT_BUFFER_ARENA
+/* ---------------------------------------------------------------------------------------
+ * Segment buffer depth set in time. The segment buffer and the block data of its segments are
+ *   laid out in a static arena of SEGMENT_BUFFER_ARENA_SIZE bytes, 2048 on F1 and 8192 on F4 by
+ *   default, to hold the motion time of $60 in ms after the executing segment. A deeper buffer
+ *   rides out longer main loop stalls, like flash writes or long reports, and delays feed holds
+ *   and overrides as much. The default of 6ms is the 32 segments of the fixed buffer.
+ *
+ *   $60 is applied right away while idle. It is cut back to what the arena holds and to 253
+ *   segments of 200us, about 50ms, the most the 8-bit buffer indices address. With
+ *   ADAPTIVE_SEGMENT_DURATION, cruise fills the same time in fewer, longer segments.
+ *
+ *   With ENABLE_PREP_PROFILE, $P adds the motion time queued at each refill while stepping
+ *      [PREPTIME:<low water ms>,<mean ms>,<depth ms>]
+ *   The PREPBUF buffer size is the number of segments laid out.
+ */
+
+#define AMASS_ISR_LOAD 20
+// #define MAX_AMASS_LEVEL 5
+/* ---------------------------------------------------------------------------------------
+ * AMASS levels from the CPU budget of the stepper ISR. Grbl's 3 AMASS levels overdrive the ISR
+ *   to at most 16kHz, tuned for a 16MHz AVR. Instead, the ISR is overdriven up to the rate where
+ *   it takes AMASS_ISR_LOAD percent of the CPU: SystemCoreClock/STEP_ISR_CYCLES*AMASS_ISR_LOAD/100,
+ *   over MAX_AMASS_LEVEL levels, 5 by default and up to 6. Each segment takes the highest level
+ *   that stays within the budget, so slow multi-axis moves step smoother while fast ones do not
+ *   overdrive the ISR at all.
+ *
+ *   STEP_ISR_CYCLES, the cost of an ISR tick, is set per board in stm32_pin_out.h. The defaults
+ *   are estimates: set it to the mean cycles of the ISR profile, ENABLE_STEP_ISR_PROFILE, taken
+ *   on the machine. At the default 20%, the ISR ticks at up to 32kHz on F13 at 72MHz and 67kHz
+ *   on F46 at 168MHz, with level 5 below 1kHz and 2.1kHz steps.
+ *
+ *   Block step counts are scaled by 2^MAX_AMASS_LEVEL, so at 6 levels a block is limited to 2^26
+ *   steps on its longest axis. The slowest step rate of the 16-bit F1 timer also drops by
+ *   2^MAX_AMASS_LEVEL.
+ *
+ *   Compare the aliasing of each level in the sim: make -C sim aliasing
+ */
 
 
+// #define ADAPTIVE_LOOKAHEAD
+// #define LOOKAHEAD_TIME 250 // ms
+/* ---------------------------------------------------------------------------------------
+ * Planner lookahead set by distance and time instead of a block count. The planner can only
+ *   run at the nominal speed when the path buffered after the executing block is at least the
+ *   stopping distance, v^2/(2*acceleration), since the last block is planned to a stop. 200
+ *   blocks of 0.05mm CAM segments are 10mm, far less than that at the usual feeds.
+ *
+ *   Once LOOKAHEAD_BLOCKS, 200 by default and 150 on F1, are buffered, the buffer only counts as full when the
+ *   path after the executing block covers the stopping distance of the newest block at its
+ *   nominal speed and LOOKAHEAD_TIME ms of motion, so a stall in the stream shorter than that
+ *   does not slow the machine down. Until then short blocks are chained from the rest of the
+ *   BLOCK_BUFFER_SIZE pool, PLANNER_BLOCKS_F4 on F4. F1 keeps its 200 blocks, all its 20KB of
+ *   RAM has room for. Longer blocks fill both with fewer blocks and plan as before.
+ *
+ *   While the buffer is shorter than the stopping distance, every new block raises the entry
+ *   speed of every block in it, so planning takes time in proportion to the window. On F4 a new
+ *   block only replans the last LOOKAHEAD_RECALC_BLOCKS, see PLANNER_BLOCKS_F4, which then limits
+ *   how far ahead the planner looks. F1 replans at most its 200 blocks, as without the option.
+ *
+ *   With ENABLE_PREP_PROFILE, $P adds the lookahead window and starts a new high water mark
+ *      [PLAN:<blocks>,<most blocks>,<lookahead mm>,<lookahead ms>,<stopping mm>]
+ *
+ *   Compare the average feed reached on dense toolpaths: sim/grbl_bench -a 50 -g contour:50000
+ */
+
+
+#define PLANNER_BLOCKS_F4 1024
+/* ---------------------------------------------------------------------------------------
+ * Planner block pool of the F4, instead of the 200 blocks of the F1 boards. A sender that counts
+ *   characters keeps the pool topped up with short CAM lines through the 1024 character serial
+ *   RX buffer, so a stall in the stream or a burst of tiny blocks does not run the plan dry. Each
+ *   block takes 48 bytes with 3 axes and 60 with 6, so 1024 blocks take 48KB to 60KB of the
+ *   128KB of main SRAM, against 9.4KB to 11.7KB for 200. Planner and serial ring indices are
+ *   16-bit on all boards.
+ *
+ *   A new block replans back to the last block already planned at its best, up to the whole pool
+ *   when the stopping distance spans it. With more than 512 blocks it only replans the last
+ *   LOOKAHEAD_RECALC_BLOCKS, 512 by default, which bounds the time planning takes. Blocks further
+ *   back keep the speeds they were planned with, still a valid plan. A feed hold or override
+ *   change replans the whole pool. Comment out for the 200 blocks of the F1 boards.
+ *   ADAPTIVE_LOOKAHEAD decides when the pool counts as full, see above.
+ */
+
+
+#define STEPPER_CCM_RAM
+/* ---------------------------------------------------------------------------------------
+ * Places the stepper ISR data and the segment buffer with its block data, st, segment_buffer
+ *   and st_block_buffer, in the 64KB core coupled RAM of the F407. The CPU reads it on its data
+ *   bus with no wait states and without contending with DMA and the instruction fetches on the
+ *   main SRAM buses, and it leaves the main SRAM to the planner block pool. The F46 linker
+ *   scripts map the zero initialized .ccmbss section to CCMRAM and the startup code clears it.
+ *   F1 boards have no CCM RAM and ignore the option.
+ *
+ *   The planner block is laid out with the fields planner_recalculate() walks, entry_speed_sqr,
+ *   max_entry_speed_sqr, pbacceleration and millimeters, at its start and the byte fields at its
+ *   end. It is no longer cleared for every new block, every field is written instead. A block is
+ *   48 bytes at 3 axes, 1024 of them take 48KB.
+ *
+ *   NOTE: CCM RAM is not reachable by DMA. st stays in the main SRAM with STEP_PULSE_ONE_SHOT.
+ */
+
+
+// #define LAZY_OVERRIDE_REPLAN
+/* ---------------------------------------------------------------------------------------
+ * Applies feed and rapid override changes to the plan a few blocks at a time. Grbl updates the
+ *   nominal speed of every buffered block and replans the whole buffer before it handles the
+ *   next realtime command, which takes longer the deeper the buffer is.
+ *
+ *   With the option, an override change only replans the executing block from its current
+ *   speed and the next PLAN_RECONCILE_BLOCKS, 32 by default. Every later pass of the main loop
+ *   carries the change through that many more blocks, as does the segment generator when it
+ *   reaches a block not yet done. Until then these blocks keep the plan of the old override,
+ *   which still ends in a stop. Each step replans the new blocks together with as many before
+ *   them, so quick changes in both directions leave no stale slowdown ahead of the tool.
+ *
+ *   With ADAPTIVE_LOOKAHEAD the lookahead time is scaled by the speed change of the newest
+ *   block, instead of summed again over the buffer.
+ *
+ *   Compare the stall of an override change on a full buffer: sim/grbl_bench -a 50 -g override:50000
+ */
+
+
+#define ENABLE_PATH_BLENDING
+/* ---------------------------------------------------------------------------------------
+ * Adds G64 P<tolerance> continuous path mode. G61, exact path, stays the default. At every
+ *   corner between two G1 lines, Grbl slows down to the speed the junction deviation allows.
+ *   On pocketing jobs with many square corners that slowdown sets the cycle time.
+ *
+ *   In G64, mc_line() holds each G1 line back until the next one arrives. It then replaces the
+ *   corner with an arc tangent to both lines that passes the corner within the tolerance, in
+ *   current units, and plans it in arc_tolerance segments like G2/G3. A line gives up at most
+ *   half its length to the arcs at its ends. Corners that would be no faster than with the
+ *   junction deviation are kept. G64 without P blends no corner.
+ *
+ *   The held line is planned as is before any other motion, buffer sync or dwell, and when the
+ *   planner is down to one block, so a program or a single typed line does not wait for more.
+ *   Arcs, rapids, G93 inverse time moves and jogs are not blended. $G reports G64 when active.
+ */
+
+
+#define ENABLE_LINE_COALESCING
+/* ---------------------------------------------------------------------------------------
+ * Merges runs of straight feed lines into single planner blocks. CAM output often splits a
+ *   straight cut into hundreds of collinear micro-segments, each of which takes a planner block,
+ *   a junction computation and a replan, and shortens the lookahead the buffer holds.
+ *
+ *   mc_line() holds the last G1 line back, as ENABLE_PATH_BLENDING does. A new line with the
+ *   same feed rate, spindle speed and spindle and coolant state is merged into it, if the ends
+ *   of all lines merged so far stay within $61 mm of the combined line and do not double back
+ *   along it. Up to LINE_COALESCE_MAX lines, 16 by default, are merged into one. The block
+ *   reports the line number of the last one.
+ *
+ *   $61 is the chord tolerance, 0 by default to merge nothing and hold nothing back. Set it to
+ *   0.001 mm, well below a step, to merge.
+ *   The held line is released as with ENABLE_PATH_BLENDING. Arc segments are held and merged
+ *   like G1 lines. Rapids, G93 inverse time moves and jogs are not.
+ */
+
+
+// #define PLANNER_ARC_BLOCKS
+/* ---------------------------------------------------------------------------------------
+ * Plans each G2/G3 arc as a single block. mc_arc() otherwise splits an arc into $12 chords,
+ *   one planner block each, and the parser waits until the last one is queued. A job of small
+ *   arcs, like adaptive clearing, then fills the planner with chords and the lookahead does
+ *   not cover the distance to reach the programmed feed.
+ *
+ *   The arc geometry goes in a ring of its own, PLANNER_ARC_BUFFER_SIZE arcs, 256 on the F4
+ *   and 16 on the F1. The block is planned on the helix length, with the acceleration and
+ *   maximum rate of the worst direction along it. Its speed is also limited to sqrt(a*r), with
+ *   a the lower acceleration of the plane axes, so the centripetal acceleration stays within
+ *   it. Junctions use the tangents at the arc ends.
+ *
+ *   st_prep_buffer() traces the velocity profile along the arc and steps each segment as a
+ *   chord between points of the arc, cut to stay within $12. Arcs of a single chord are still
+ *   planned as lines. Soft limits check the arc end and the points where it reaches furthest
+ *   along the plane axes. Not compatible with COREXY.
+ */
+
+
+// #define CENTRIPETAL_SPEED_LIMIT
+/* ---------------------------------------------------------------------------------------
+ * Limits the speed along arc chords to sqrt(a*r), the speed at which the centripetal
+ *   acceleration of the arc radius r reaches a, the lowest acceleration the axis settings allow
+ *   in the plane of the arc. Without it, the chords of an arc are only slowed by the junction
+ *   deviation between them, which depends on $11 and $12 and not on the radius. Small arcs are
+ *   then taken faster than the axes can turn, and large ones slower than they could be.
+ *
+ *   mc_arc() passes the curvature radius of the arc, helix included, with its chords. Their
+ *   maximum rate is capped at sqrt(a*r), and the junctions between them, which are points of
+ *   the arc, use that speed in place of the junction deviation. The junction at the start of
+ *   the arc is still a corner. ENABLE_PATH_BLENDING arcs are limited the same way, in the plane
+ *   of the corner. PLANNER_ARC_BLOCKS arcs always are.
+ */
+
+
+#define ENABLE_SPLINE_MOTION
+#define SPLINE_SEGMENT_TIME 2 // ms
+/* ---------------------------------------------------------------------------------------
+ * Adds G5 cubic and G5.1 quadratic spline motion in the G17 plane, as in LinuxCNC. CAM output
+ *   of splines as thousands of short G1 lines is limited by the serial link long before the
+ *   planner. One spline line replaces them.
+ *
+ *   G5 X Y I J P Q is a cubic Bezier curve to X Y. I J is the first control point, offset from
+ *   the start, P Q the second one, offset from the end. I J can be left out on a G5 that follows
+ *   a G5, to continue tangent to it with the reflection of its P Q. G5.1 X Y I J is a quadratic
+ *   curve with the single control point I J, offset from the start. Other axes move linearly
+ *   along the curve parameter. G93 inverse time is on the curve length.
+ *
+ *   mc_spline() cuts the curve into chords as it queues them, each as long as the curvature
+ *   along it allows to stay within $12, but no shorter than SPLINE_SEGMENT_TIME ms of motion at
+ *   the programmed feed. With CENTRIPETAL_SPEED_LIMIT the chords are limited to the speed of
+ *   the curvature radius like arc chords. $G reports G5 and G5.1.
+ */
+
 
 #endif //-- inclusion
@@ -119,6 +119,13 @@
   #define DEFAULT_B_MAX_TRAVEL 150.0f // mm NOTE: Must be a positive value.	$134
   #define DEFAULT_C_MAX_TRAVEL 150.0f // mm NOTE: Must be a positive value.	$135
 
+  #define DEFAULT_X_JERK (20000.0f*60*60*60) // 20000*60*60*60 mm/min^3 = 20000 mm/sec^3	$140
+  #define DEFAULT_Y_JERK (20000.0f*60*60*60) // 20000*60*60*60 mm/min^3 = 20000 mm/sec^3	$141
+  #define DEFAULT_Z_JERK (20000.0f*60*60*60) // 20000*60*60*60 mm/min^3 = 20000 mm/sec^3	$142
+  #define DEFAULT_A_JERK (20000.0f*60*60*60) // 20000*60*60*60 mm/min^3 = 20000 mm/sec^3	$143
+  #define DEFAULT_B_JERK (20000.0f*60*60*60) // 20000*60*60*60 mm/min^3 = 20000 mm/sec^3	$144
+  #define DEFAULT_C_JERK (20000.0f*60*60*60) // 20000*60*60*60 mm/min^3 = 20000 mm/sec^3	$145
+
 
   #define DEFAULT_STEP_PULSE_MICROSECONDS 0.5		//usec		$0
   #define DEFAULT_STEPPER_IDLE_LOCK_TIME 1 // msec (0-254, 255 keeps steppers enabled)	$1
@@ -614,4 +621,38 @@
   #define DEFAULT_HOMING_PULLOFF 1.0 // mm
 #endif
 
+// Jerk for S_CURVE_ACCELERATION on machines without their own: the acceleration is reached in 20ms.
+#ifndef DEFAULT_X_JERK
+  #define DEFAULT_X_JERK (DEFAULT_X_ACCELERATION*50*60) // mm/min^3
+  #define DEFAULT_Y_JERK (DEFAULT_Y_ACCELERATION*50*60)
+  #define DEFAULT_Z_JERK (DEFAULT_Z_ACCELERATION*50*60)
+  #ifdef DEFAULT_A_ACCELERATION
+    #define DEFAULT_A_JERK (DEFAULT_A_ACCELERATION*50*60)
+  #endif
+  #ifdef DEFAULT_B_ACCELERATION
+    #define DEFAULT_B_JERK (DEFAULT_B_ACCELERATION*50*60)
+  #endif
+  #ifdef DEFAULT_C_ACCELERATION
+    #define DEFAULT_C_JERK (DEFAULT_C_ACCELERATION*50*60)
+  #endif
+#endif
+
+// Input shaping for INPUT_SHAPING, applied to all axes. Off until the measured resonance is set.
+#ifndef DEFAULT_SHAPER_TYPE
+  #define DEFAULT_SHAPER_TYPE SHAPER_NONE // $150-$155
+  #define DEFAULT_SHAPER_FREQUENCY 40.0f // Hz	$160-$165
+  #define DEFAULT_SHAPER_DAMPING 0.1f // $170-$175
+#endif
+
+// Segment buffer depth for SEGMENT_BUFFER_ARENA: the 32 segments of the fixed buffer.
+#ifndef DEFAULT_SEGMENT_BUFFER_MS
+  #define DEFAULT_SEGMENT_BUFFER_MS 6 // msec	$60
+#endif
+
+// Chord tolerance for ENABLE_LINE_COALESCING. Zero merges nothing until set. 0.001 is well below
+// a step on any machine here.
+#ifndef DEFAULT_COALESCE_TOLERANCE
+  #define DEFAULT_COALESCE_TOLERANCE 0.0 // mm	$61
+#endif
+
 #endif
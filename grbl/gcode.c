@@ -56,6 +56,9 @@ void gc_init()
 void gc_sync_position()
 {
 	system_convert_array_steps_to_mpos(gc_state.position, sys_position);
+#ifdef MC_LINE_HOLD
+	mc_hold_reset(); // A line held back no longer starts at the parser position.
+#endif
 }
 
 // Executes one line of 0-terminated G-Code. The line is assumed to contain only uppercase
@@ -197,6 +200,9 @@ uint8_t gc_execute_line(char *line)
 			case 1:
 			case 2:
 			case 3:
+#ifdef ENABLE_SPLINE_MOTION
+			case 5:
+#endif
 			case 38:
 				// Check for G0/1/2/3/38 being called with G10/28/30/92 on same block.
 				// * G43.1 is also an axis command but is not explicitly defined this way.
@@ -219,6 +225,13 @@ uint8_t gc_execute_line(char *line)
 					gc_block.modal.motion += (mantissa / 10) + 100;
 					mantissa = 0; // Set to zero to indicate valid non-integer G command.
 				}
+#ifdef ENABLE_SPLINE_MOTION
+				if ((int_value == 5) && (mantissa == 10))
+				{ // G5.1
+					gc_block.modal.motion = MOTION_MODE_QUADRATIC_SPLINE;
+					mantissa = 0; // Set to zero to indicate valid non-integer G command.
+				}
+#endif
 				break;
 			case 17:
 			case 18:
@@ -296,12 +309,22 @@ uint8_t gc_execute_line(char *line)
 				gc_block.modal.coord_select = int_value - 54; // Shift to array indexing.
 				break;
 			case 61:
+#ifdef ENABLE_PATH_BLENDING
+			case 64:
+#endif
 				word_bit = MODAL_GROUP_G13;
 				if (mantissa != 0)
 				{
 					FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND);
 				} // [G61.1 not supported]
-				// gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
+				if (int_value == 61)
+				{
+					gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
+				}
+				else
+				{
+					gc_block.modal.control = CONTROL_MODE_CONTINUOUS; // G64
+				}
 				break;
 			default:
 				FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND)
@@ -565,8 +588,14 @@ uint8_t gc_execute_line(char *line)
 			} // [Word repeated]
 			// Check for invalid negative values for words F, N, P, T, and S.
 			// NOTE: Negative value check is done here simply for code-efficiency.
+#ifdef ENABLE_SPLINE_MOTION
+			// P is checked with the motion mode below, as G5 allows it negative.
+			if ( bit(word_bit)
+					& (bit(WORD_F) | bit(WORD_N) | bit(WORD_T) | bit(WORD_S)))
+#else
 			if ( bit(word_bit)
 					& (bit(WORD_F) | bit(WORD_N) | bit(WORD_P) | bit(WORD_T) | bit(WORD_S)))
+#endif
 			{
 				if (value < 0.0)
 				{
@@ -616,6 +645,18 @@ uint8_t gc_execute_line(char *line)
 		} // Assign implicit motion-mode
 	}
 
+#ifdef ENABLE_SPLINE_MOTION
+	// P is a control point offset with G5. Any other use cannot be negative.
+	if (bit_istrue(value_words, bit(WORD_P)) && (gc_block.values.p < 0.0))
+	{
+		if (!((axis_command == AXIS_COMMAND_MOTION_MODE)
+				&& (gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE)))
+		{
+			FAIL(STATUS_NEGATIVE_VALUE);
+		} // [Word value cannot be negative]
+	}
+#endif
+
 	// Check for valid line number N value.
 	if (bit_istrue(value_words, bit(WORD_N)))
 	{
@@ -814,7 +855,24 @@ uint8_t gc_execute_line(char *line)
 		}
 	}
 
-	// [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
+	// [16. Set path control mode ]: G61.1 NOT SUPPORTED. G64 only with ENABLE_PATH_BLENDING.
+	// [G64 Errors]: P is negative (done.) NOTE: P is optional. Without it, no corner is blended.
+#ifdef ENABLE_PATH_BLENDING
+	float path_tolerance = 0.0;
+	if (bit_istrue(command_words, bit(MODAL_GROUP_G13))
+			&& (gc_block.modal.control == CONTROL_MODE_CONTINUOUS))
+	{
+		if (bit_istrue(value_words, bit(WORD_P)))
+		{
+			path_tolerance = gc_block.values.p;
+			if (gc_block.modal.units == UNITS_MODE_INCHES)
+			{
+				path_tolerance *= MM_PER_INCH;
+			}
+			bit_false(value_words, bit(WORD_P));
+		}
+	}
+#endif
 	// [17. Set distance mode ]: N/A. Only G91.1. G90.1 NOT SUPPORTED.
 	// [18. Set retract mode ]: NOT SUPPORTED.
 
@@ -1250,6 +1308,65 @@ uint8_t gc_execute_line(char *line)
 					}
 				}
 				break;
+#ifdef ENABLE_SPLINE_MOTION
+			case MOTION_MODE_CUBIC_SPLINE:
+			case MOTION_MODE_QUADRATIC_SPLINE:
+				// [G5/G5.1 Errors]: Plane is not G17. No axis words. G5 P or Q missing. G5.1 offsets missing. G5
+				//   offsets missing, unless the last motion was a G5 to continue tangent to.
+				// NOTE: Converted to the two control points of a cubic curve. I,J is the first one offset from the
+				//   current point, P,Q the second one offset from the target.
+				if (gc_block.modal.plane_select != PLANE_SELECT_XY)
+				{
+					FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND);
+				} // [Spline outside G17]
+				if (!axis_words)
+				{
+					FAIL(STATUS_GCODE_NO_AXIS_WORDS);
+				} // [No axis words]
+
+				// Convert IJPQ values to proper units.
+				if (gc_block.modal.units == UNITS_MODE_INCHES)
+				{
+					gc_block.values.ijk[X_AXIS] *= MM_PER_INCH;
+					gc_block.values.ijk[Y_AXIS] *= MM_PER_INCH;
+					gc_block.values.p *= MM_PER_INCH;
+					gc_block.values.q *= MM_PER_INCH;
+				}
+
+				if (gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE)
+				{
+					if ((value_words & (bit(WORD_P)|bit(WORD_Q))) != (bit(WORD_P)|bit(WORD_Q)))
+					{
+						FAIL(STATUS_GCODE_VALUE_WORD_MISSING);
+					} // [P or Q word missing]
+					if (!(ijk_words & (bit(X_AXIS)|bit(Y_AXIS))))
+					{
+						if (gc_state.modal.motion != MOTION_MODE_CUBIC_SPLINE)
+						{
+							FAIL(STATUS_GCODE_NO_OFFSETS_IN_PLANE);
+						} // [No offsets and no G5 to continue]
+						gc_block.values.ijk[X_AXIS] = -gc_state.spline_offset[0];
+						gc_block.values.ijk[Y_AXIS] = -gc_state.spline_offset[1];
+					}
+					bit_false(value_words, (bit(WORD_P)|bit(WORD_Q)));
+				}
+				else
+				{
+					if (!(ijk_words & (bit(X_AXIS)|bit(Y_AXIS))))
+					{
+						FAIL(STATUS_GCODE_NO_OFFSETS_IN_PLANE);
+					} // [No offsets in plane]
+					// The same curve as a cubic has its control points 2/3 of the way to the quadratic one.
+					gc_block.values.p = (2.0/3.0) * (gc_block.values.ijk[X_AXIS]
+							- (gc_block.values.xyz[X_AXIS] - gc_state.position[X_AXIS]));
+					gc_block.values.q = (2.0/3.0) * (gc_block.values.ijk[Y_AXIS]
+							- (gc_block.values.xyz[Y_AXIS] - gc_state.position[Y_AXIS]));
+					gc_block.values.ijk[X_AXIS] *= (2.0/3.0);
+					gc_block.values.ijk[Y_AXIS] *= (2.0/3.0);
+				}
+				bit_false(value_words, (bit(WORD_I)|bit(WORD_J)));
+				break;
+#endif
 			case MOTION_MODE_PROBE_TOWARD_NO_ERROR:
 			case MOTION_MODE_PROBE_AWAY_NO_ERROR:
 				gc_parser_flags |= GC_PARSER_PROBE_IS_NO_ERROR; // No break intentional.
@@ -1382,6 +1499,10 @@ uint8_t gc_execute_line(char *line)
 	{
 		if (!((gc_block.modal.motion == MOTION_MODE_LINEAR)
 				|| (gc_block.modal.motion == MOTION_MODE_CW_ARC)
+#ifdef ENABLE_SPLINE_MOTION
+				|| (gc_block.modal.motion == MOTION_MODE_CUBIC_SPLINE)
+				|| (gc_block.modal.motion == MOTION_MODE_QUADRATIC_SPLINE)
+#endif
 				|| (gc_block.modal.motion == MOTION_MODE_CCW_ARC)))
 		{
 			gc_parser_flags |= GC_PARSER_LASER_DISABLE;
@@ -1402,6 +1523,10 @@ uint8_t gc_execute_line(char *line)
 			{
 				if ((gc_state.modal.motion == MOTION_MODE_LINEAR)
 						|| (gc_state.modal.motion == MOTION_MODE_CW_ARC)
+#ifdef ENABLE_SPLINE_MOTION
+						|| (gc_state.modal.motion == MOTION_MODE_CUBIC_SPLINE)
+						|| (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE)
+#endif
 						|| (gc_state.modal.motion == MOTION_MODE_CCW_ARC))
 				{
 					if (bit_istrue(gc_parser_flags, GC_PARSER_LASER_DISABLE))
@@ -1556,8 +1681,15 @@ uint8_t gc_execute_line(char *line)
 		system_flag_wco_change();
 	}
 
-	// [16. Set path control mode ]: G61.1/G64 NOT SUPPORTED
-	// gc_state.modal.control = gc_block.modal.control; // NOTE: Always default.
+	// [16. Set path control mode ]: G61.1 NOT SUPPORTED
+	gc_state.modal.control = gc_block.modal.control;
+#ifdef ENABLE_PATH_BLENDING
+	if (bit_istrue(command_words, bit(MODAL_GROUP_G13))
+			&& (gc_state.modal.control == CONTROL_MODE_CONTINUOUS))
+	{
+		gc_state.path_tolerance = path_tolerance;
+	}
+#endif
 
 	// [17. Set distance mode ]:
 	gc_state.modal.distance = gc_block.modal.distance;
@@ -1617,6 +1749,12 @@ uint8_t gc_execute_line(char *line)
 			uint8_t gc_update_pos = GC_UPDATE_POS_TARGET;
 			if (gc_state.modal.motion == MOTION_MODE_LINEAR)
 			{
+#ifdef ENABLE_PATH_BLENDING
+				if (gc_state.modal.control == CONTROL_MODE_CONTINUOUS)
+				{
+					pl_data->path_tolerance = gc_state.path_tolerance;
+				}
+#endif
 				mc_line(gc_block.values.xyz, pl_data);
 			}
 			else if (gc_state.modal.motion == MOTION_MODE_SEEK)
@@ -1631,6 +1769,16 @@ uint8_t gc_execute_line(char *line)
 						gc_block.values.ijk, gc_block.values.r, axis_0, axis_1, axis_linear,
 						bit_istrue(gc_parser_flags, GC_PARSER_ARC_IS_CLOCKWISE));
 			}
+#ifdef ENABLE_SPLINE_MOTION
+			else if ((gc_state.modal.motion == MOTION_MODE_CUBIC_SPLINE)
+					|| (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE))
+			{
+				gc_state.spline_offset[0] = gc_block.values.p;
+				gc_state.spline_offset[1] = gc_block.values.q;
+				mc_spline(gc_block.values.xyz, pl_data, gc_state.position,
+						gc_block.values.ijk, gc_state.spline_offset, axis_0, axis_1);
+			}
+#endif
 			else
 			{
 				// NOTE: gc_block.values.xyz is returned from mc_probe_cycle with the updated position value. So
@@ -1778,5 +1926,5 @@ uint8_t gc_execute_line(char *line)
  group 8 = {M7*} enable mist coolant (* Compile-option)
  group 9 = {M48, M49, M56*} enable/disable override switches (* Compile-option)
  group 10 = {G98, G99} return mode canned cycles
- group 13 = {G61.1, G64} path control mode (G61 is supported)
+ group 13 = {G61.1, G64*} path control mode (G61 is supported)
  */
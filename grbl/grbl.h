@@ -105,6 +105,10 @@
   #endif
 #endif
 
+#if defined(PLANNER_ARC_BLOCKS) && defined(COREXY)
+  #error "PLANNER_ARC_BLOCKS is not supported with COREXY at this time."
+#endif
+
 #if defined(SPINDLE_PWM_MIN_VALUE)
   #if !(SPINDLE_PWM_MIN_VALUE > 0)
     #error "SPINDLE_PWM_MIN_VALUE must be greater than zero."
@@ -23,6 +23,33 @@
 #include "grbl.h"
 
 
+#ifdef MC_LINE_HOLD
+  // The last feed line, held back until the next one shows whether it continues it or how to blend
+  // the corner between them.
+  typedef struct {
+    uint8_t pending;            // True, if a line is held back.
+    float position[N_AXIS];     // End of the last line passed to the planner.
+    float start[N_AXIS];        // Where the held line starts, position or a blend arc end.
+    float target[N_AXIS];       // Its programmed end, the corner.
+    float millimeters;          // Its programmed length, before a blend trimmed its start.
+    plan_line_data_t pl_data;
+    #ifdef ENABLE_LINE_COALESCING
+      uint8_t vertex_count;     // Ends of the lines merged into it, before the target.
+      float vertex[LINE_COALESCE_MAX-1][N_AXIS];
+    #endif
+  } mc_hold_t;
+  static mc_hold_t hold;
+
+  static void mc_hold_line(float *target, plan_line_data_t *pl_data);
+#endif
+
+static void mc_plan_line(float *target, plan_line_data_t *pl_data);
+#ifdef PLANNER_ARC_BLOCKS
+  static void mc_plan_arc(float *target, plan_line_data_t *pl_data, float *position, float *offset, float radius,
+    float angular_travel, uint8_t axis_0, uint8_t axis_1);
+#endif
+
+
 // Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
 // unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
 // (1 minute)/feed_rate time.
@@ -42,6 +69,28 @@ void mc_line(float *target, plan_line_data_t *pl_data)
   // If in check gcode mode, prevent motion by blocking planner. Soft limits still work.
   if (sys.state == STATE_CHECK_MODE) { return; }
 
+  #ifdef MC_LINE_HOLD
+    // Only feed motions are merged or blended, and only with a tolerance to do it within.
+    // Anything else first releases the line held back, so motions reach the planner in order.
+    if (!(pl_data->condition & (PL_COND_MOTION_MASK | PL_COND_FLAG_INVERSE_TIME))) {
+      #ifdef ENABLE_PATH_BLENDING
+        if (pl_data->path_tolerance > 0.0) { mc_hold_line(target, pl_data); return; }
+      #endif
+      #ifdef ENABLE_LINE_COALESCING
+        if (settings.coalesce_tolerance > 0.0) { mc_hold_line(target, pl_data); return; }
+      #endif
+    }
+    mc_hold_flush();
+    if (sys.abort) { return; }
+  #endif
+
+  mc_plan_line(target, pl_data);
+}
+
+
+// Queues a line motion into the planner buffer, once there is room for it.
+static void mc_plan_line(float *target, plan_line_data_t *pl_data)
+{
   // NOTE: Backlash compensation may be installed here. It will need direction info to track when
   // to insert a backlash line motion(s) before the intended line motion and will require its own
   // plan_check_full_buffer() and check for system abort loop. Also for position reporting
@@ -66,6 +115,9 @@ void mc_line(float *target, plan_line_data_t *pl_data)
   } while (1);
 
   // Plan and queue motion into planner buffer
+  #ifdef MC_LINE_HOLD
+    memcpy(hold.position, target, sizeof(hold.position));
+  #endif
   if (plan_buffer_line(target, pl_data) == PLAN_EMPTY_BLOCK) {
     if (bit_istrue(settings.flags,BITFLAG_LASER_MODE)) {
       // Correctly set spindle state, if there is a coincident position passed. Forces a buffer
@@ -78,6 +130,224 @@ void mc_line(float *target, plan_line_data_t *pl_data)
 }
 
 
+#ifdef MC_LINE_HOLD
+#ifdef ENABLE_LINE_COALESCING
+// Returns true, if the held line followed by the new one is straight within the coalesce
+// tolerance. Every line merged into the held one, and the held one itself, must end within it
+// of the chord from the held start to the new target, and no further back along it than the one
+// before did, so no part of the path is dropped.
+static uint8_t mc_hold_merge(float *target, plan_line_data_t *pl_data)
+{
+  if (hold.vertex_count >= LINE_COALESCE_MAX-1) { return(false); }
+  if ((pl_data->feed_rate != hold.pl_data.feed_rate) || (pl_data->spindle_speed != hold.pl_data.spindle_speed) ||
+      (pl_data->condition != hold.pl_data.condition)) { return(false); }
+  #ifdef CENTRIPETAL_SPEED_LIMIT
+    if (pl_data->curve_radius != hold.pl_data.curve_radius) { return(false); }
+  #endif
+
+  float unit_vec[N_AXIS];
+  float millimeters = 0.0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    unit_vec[idx] = target[idx]-hold.start[idx];
+    millimeters += unit_vec[idx]*unit_vec[idx];
+  }
+  if (millimeters == 0.0) { return(false); }
+  millimeters = sqrtf(millimeters);
+  for (idx=0; idx<N_AXIS; idx++) { unit_vec[idx] /= millimeters; }
+
+  float tolerance_sqr = settings.coalesce_tolerance*settings.coalesce_tolerance;
+  float along_mm = 0.0; // Distance along the chord of the last end checked.
+  float *vertex;
+  float delta, distance, distance_sqr;
+  uint8_t i;
+  for (i=0; i<=hold.vertex_count; i++) {
+    if (i < hold.vertex_count) { vertex = hold.vertex[i]; }
+    else { vertex = hold.target; }
+    distance = 0.0;
+    for (idx=0; idx<N_AXIS; idx++) { distance += (vertex[idx]-hold.start[idx])*unit_vec[idx]; }
+    if ((distance < along_mm) || (distance > millimeters)) { return(false); }
+    along_mm = distance;
+    distance_sqr = 0.0;
+    for (idx=0; idx<N_AXIS; idx++) {
+      delta = vertex[idx]-hold.start[idx]-distance*unit_vec[idx];
+      distance_sqr += delta*delta;
+    }
+    if (distance_sqr > tolerance_sqr) { return(false); }
+  }
+  return(true);
+}
+#endif
+
+
+// Holds back a feed line and plans the one held before it, unless the new line merges into it.
+// With a G64 path tolerance, the corner between them is replaced by an arc tangent to both lines,
+// which passes the corner within the tolerance, as long as the lines are long enough. Each line
+// gives up at most half its length to the arcs at its ends. Corners where the arc would be no
+// wider than the junction deviation circle the planner already slows down for, see
+// plan_buffer_line(), are left as they are.
+static void mc_hold_line(float *target, plan_line_data_t *pl_data)
+{
+  // The new line starts at the corner, or at the end of the last planned line.
+  float *start = hold.position;
+  if (hold.pending) { start = hold.target; }
+
+  float next_unit_vec[N_AXIS];
+  float next_millimeters = 0.0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    next_unit_vec[idx] = target[idx]-start[idx];
+    next_millimeters += next_unit_vec[idx]*next_unit_vec[idx];
+  }
+  if (next_millimeters == 0.0) {
+    // No motion. Plan it anyway, so the planner handles it as an empty block.
+    mc_hold_flush();
+    if (sys.abort) { return; }
+    mc_plan_line(target, pl_data);
+    return;
+  }
+  next_millimeters = sqrtf(next_millimeters);
+
+  #ifdef ENABLE_LINE_COALESCING
+    if (hold.pending && (settings.coalesce_tolerance > 0.0)) {
+      #ifdef ENABLE_PATH_BLENDING
+        if (pl_data->path_tolerance == hold.pl_data.path_tolerance)
+      #endif
+      if (mc_hold_merge(target, pl_data)) {
+        memcpy(hold.vertex[hold.vertex_count++], hold.target, sizeof(hold.target));
+        memcpy(hold.target, target, sizeof(hold.target));
+        hold.millimeters += next_millimeters;
+        #ifdef USE_LINE_NUMBERS
+          hold.pl_data.line_number = pl_data->line_number;
+        #endif
+        return;
+      }
+    }
+  #endif
+
+  float next_start[N_AXIS];
+  memcpy(next_start, start, sizeof(next_start));
+  #ifdef ENABLE_PATH_BLENDING
+  if (hold.pending && (pl_data->path_tolerance > 0.0)) {
+    float unit_vec[N_AXIS];
+    float millimeters = 0.0;
+    float cos_phi = 0.0; // Cosine of the direction change at the corner.
+    for (idx=0; idx<N_AXIS; idx++) {
+      next_unit_vec[idx] /= next_millimeters;
+      unit_vec[idx] = hold.target[idx]-hold.start[idx];
+      millimeters += unit_vec[idx]*unit_vec[idx];
+    }
+    millimeters = sqrtf(millimeters);
+    for (idx=0; idx<N_AXIS; idx++) {
+      unit_vec[idx] /= millimeters;
+      cos_phi += unit_vec[idx]*next_unit_vec[idx];
+    }
+
+    if ((cos_phi < 0.999999) && (cos_phi > -0.999999)) {
+      // Half angle identities. The arc touches both lines at trim_mm from the corner and passes
+      // it at the path tolerance, unless trim_mm is capped.
+      float cos_phi_d2 = sqrtf(0.5*(1.0+cos_phi));
+      float sin_phi_d2 = sqrtf(0.5*(1.0-cos_phi));
+      float trim_mm = pl_data->path_tolerance*sin_phi_d2/(1.0-cos_phi_d2);
+      float max_trim_mm = 0.5*min(hold.millimeters, next_millimeters);
+      if (trim_mm > max_trim_mm) { trim_mm = max_trim_mm; }
+      float radius = trim_mm*cos_phi_d2/sin_phi_d2;
+
+      if (radius > settings.junction_deviation*cos_phi_d2/(1.0-cos_phi_d2)) {
+        // Plan the held line up to where the arc starts.
+        float arc_start[N_AXIS];
+        for (idx=0; idx<N_AXIS; idx++) { arc_start[idx] = hold.target[idx]-trim_mm*unit_vec[idx]; }
+        mc_plan_line(arc_start, &hold.pl_data);
+        hold.pending = false;
+        if (sys.abort) { return; }
+
+        // Segment the arc to settings.arc_tolerance like mc_arc(). It turns from the direction of
+        // the held line toward the unit normal to it in the plane of the corner.
+        float angular_travel = 2.0*atan2f(sin_phi_d2, cos_phi_d2);
+        uint16_t segments = 0;
+        if (2.0*radius > settings.arc_tolerance) {
+          segments = floor(0.5*angular_travel*radius/
+                           sqrtf(settings.arc_tolerance*(2.0*radius - settings.arc_tolerance)) );
+        }
+        float normal_vec[N_AXIS];
+        float sin_phi = 2.0*sin_phi_d2*cos_phi_d2;
+        for (idx=0; idx<N_AXIS; idx++) { normal_vec[idx] = (next_unit_vec[idx]-cos_phi*unit_vec[idx])/sin_phi; }
+        plan_line_data_t *arc_data = pl_data;
+        #ifdef CENTRIPETAL_SPEED_LIMIT
+          // Limited like mc_arc() chords, in the plane of the corner.
+          plan_line_data_t curve_data;
+          memcpy(&curve_data, pl_data, sizeof(plan_line_data_t));
+          curve_data.curve_radius = radius;
+          curve_data.curve_acceleration = plan_compute_curve_acceleration(unit_vec, normal_vec);
+          curve_data.curve_junction = false;
+          arc_data = &curve_data;
+        #endif
+        float position[N_AXIS];
+        float theta, sin_theta, versine_theta;
+        uint16_t i;
+        for (i = 1; i<segments; i++) {
+          theta = i*angular_travel/segments;
+          sin_theta = radius*sinf(theta);
+          versine_theta = radius*(1.0-cosf(theta));
+          for (idx=0; idx<N_AXIS; idx++) {
+            position[idx] = arc_start[idx] + sin_theta*unit_vec[idx] + versine_theta*normal_vec[idx];
+          }
+          mc_plan_line(position, arc_data);
+          if (sys.abort) { return; }
+          #ifdef CENTRIPETAL_SPEED_LIMIT
+            curve_data.curve_junction = true;
+          #endif
+        }
+
+        // The arc ends on the new line, which starts there now.
+        for (idx=0; idx<N_AXIS; idx++) { next_start[idx] = hold.target[idx]+trim_mm*next_unit_vec[idx]; }
+        mc_plan_line(next_start, arc_data);
+        if (sys.abort) { return; }
+      }
+    }
+  }
+  #endif
+
+  mc_hold_flush(); // Corner left as it is.
+  if (sys.abort) { return; }
+
+  memcpy(hold.start, next_start, sizeof(next_start));
+  memcpy(hold.target, target, sizeof(hold.target));
+  hold.millimeters = next_millimeters;
+  memcpy(&hold.pl_data, pl_data, sizeof(plan_line_data_t));
+  #ifdef ENABLE_LINE_COALESCING
+    hold.vertex_count = 0;
+  #endif
+  hold.pending = true;
+}
+
+
+// Plans the held back line to its programmed end. It counts as held until it is in the planner.
+void mc_hold_flush()
+{
+  if (hold.pending) {
+    mc_plan_line(hold.target, &hold.pl_data);
+    hold.pending = false;
+  }
+}
+
+
+// Drops the held back line. The next line starts at the synced parser position.
+void mc_hold_reset()
+{
+  hold.pending = false;
+  memcpy(hold.position, gc_state.position, sizeof(hold.position));
+}
+
+
+// The machine is not at rest while a line is held back.
+uint8_t mc_hold_pending()
+{
+  return(hold.pending);
+}
+#endif
+
+
 // Execute an arc in offset mode format. position == current xyz, target == target xyz,
 // offset == offset from current xyz, axis_X defines circle plane in tool space, axis_linear is
 // the direction of helical travel, radius == circle radius, isclockwise boolean. Used
@@ -110,6 +380,29 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
   uint16_t segments = floor(fabs(0.5*angular_travel*radius)/
                           sqrtf(settings.arc_tolerance*(2*radius - settings.arc_tolerance)) );
 
+  #ifdef PLANNER_ARC_BLOCKS
+    // Plan the arc as a single block. The stepper steps the segments as chords.
+    if (segments > 1) {
+      mc_plan_arc(target, pl_data, position, offset, radius, angular_travel, axis_0, axis_1);
+      return;
+    }
+  #endif
+
+  #ifdef CENTRIPETAL_SPEED_LIMIT
+    // Pass the curvature radius of the helix, r*(1 + (linear travel/arc length)^2), and the
+    // acceleration the plane axes allow, for the planner to limit the chords to the arc speed.
+    float plane_vec[2][N_AXIS];
+    memset(plane_vec, 0, sizeof(plane_vec));
+    plane_vec[0][axis_0] = plane_vec[1][axis_1] = 1.0f;
+    pl_data->curve_radius = 0.0f;
+    if (radius > 0.0f) {
+      float linear_travel = (target[axis_linear] - position[axis_linear])/angular_travel;
+      pl_data->curve_radius = radius + linear_travel*linear_travel/radius;
+    }
+    pl_data->curve_acceleration = plan_compute_curve_acceleration(plane_vec[0], plane_vec[1]);
+    pl_data->curve_junction = false; // The arc start is a corner.
+  #endif
+
   if (segments) {
     // Multiply inverse feed_rate to compensate for the fact that this movement is approximated
     // by a number of discrete segments. The inverse feed_rate should be correct for the sum of
@@ -182,6 +475,9 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
       position[axis_linear] += linear_per_segment;
 
       mc_line(position, pl_data);
+      #ifdef CENTRIPETAL_SPEED_LIMIT
+        pl_data->curve_junction = true;
+      #endif
 
       // Bail mid-circle on system abort. Runtime command check already performed by mc_line.
       if (sys.abort) { return; }
@@ -192,6 +488,178 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
 }
 
 
+#ifdef PLANNER_ARC_BLOCKS
+// Queues an arc motion into the planner buffer as a single block, once there is room for it. The
+// counterpart of mc_line() and mc_plan_line() for arcs.
+static void mc_plan_arc(float *target, plan_line_data_t *pl_data, float *position, float *offset, float radius,
+  float angular_travel, uint8_t axis_0, uint8_t axis_1)
+{
+  // Check soft limits at the arc end and at the points of the arc furthest along the plane axes,
+  // where it crosses the axis directions through its center. The other axes move linearly.
+  if (bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)) {
+    float point[N_AXIS];
+    float start_angle = atan2f(-offset[axis_1], -offset[axis_0]);
+    uint8_t quadrant, idx;
+    for (quadrant=0; quadrant<4; quadrant++) {
+      // Angle from the start to the crossing, in the direction of travel.
+      float angle = fmodf(quadrant*(0.5f*M_PI) - start_angle, 2*M_PI);
+      if ((angular_travel > 0.0f) && (angle < 0.0f)) { angle += 2*M_PI; }
+      if ((angular_travel < 0.0f) && (angle > 0.0f)) { angle -= 2*M_PI; }
+      if (fabsf(angle) >= fabsf(angular_travel)) { continue; }
+      for (idx=0; idx<N_AXIS; idx++) { point[idx] = position[idx] + (target[idx]-position[idx])*(angle/angular_travel); }
+      point[axis_0] = position[axis_0] + offset[axis_0] + ((quadrant == 0) ? radius : ((quadrant == 2) ? -radius : 0.0f));
+      point[axis_1] = position[axis_1] + offset[axis_1] + ((quadrant == 1) ? radius : ((quadrant == 3) ? -radius : 0.0f));
+      limits_soft_check(point);
+    }
+    limits_soft_check(target);
+  }
+
+  // If in check gcode mode, prevent motion by blocking planner. Soft limits still work.
+  if (sys.state == STATE_CHECK_MODE) { return; }
+
+  #ifdef MC_LINE_HOLD
+    mc_hold_flush(); // Arcs are not blended or merged.
+    if (sys.abort) { return; }
+  #endif
+
+  // Remain in this loop until there is room in both the block and the arc buffer.
+  do {
+    protocol_execute_realtime(); // Check for any run-time commands
+    if (sys.abort) { return; } // Bail, if system abort.
+    if ( plan_check_full_buffer() || plan_check_full_arc_buffer() ) { protocol_auto_cycle_start(); } // Auto-cycle start when buffer is full.
+    else { break; }
+  } while (1);
+
+  #ifdef MC_LINE_HOLD
+    memcpy(hold.position, target, sizeof(hold.position));
+  #endif
+  plan_buffer_arc(target, pl_data, offset, radius, angular_travel, axis_0, axis_1);
+}
+#endif
+
+#ifdef ENABLE_SPLINE_MOTION
+// Parameter step of the next spline chord from t, as long as the curvature at t allows to stay
+// within the arc tolerance, but no shorter than min_length. The plane axes follow the polynomial
+// coeff[0]*t + coeff[1]*t^2 + coeff[2]*t^3 from the start, the other axes add linear_sqr to the
+// squared speed along t. Raises curvature to the curvature at t, if higher.
+static float mc_spline_step(float coeff[3][2], float linear_sqr, float t, float min_length, float *curvature)
+{
+  float v0 = coeff[0][0] + t*(2.0f*coeff[1][0] + 3.0f*t*coeff[2][0]); // First derivative
+  float v1 = coeff[0][1] + t*(2.0f*coeff[1][1] + 3.0f*t*coeff[2][1]);
+  float a0 = 2.0f*coeff[1][0] + 6.0f*t*coeff[2][0]; // Second derivative
+  float a1 = 2.0f*coeff[1][1] + 6.0f*t*coeff[2][1];
+  float v_sqr = v0*v0 + v1*v1 + linear_sqr;
+  if (v_sqr == 0.0f) { return(1.0f); } // Cusp at a control point. Left to the other samples.
+
+  // Curvature |v x a|/|v|^3. A chord of length L deviates L^2/(8r) from a circle of radius r.
+  float cross_sqr = v_sqr*(a0*a0 + a1*a1) - (v0*a0 + v1*a1)*(v0*a0 + v1*a1);
+  float length = min_length;
+  if (cross_sqr > 0.0f) {
+    float kappa = sqrtf(cross_sqr)/(v_sqr*sqrtf(v_sqr));
+    if (kappa > *curvature) { *curvature = kappa; }
+    float tol_length = sqrtf(8.0f*settings.arc_tolerance/kappa);
+    if (tol_length > length) { length = tol_length; }
+  } else {
+    return(1.0f); // Straight
+  }
+  return(length/sqrtf(v_sqr));
+}
+
+
+// Execute a cubic Bezier spline as chords, cut as they are queued. Each is sized by the curvature
+// sampled at its start, middle and end, so a single chord does not step over a bend.
+void mc_spline(float *target, plan_line_data_t *pl_data, float *position, float *offset,
+  float *end_offset, uint8_t axis_0, uint8_t axis_1)
+{
+  // Polynomial coefficients of the plane axes, B(t) = position + c0*t + c1*t^2 + c2*t^3.
+  float coeff[3][2];
+  uint8_t plane_axis[2] = { axis_0, axis_1 };
+  uint8_t i, idx;
+  for (i=0; i<2; i++) {
+    idx = plane_axis[i];
+    float p1 = offset[idx];
+    float p2 = target[idx] + end_offset[i] - position[idx];
+    float p3 = target[idx] - position[idx];
+    coeff[0][i] = 3.0f*p1;
+    coeff[1][i] = 3.0f*(p2 - 2.0f*p1);
+    coeff[2][i] = p3 + 3.0f*(p1 - p2);
+  }
+  float linear_sqr = 0.0f;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if ((idx != axis_0) && (idx != axis_1)) {
+      linear_sqr += (target[idx] - position[idx])*(target[idx] - position[idx]);
+    }
+  }
+
+  float point[N_AXIS];
+  float t;
+  if (pl_data->condition & PL_COND_FLAG_INVERSE_TIME) {
+    // Inverse time is over the whole curve. Convert to the feed along its length, summed over
+    // SPLINE_LENGTH_CHORDS chords.
+    float length = 0.0f;
+    float last[2] = { 0.0f, 0.0f };
+    for (i=1; i<=SPLINE_LENGTH_CHORDS; i++) {
+      t = (float)i/SPLINE_LENGTH_CHORDS;
+      float d0 = t*(coeff[0][0] + t*(coeff[1][0] + t*coeff[2][0]));
+      float d1 = t*(coeff[0][1] + t*(coeff[1][1] + t*coeff[2][1]));
+      length += sqrtf((d0-last[0])*(d0-last[0]) + (d1-last[1])*(d1-last[1])
+                      + linear_sqr/(SPLINE_LENGTH_CHORDS*SPLINE_LENGTH_CHORDS));
+      last[0] = d0;
+      last[1] = d1;
+    }
+    pl_data->feed_rate *= length;
+    bit_false(pl_data->condition,PL_COND_FLAG_INVERSE_TIME); // Force as feed absolute mode over spline chords.
+  }
+  float min_length = pl_data->feed_rate*(SPLINE_SEGMENT_TIME/60000.0f);
+
+  #ifdef CENTRIPETAL_SPEED_LIMIT
+    // Each chord passes the lowest curvature radius sampled along it, as mc_arc() does.
+    float plane_vec[2][N_AXIS];
+    memset(plane_vec, 0, sizeof(plane_vec));
+    plane_vec[0][axis_0] = plane_vec[1][axis_1] = 1.0f;
+    pl_data->curve_acceleration = plan_compute_curve_acceleration(plane_vec[0], plane_vec[1]);
+    pl_data->curve_junction = false; // The spline start is a corner.
+  #endif
+
+  t = 0.0f;
+  while (1) {
+    float curvature = 0.0f;
+    float dt = 1.0f - t;
+    float step = mc_spline_step(coeff, linear_sqr, t, min_length, &curvature);
+    if (step < dt) { dt = step; }
+    step = mc_spline_step(coeff, linear_sqr, t + 0.5f*dt, min_length, &curvature);
+    if (step < dt) { dt = step; }
+    step = mc_spline_step(coeff, linear_sqr, t + dt, min_length, &curvature);
+    if (step < dt) { dt = step; }
+    if (dt < SPLINE_STEP_MIN) { dt = SPLINE_STEP_MIN; } // Keeps t moving in single precision.
+
+    #ifdef CENTRIPETAL_SPEED_LIMIT
+      pl_data->curve_radius = (curvature > 0.0f) ? 1.0f/curvature : 0.0f;
+    #endif
+
+    if (dt >= 1.0f - t) { break; }
+    if (2.0f*dt > 1.0f - t) { dt = 0.5f*(1.0f - t); } // Split the rest evenly rather than leave a sliver.
+    t += dt;
+
+    for (idx=0; idx<N_AXIS; idx++) { point[idx] = position[idx] + (target[idx] - position[idx])*t; }
+    for (i=0; i<2; i++) {
+      point[plane_axis[i]] = position[plane_axis[i]] + t*(coeff[0][i] + t*(coeff[1][i] + t*coeff[2][i]));
+    }
+
+    mc_line(point, pl_data);
+    #ifdef CENTRIPETAL_SPEED_LIMIT
+      pl_data->curve_junction = true;
+    #endif
+
+    // Bail mid-spline on system abort. Runtime command check already performed by mc_line.
+    if (sys.abort) { return; }
+  }
+  // Ensure last chord arrives at target location.
+  mc_line(target, pl_data);
+}
+#endif
+
+
 // Execute dwell in seconds.
 void mc_dwell(float seconds)
 {
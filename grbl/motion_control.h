@@ -51,6 +51,33 @@
 // (1 minute)/feed_rate time.
 void mc_line(float *target, plan_line_data_t *pl_data);
 
+// mc_line() holds back the last feed line for G64 blending and line coalescing.
+#if defined(ENABLE_PATH_BLENDING) || defined(ENABLE_LINE_COALESCING)
+  #define MC_LINE_HOLD
+#endif
+
+#ifdef ENABLE_LINE_COALESCING
+  // Most lines merged into one planner block.
+  #ifndef LINE_COALESCE_MAX
+    #define LINE_COALESCE_MAX 16
+  #endif
+  #if (LINE_COALESCE_MAX < 2)
+    #error "LINE_COALESCE_MAX must be at least 2"
+  #endif
+#endif
+
+#ifdef MC_LINE_HOLD
+  // Plans the last feed line, held back by mc_line() to merge it with or blend its corner into
+  // the next one. Called before anything else needs the planner to hold all motion so far.
+  void mc_hold_flush();
+
+  // Drops the held back line. Called when the g-code parser position is resynced.
+  void mc_hold_reset();
+
+  // True, if a line is held back and not yet planned.
+  uint8_t mc_hold_pending();
+#endif
+
 // Execute an arc in offset mode format. position == current xyz, target == target xyz,
 // offset == offset from current xyz, axis_XXX defines circle plane in tool space, axis_linear is
 // the direction of helical travel, radius == circle radius, is_clockwise_arc boolean. Used
@@ -58,6 +85,21 @@ void mc_line(float *target, plan_line_data_t *pl_data);
 void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *offset, float radius,
   uint8_t axis_0, uint8_t axis_1, uint8_t axis_linear, uint8_t is_clockwise_arc);
 
+#ifdef ENABLE_SPLINE_MOTION
+  // Shortest spline chord, in ms of motion at the programmed feed.
+  #ifndef SPLINE_SEGMENT_TIME
+    #define SPLINE_SEGMENT_TIME 2
+  #endif
+  #define SPLINE_LENGTH_CHORDS 32 // Chords summed for the curve length of a G93 spline.
+  #define SPLINE_STEP_MIN 1E-4f // Smallest step of the curve parameter, at most 10000 chords.
+
+  // Execute a cubic Bezier spline from position to target in the plane of axis_0 and axis_1.
+  // offset == first control point offset from current xyz, end_offset == second control point
+  // offset from target, in plane axis order. The other axes move linearly along the curve.
+  void mc_spline(float *target, plan_line_data_t *pl_data, float *position, float *offset,
+    float *end_offset, uint8_t axis_0, uint8_t axis_1);
+#endif
+
 // Dwell for a specific number of seconds
 void mc_dwell(float seconds);
 
@@ -25,10 +25,16 @@
 
 
 static plan_block_t block_buffer[BLOCK_BUFFER_SIZE];  // A ring buffer for motion instructions
-static uint8_t block_buffer_tail;     // Index of the block to process now
-static uint8_t block_buffer_head;     // Index of the next block to be pushed
-static uint8_t next_buffer_head;      // Index of the next buffer head
-static uint8_t block_buffer_planned;  // Index of the optimally planned block
+static uint16_t block_buffer_tail;     // Index of the block to process now
+static uint16_t block_buffer_head;     // Index of the next block to be pushed
+static uint16_t next_buffer_head;      // Index of the next buffer head
+static uint16_t block_buffer_planned;  // Index of the optimally planned block
+
+#ifdef PLANNER_ARC_BLOCKS
+  static plan_arc_t arc_buffer[PLANNER_ARC_BUFFER_SIZE]; // Geometry of the arc blocks, in block order
+  static uint16_t arc_buffer_tail;     // Arc of the first arc block in the block buffer
+  static uint16_t arc_buffer_head;     // Index of the next arc to be pushed
+#endif
 
 // Define planner variables
 typedef struct {
@@ -37,12 +43,25 @@ typedef struct {
                                      // i.e. arcs, canned cycles, and backlash compensation.
   float previous_unit_vec[N_AXIS];   // Unit vector of previous path line segment
   float previous_nominal_speed;  // Nominal speed of previous path line segment
+  #ifdef LAZY_OVERRIDE_REPLAN
+    uint16_t reconcile_index;      // First block not yet replanned for the current overrides
+    uint16_t reconcile_head;       // Buffer head at the last override change. Later blocks are planned for it.
+    float reconcile_nominal_speed; // Nominal speed of the block before reconcile_index, with the current overrides
+  #endif
 } planner_t;
 static planner_t pl;
 
+#ifdef PLANNER_STATS
+  plan_stats_t plan_stats;
+#endif
+
+#ifdef ADAPTIVE_LOOKAHEAD
+  static plan_lookahead_t lookahead; // Path and time buffered after block_buffer_tail.
+#endif
+
 
 // Returns the index of the next block in the ring buffer. Also called by stepper segment buffer.
-uint8_t plan_next_block_index(uint8_t block_index)
+uint16_t plan_next_block_index(uint16_t block_index)
 {
   block_index++;
   if (block_index == BLOCK_BUFFER_SIZE) { block_index = 0; }
@@ -50,8 +69,19 @@ uint8_t plan_next_block_index(uint8_t block_index)
 }
 
 
+#ifdef PLANNER_ARC_BLOCKS
+// Returns the index of the next arc in the arc ring buffer.
+static uint16_t plan_next_arc_index(uint16_t arc_index)
+{
+  arc_index++;
+  if (arc_index == PLANNER_ARC_BUFFER_SIZE) { arc_index = 0; }
+  return(arc_index);
+}
+#endif
+
+
 // Returns the index of the previous block in the ring buffer
-static uint8_t plan_prev_block_index(uint8_t block_index)
+static uint16_t plan_prev_block_index(uint16_t block_index)
 {
   if (block_index == 0) { block_index = BLOCK_BUFFER_SIZE; }
   block_index--;
@@ -59,6 +89,167 @@ static uint8_t plan_prev_block_index(uint8_t block_index)
 }
 
 
+#ifdef PLANNER_STATS
+// Accumulates the workload of one planner_recalculate() call.
+static void plan_stats_record(uint32_t start_time, uint32_t reverse_depth, uint32_t forward_depth, uint8_t reached_tail)
+{
+  uint32_t duration = plan_stats_timestamp() - start_time;
+  plan_stats.recalculate_count++;
+  plan_stats.recalculate_time += duration;
+  if (duration > plan_stats.recalculate_time_max) { plan_stats.recalculate_time_max = duration; }
+  plan_stats.reverse_depth_total += reverse_depth;
+  if (reverse_depth > plan_stats.reverse_depth_max) { plan_stats.reverse_depth_max = reverse_depth; }
+  if (reached_tail) { plan_stats.reverse_full_count++; }
+  plan_stats.forward_depth_total += forward_depth;
+}
+#endif
+
+
+#ifdef ADAPTIVE_LOOKAHEAD
+// Removes the new tail block from the lookahead, since the stepper now executes it and
+// consumes its distance. An empty buffer restarts the sums, which drops any rounding drift.
+static void plan_lookahead_discard()
+{
+  if (block_buffer_tail == block_buffer_head) {
+    lookahead.millimeters = 0.0f;
+    lookahead.time = 0.0f;
+  } else {
+    plan_block_t *block = &block_buffer[block_buffer_tail];
+    lookahead.millimeters -= block->millimeters;
+    lookahead.time -= block->millimeters*60000.0f/plan_compute_profile_nominal_speed(block);
+    if (lookahead.millimeters < 0.0f) { lookahead.millimeters = 0.0f; }
+    if (lookahead.time < 0.0f) { lookahead.time = 0.0f; }
+  }
+}
+#endif
+
+
+/* Ramp distances. A block changes speed at its acceleration a, constant over the ramp. With
+   S_CURVE_ACCELERATION and a block jerk J, the acceleration instead rises to a and falls back at J,
+   in t1 = a/J each, and a speed change dv lasts dv/a + t1. One below a*t1 never reaches a and lasts
+   2*sqrt(dv/J). Either way the ramp is symmetric in time and covers its duration times the mean of
+   its entry and exit speeds, more than the constant acceleration ramp by (v0+v1)*t1/2 at most.
+   With INPUT_SHAPING, the ramp is convolved with the block shaper and lasts its duration D longer.
+   With c the shaper centroid, it covers v0*c + v1*(D-c) more. Since the planner plans each ramp
+   both ways, it takes the higher of the two speeds over the longer of c and D-c.
+   The planner plans every junction and stop with these distances, so the segment generator can
+   shape each ramp within its acceleration.
+*/
+#if defined(S_CURVE_ACCELERATION) || defined(INPUT_SHAPING)
+// True if the ramps of the block are longer than at constant acceleration.
+uint8_t plan_ramp_extended(plan_block_t *block)
+{
+  #ifdef S_CURVE_ACCELERATION
+    if (block->jerk > 0.0f) { return(true); }
+  #endif
+  #ifdef INPUT_SHAPING
+    if (block->shaper_time_high > 0.0f) { return(true); }
+  #endif
+  return(false);
+}
+#endif
+
+// Distance to change speed from start_speed to end_speed (mm/min), either way.
+float plan_ramp_distance(plan_block_t *block, float start_speed, float end_speed)
+{
+  float delta = fabsf(end_speed-start_speed);
+  float time = delta/block->pbacceleration;
+  #ifdef S_CURVE_ACCELERATION
+    if (block->jerk > 0.0f) {
+      float jerk_time = block->pbacceleration/block->jerk;
+      if (delta >= block->pbacceleration*jerk_time) { time += jerk_time; }
+      else { time = 2.0f*sqrtf(delta/block->jerk); }
+    }
+  #endif
+  float distance = 0.5f*(start_speed+end_speed)*time;
+  #ifdef INPUT_SHAPING
+    if (delta > 0.0f) {
+      distance += max(start_speed, end_speed)*block->shaper_time_high+min(start_speed, end_speed)*block->shaper_time_low;
+    }
+  #endif
+  return(distance);
+}
+
+// Highest speed^2 reached over distance from speed_sqr, accelerating or, backwards, decelerating.
+float plan_ramp_speed_sqr(plan_block_t *block, float speed_sqr, float distance)
+{
+  #ifdef INPUT_SHAPING
+    if (block->shaper_time_high > 0.0f) {
+      float speed = sqrtf(speed_sqr);
+      // Any speed change lasts the shaper duration, covering at least speed*D.
+      distance -= speed*(block->shaper_time_high+block->shaper_time_low);
+      if (distance <= 0.0f) { return(speed_sqr); }
+      float shaper_high = block->pbacceleration*block->shaper_time_high; // a*s_h
+      float jerk_speed = 0.0f;
+      #ifdef S_CURVE_ACCELERATION
+        if (block->jerk > 0.0f) { jerk_speed = 0.5f*block->pbacceleration*block->pbacceleration/block->jerk; }
+      #endif
+      // (v^2-v0^2)/(2a) + (v+v0)*t1/2 + (v-v0)*s_h = distance, less v0*D as above, solved for v.
+      float top_speed = jerk_speed+shaper_high;
+      top_speed = sqrtf(top_speed*top_speed+speed*(speed-2.0f*(jerk_speed-shaper_high))+
+                        2.0f*block->pbacceleration*distance)-top_speed;
+      #ifdef S_CURVE_ACCELERATION
+        if ((block->jerk > 0.0f) && (top_speed-speed < 2.0f*jerk_speed)) {
+          // Short of the acceleration: u^3 + sqrt(J)*s_h*u^2 + 2*v0*u = distance*sqrt(J), as below.
+          float root_jerk = sqrtf(block->jerk);
+          float b = root_jerk*block->shaper_time_high;
+          float c = distance*root_jerk;
+          float u = cbrtf(c);
+          if ((speed > 0.0f) && (0.5f*c/speed < u)) { u = 0.5f*c/speed; }
+          uint8_t i;
+          for (i=0; i<4; i++) { u -= (u*u*(u+b)+2.0f*speed*u-c)/(u*(3.0f*u+2.0f*b)+2.0f*speed); }
+          top_speed = speed+u*u;
+        }
+      #endif
+      return(top_speed*top_speed);
+    }
+  #endif
+  #ifdef S_CURVE_ACCELERATION
+    if ((block->jerk > 0.0f) && (distance > 0.0f)) {
+      float speed = sqrtf(speed_sqr);
+      float jerk_speed = 0.5f*block->pbacceleration*block->pbacceleration/block->jerk; // a*t1/2
+      // Reaching the acceleration: (v^2-v0^2)/(2a) + (v+v0)*t1/2 = distance, solved for v.
+      float top_speed = sqrtf((speed-jerk_speed)*(speed-jerk_speed)+2.0f*block->pbacceleration*distance)-jerk_speed;
+      if (top_speed-speed >= 2.0f*jerk_speed) { return(top_speed*top_speed); }
+      // Short of it: u^3 + 2*v0*u = distance*sqrt(J), with dv = u^2. Newton from an upper bound,
+      // which converges from above on the convex cubic.
+      float c = distance*sqrtf(block->jerk);
+      float u = cbrtf(c);
+      if ((speed > 0.0f) && (0.5f*c/speed < u)) { u = 0.5f*c/speed; }
+      uint8_t i;
+      for (i=0; i<4; i++) { u -= (u*u*u+2.0f*speed*u-c)/(3.0f*u*u+2.0f*speed); }
+      speed += u*u;
+      return(speed*speed);
+    }
+  #endif
+  return(speed_sqr+2*block->pbacceleration*distance);
+}
+
+#if defined(S_CURVE_ACCELERATION) || defined(INPUT_SHAPING)
+// Speed at the end of distance decelerating from speed, 0 if it stops within it. Called by the
+// segment generator for a deceleration that does not end within the block.
+float plan_ramp_exit_speed(plan_block_t *block, float speed, float distance)
+{
+  if (plan_ramp_extended(block)) {
+    if (plan_ramp_distance(block, speed, 0.0f) <= distance) { return(0.0f); }
+    // Bisected. The distance is not monotonic in the exit speed near a stop.
+    float low = 0.0f; // Ends beyond distance
+    float high = speed; // Ends within it
+    uint8_t i;
+    for (i=0; i<20; i++) {
+      float mid = 0.5f*(low+high);
+      if (plan_ramp_distance(block, speed, mid) > distance) { low = mid; }
+      else { high = mid; }
+    }
+    return(high);
+  }
+  float exit_speed_sqr = speed*speed-2*block->pbacceleration*distance;
+  if (exit_speed_sqr > 0.0f) { return(sqrtf(exit_speed_sqr)); }
+  return(0.0f);
+}
+#endif
+
+
 /*                            PLANNER SPEED DEFINITION
                                      +--------+   <- current->nominal_speed
                                     /          \
@@ -123,14 +314,34 @@ static uint8_t plan_prev_block_index(uint8_t block_index)
   to compute an optimal plan, so select carefully. The Arduino 328p memory is already maxed out, but future
   ARM versions should have enough memory and speed for look-ahead blocks numbering up to a hundred or more.
 
+  Every block after the planned pointer is still decelerating towards the stop at the end of the buffer,
+  so each new block raises all of them, and the passes walk as many blocks as the stopping distance from
+  the nominal speed spans, or the whole buffer when it is shorter. With a deep buffer, a new block only
+  replans LOOKAHEAD_RECALC_BLOCKS back from the head, which bounds planner_recalculate() in time, and the
+  forward pass starts where the reverse pass stopped. The blocks further back keep the lower entry speeds
+  they were planned with. That is still a valid plan, only one that looks LOOKAHEAD_RECALC_BLOCKS ahead
+  instead of the whole buffer. A full replan, after a feed hold or an override change, walks it all.
+
 */
-static void planner_recalculate()
+static void planner_recalculate(uint8_t full_replan)
 {
+  #ifdef PLANNER_STATS
+    uint32_t stats_start_time = plan_stats_timestamp();
+    uint32_t stats_reverse_depth = 1;
+    uint32_t stats_forward_depth = 0;
+    uint8_t stats_reached_tail = (block_buffer_planned == block_buffer_tail);
+  #endif
+
   // Initialize block index to the last block in the planner buffer.
-  uint8_t block_index = plan_prev_block_index(block_buffer_head);
+  uint16_t block_index = plan_prev_block_index(block_buffer_head);
 
   // Bail. Can't do anything with one only one plan-able block.
-  if (block_index == block_buffer_planned) { return; }
+  if (block_index == block_buffer_planned) {
+    #ifdef PLANNER_STATS
+      plan_stats_record(stats_start_time, 0, 0, false);
+    #endif
+    return;
+  }
 
   // Reverse Pass: Coarsely maximize all possible deceleration curves back-planning from the last
   // block in buffer. Cease planning when the last optimal planned or tail pointer is reached.
@@ -138,9 +349,11 @@ static void planner_recalculate()
   float entry_speed_sqr;
   plan_block_t *next;
   plan_block_t *current = &block_buffer[block_index];
+  uint16_t forward_index = block_buffer_planned; // Forward pass start
+  uint16_t reverse_depth = 2; // Blocks replanned, counting the last block and the next one
 
   // Calculate maximum entry speed for last block in buffer, where the exit speed is always zero.
-  current->entry_speed_sqr = min( current->max_entry_speed_sqr, 2*current->pbacceleration*current->millimeters);
+  current->entry_speed_sqr = min( current->max_entry_speed_sqr, plan_ramp_speed_sqr(current, 0.0f, current->millimeters));
 
   block_index = plan_prev_block_index(block_index);
   if (block_index == block_buffer_planned) { // Only two plannable blocks in buffer. Reverse pass complete.
@@ -148,16 +361,24 @@ static void planner_recalculate()
     if (block_index == block_buffer_tail) { st_update_plan_block_parameters(); }
   } else { // Three or more plan-able blocks
     while (block_index != block_buffer_planned) {
+      if (!full_replan && (reverse_depth == LOOKAHEAD_RECALC_BLOCKS)) {
+        forward_index = block_index;
+        break;
+      }
+      reverse_depth++;
       next = current;
       current = &block_buffer[block_index];
       block_index = plan_prev_block_index(block_index);
+      #ifdef PLANNER_STATS
+        stats_reverse_depth++;
+      #endif
 
       // Check if next block is the tail block(=planned block). If so, update current stepper parameters.
       if (block_index == block_buffer_tail) { st_update_plan_block_parameters(); }
 
       // Compute maximum entry speed decelerating over the current block from its exit speed.
       if (current->entry_speed_sqr != current->max_entry_speed_sqr) {
-        entry_speed_sqr = next->entry_speed_sqr + 2*current->pbacceleration*current->millimeters;
+        entry_speed_sqr = plan_ramp_speed_sqr(current, next->entry_speed_sqr, current->millimeters);
         if (entry_speed_sqr < current->max_entry_speed_sqr) {
           current->entry_speed_sqr = entry_speed_sqr;
         } else {
@@ -169,17 +390,20 @@ static void planner_recalculate()
 
   // Forward Pass: Forward plan the acceleration curve from the planned pointer onward.
   // Also scans for optimal plan breakpoints and appropriately updates the planned pointer.
-  next = &block_buffer[block_buffer_planned]; // Begin at buffer planned pointer
-  block_index = plan_next_block_index(block_buffer_planned);
+  next = &block_buffer[forward_index]; // Begin at buffer planned pointer, or where the reverse pass was cut off
+  block_index = plan_next_block_index(forward_index);
   while (block_index != block_buffer_head) {
     current = next;
     next = &block_buffer[block_index];
+    #ifdef PLANNER_STATS
+      stats_forward_depth++;
+    #endif
 
     // Any acceleration detected in the forward pass automatically moves the optimal planned
     // pointer forward, since everything before this is all optimal. In other words, nothing
     // can improve the plan from the buffer tail to the planned pointer by logic.
     if (current->entry_speed_sqr < next->entry_speed_sqr) {
-      entry_speed_sqr = current->entry_speed_sqr + 2*current->pbacceleration*current->millimeters;
+      entry_speed_sqr = plan_ramp_speed_sqr(current, current->entry_speed_sqr, current->millimeters);
       // If true, current block is full-acceleration and we can move the planned pointer forward.
       if (entry_speed_sqr < next->entry_speed_sqr) {
         next->entry_speed_sqr = entry_speed_sqr; // Always <= max_entry_speed_sqr. Backward pass sets this.
@@ -194,6 +418,10 @@ static void planner_recalculate()
     if (next->entry_speed_sqr == next->max_entry_speed_sqr) { block_buffer_planned = block_index; }
     block_index = plan_next_block_index( block_index );
   }
+
+  #ifdef PLANNER_STATS
+    plan_stats_record(stats_start_time, stats_reverse_depth, stats_forward_depth, stats_reached_tail);
+  #endif
 }
 
 
@@ -210,16 +438,41 @@ void plan_reset_buffer()
   block_buffer_head = 0; // Empty = tail
   next_buffer_head = 1; // plan_next_block_index(block_buffer_head)
   block_buffer_planned = 0; // = block_buffer_tail;
+  #ifdef PLANNER_ARC_BLOCKS
+    arc_buffer_tail = 0;
+    arc_buffer_head = 0;
+  #endif
+  #ifdef LAZY_OVERRIDE_REPLAN
+    pl.reconcile_index = 0; // Nothing to reconcile
+    pl.reconcile_head = 0;
+  #endif
+  #ifdef ADAPTIVE_LOOKAHEAD
+    lookahead.millimeters = 0.0f;
+    lookahead.time = 0.0f;
+    lookahead.stopping_mm = 0.0f;
+  #endif
 }
 
 
 void plan_discard_current_block()
 {
   if (block_buffer_head != block_buffer_tail) { // Discard non-empty buffer.
-    uint8_t block_index = plan_next_block_index( block_buffer_tail );
+    uint16_t block_index = plan_next_block_index( block_buffer_tail );
+    #ifdef PLANNER_ARC_BLOCKS
+      if (block_buffer[block_buffer_tail].arc) { arc_buffer_tail = plan_next_arc_index(arc_buffer_tail); }
+    #endif
     // Push block_buffer_planned pointer, if encountered.
     if (block_buffer_tail == block_buffer_planned) { block_buffer_planned = block_index; }
     block_buffer_tail = block_index;
+    #ifdef ADAPTIVE_LOOKAHEAD
+      plan_lookahead_discard();
+    #endif
+    #ifdef LAZY_OVERRIDE_REPLAN
+      // The segment generator plans the new tail block to the entry speed of the next one, so
+      // that one must already be reconciled with the current overrides.
+      if ((pl.reconcile_index != pl.reconcile_head) && ((pl.reconcile_index == block_buffer_tail) ||
+          (pl.reconcile_index == plan_next_block_index(block_buffer_tail)))) { plan_override_reconcile(); }
+    #endif
   }
 }
 
@@ -241,16 +494,39 @@ plan_block_t *plan_get_current_block()
 
 float plan_get_exec_block_exit_speed_sqr()
 {
-  uint8_t block_index = plan_next_block_index(block_buffer_tail);
+  uint16_t block_index = plan_next_block_index(block_buffer_tail);
   if (block_index == block_buffer_head) { return( 0.0 ); }
   return( block_buffer[block_index].entry_speed_sqr );
 }
 
 
+#ifdef PLANNER_ARC_BLOCKS
+// Returns address of the geometry of the first arc block. Called by the segment generator.
+plan_arc_t *plan_get_current_arc()
+{
+  return(&arc_buffer[arc_buffer_tail]);
+}
+
+
+// Returns the availability status of the arc ring buffer. True, if full.
+uint8_t plan_check_full_arc_buffer()
+{
+  return(plan_next_arc_index(arc_buffer_head) == arc_buffer_tail);
+}
+#endif
+
+
 // Returns the availability status of the block ring buffer. True, if full.
+// With ADAPTIVE_LOOKAHEAD, the buffer also counts as full once it holds LOOKAHEAD_BLOCKS and the
+// path after the executing block covers both the stopping distance of the newest block and
+// LOOKAHEAD_TIME. Until then, short blocks keep being chained from the rest of the pool.
 uint8_t plan_check_full_buffer()
 {
   if (block_buffer_tail == next_buffer_head) { return(true); }
+  #ifdef ADAPTIVE_LOOKAHEAD
+    if ((plan_get_block_buffer_count() >= LOOKAHEAD_BLOCKS) && (lookahead.millimeters >= lookahead.stopping_mm) &&
+        (lookahead.time >= LOOKAHEAD_TIME)) { return(true); }
+  #endif
   return(false);
 }
 
@@ -270,6 +546,23 @@ float plan_compute_profile_nominal_speed(plan_block_t *block)
 }
 
 
+#ifdef ST_PREP_FIXED_POINT
+// Fixed-point plan_compute_profile_nominal_speed() for the segment generator. The block rates are
+// passed in already converted by the caller, which applies the overrides without float math.
+uint32_t plan_compute_profile_nominal_speed_fixed(plan_block_t *block, uint32_t programmed_rate, uint32_t rapid_rate, uint32_t minimum_rate)
+{
+  uint64_t nominal_speed = programmed_rate;
+  if (block->condition & PL_COND_FLAG_RAPID_MOTION) { nominal_speed = (nominal_speed*sys.r_override)/100; }
+  else {
+    if (!(block->condition & PL_COND_FLAG_NO_FEED_OVERRIDE)) { nominal_speed = (nominal_speed*sys.f_override)/100; }
+    if (nominal_speed > rapid_rate) { nominal_speed = rapid_rate; }
+  }
+  if (nominal_speed > minimum_rate) { return(nominal_speed); }
+  return(minimum_rate);
+}
+#endif
+
+
 // Computes and updates the max entry speed (sqr) of the block, based on the minimum of the junction's
 // previous and current nominal speeds and max junction speed.
 static void plan_compute_profile_parameters(plan_block_t *block, float nominal_speed, float prev_nominal_speed)
@@ -284,14 +577,21 @@ static void plan_compute_profile_parameters(plan_block_t *block, float nominal_s
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters()
 {
-  uint8_t block_index = block_buffer_tail;
+  uint16_t block_index = block_buffer_tail;
   plan_block_t *block;
   float nominal_speed;
   float prev_nominal_speed = SOME_LARGE_VALUE; // Set high for first block nominal speed calculation.
+  #ifdef ADAPTIVE_LOOKAHEAD
+    lookahead.time = 0.0f; // Summed again at the new nominal speeds.
+  #endif
   while (block_index != block_buffer_head) {
     block = &block_buffer[block_index];
     nominal_speed = plan_compute_profile_nominal_speed(block);
     plan_compute_profile_parameters(block, nominal_speed, prev_nominal_speed);
+    #ifdef ADAPTIVE_LOOKAHEAD
+      if (block_index != block_buffer_tail) { lookahead.time += block->millimeters*60000.0f/nominal_speed; }
+      lookahead.stopping_mm = plan_ramp_distance(block, nominal_speed, 0.0f);
+    #endif
     prev_nominal_speed = nominal_speed;
     block_index = plan_next_block_index(block_index);
   }
@@ -299,106 +599,206 @@ void plan_update_velocity_profile_parameters()
 }
 
 
-/* Add a new linear movement to the buffer. target[N_AXIS] is the signed, absolute target position
-   in millimeters. Feed rate specifies the speed of the motion. If feed rate is inverted, the feed
-   rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
-   All position data passed to the planner must be in terms of machine position to keep the planner
-   independent of any coordinate system changes and offsets, which are handled by the g-code parser.
-   NOTE: Assumes buffer is available. Buffer checks are handled at a higher level by motion_control.
-   In other words, the buffer head is never equal to the buffer tail.  Also the feed rate input value
-   is used in three ways: as a normal feed rate if invert_feed_rate is false, as inverse time if
-   invert_feed_rate is true, or as seek/rapids rate if the feed_rate value is negative (and
-   invert_feed_rate always false).
-   The system motion condition tells the planner to plan a motion in the always unused block buffer
-   head. It avoids changing the planner state and preserves the buffer to ensure subsequent gcode
-   motions are still planned correctly, while the stepper module only points to the block buffer head
-   to execute the special system motion. */
-uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
+#ifdef LAZY_OVERRIDE_REPLAN
+/* Carries the current overrides into the next PLAN_RECONCILE_BLOCKS blocks from reconcile_index
+   and replans them together with the blocks reconciled before them.
+     The blocks from the tail up to reconcile_index always form a valid plan for the current
+   overrides. The blocks after it keep the plan of earlier overrides. Entry speeds are only
+   raised as far as the next entry speed allows, so every block in the buffer can still
+   decelerate to the entry speed of the next one and the newest one to a stop, whatever the
+   override does. Where a higher override leaves speed on the table further back, the next
+   planner_recalculate() raises it.
+     The reverse pass starts at the first block not yet reconciled and ends at the first earlier
+   block it leaves unchanged, since nothing before that changes either. The forward pass then
+   limits the accelerations from there up to the first block not yet reconciled. */
+void plan_override_reconcile()
 {
-  // Prepare and initialize new block. Copy relevant pl_data for block execution.
-  plan_block_t *block = &block_buffer[block_buffer_head];
-  memset(block,0,sizeof(plan_block_t)); // Zero all block values.
-  block->condition = pl_data->condition;
-  #ifdef VARIABLE_SPINDLE
-    block->spindle_speed = pl_data->spindle_speed;
-  #endif
-  #ifdef USE_LINE_NUMBERS
-    block->line_number = pl_data->line_number;
+  uint16_t block_index = pl.reconcile_index;
+  if (block_index == pl.reconcile_head) { return; }
+  #ifdef PLANNER_STATS
+    uint32_t stats_start_time = plan_stats_timestamp();
   #endif
 
-  // Compute and store initial move distance data.
-  int32_t target_steps[N_AXIS], position_steps[N_AXIS];
-  float unit_vec[N_AXIS], delta_mm;
-  uint8_t idx;
+  uint16_t front_index = plan_next_block_index(block_buffer_tail);
+  float front_entry_speed_sqr = block_buffer[front_index].entry_speed_sqr; // Exit speed the segment generator uses
 
-  // Copy position data based on type of motion being planned.
-  if (block->condition & PL_COND_FLAG_SYSTEM_MOTION) { 
-    #ifdef COREXY
-      position_steps[X_AXIS] = system_convert_corexy_to_x_axis_steps(sys_position);
-      position_steps[Y_AXIS] = system_convert_corexy_to_y_axis_steps(sys_position);
-      position_steps[Z_AXIS] = sys_position[Z_AXIS];
-    #else
-      memcpy(position_steps, sys_position, sizeof(sys_position)); 
-    #endif
-  } else { memcpy(position_steps, pl.position, sizeof(pl.position)); }
+  // Recompute the maximum entry speeds with the current overrides.
+  // The entry speed of the executing block is its current speed, set by st_update_plan_block_parameters().
+  plan_block_t *block;
+  float nominal_speed;
+  uint16_t count = 0;
+  do {
+    block = &block_buffer[block_index];
+    nominal_speed = plan_compute_profile_nominal_speed(block);
+    plan_compute_profile_parameters(block, nominal_speed, pl.reconcile_nominal_speed);
+    pl.reconcile_nominal_speed = nominal_speed;
+    block_index = plan_next_block_index(block_index);
+    count++;
+  } while ((block_index != pl.reconcile_head) && (count < PLAN_RECONCILE_BLOCKS));
+  pl.reconcile_index = block_index;
 
-  #ifdef COREXY
-    target_steps[A_MOTOR] = lround(target[A_MOTOR]*settings.steps_per_mm[A_MOTOR]);
-    target_steps[B_MOTOR] = lround(target[B_MOTOR]*settings.steps_per_mm[B_MOTOR]);
-    block->steps[A_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) + (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
-    block->steps[B_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) - (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
+  // Reverse pass, from the entry speed of the first block not yet reconciled or a stop at the end
+  // of the buffer.
+  float entry_speed_sqr;
+  float next_entry_speed_sqr = 0.0f;
+  if (block_index != block_buffer_head) { next_entry_speed_sqr = block_buffer[block_index].entry_speed_sqr; }
+  // Entry speeds are replanned like planner_recalculate() over the new blocks and up to as many
+  // reconciled before them. Further back only lowered entries are carried on, raising them can wait.
+  uint16_t depth = count + PLAN_RECONCILE_BLOCKS;
+  block_index = plan_prev_block_index(block_index);
+  while (block_index != block_buffer_tail) {
+    block = &block_buffer[block_index];
+    entry_speed_sqr = plan_ramp_speed_sqr(block, next_entry_speed_sqr, block->millimeters);
+    if (entry_speed_sqr > block->max_entry_speed_sqr) { entry_speed_sqr = block->max_entry_speed_sqr; }
+    if (entry_speed_sqr < block->entry_speed_sqr) { block->entry_speed_sqr = entry_speed_sqr; }
+    else if ((depth == 0) || ((count == 0) && (entry_speed_sqr == block->entry_speed_sqr))) { break; }
+    else { block->entry_speed_sqr = entry_speed_sqr; }
+    if (count) { count--; }
+    if (depth) { depth--; }
+    next_entry_speed_sqr = block->entry_speed_sqr;
+    block_index = plan_prev_block_index(block_index);
+  }
+
+  // Forward pass, up to and including the first block not yet reconciled.
+  plan_block_t *current;
+  block = &block_buffer[block_index];
+  block_index = plan_next_block_index(block_index);
+  while (block_index != block_buffer_head) {
+    current = block;
+    block = &block_buffer[block_index];
+    entry_speed_sqr = plan_ramp_speed_sqr(current, current->entry_speed_sqr, current->millimeters);
+    if (entry_speed_sqr < block->entry_speed_sqr) { block->entry_speed_sqr = entry_speed_sqr; }
+    if (block_index == pl.reconcile_index) { break; }
+    block_index = plan_next_block_index(block_index);
+  }
+
+  // Notify the stepper if the exit speed of the executing block changed.
+  if (block_buffer[front_index].entry_speed_sqr != front_entry_speed_sqr) { st_update_plan_block_parameters(); }
+
+  #ifdef PLANNER_STATS
+    uint32_t now = plan_stats_timestamp();
+    uint32_t duration = now - stats_start_time;
+    plan_stats.reconcile_count++;
+    plan_stats.reconcile_time += duration;
+    if (duration > plan_stats.reconcile_time_max) { plan_stats.reconcile_time_max = duration; }
+    if (pl.reconcile_index == pl.reconcile_head) {
+      duration = now - plan_stats.override_start;
+      plan_stats.replan_count++;
+      plan_stats.replan_latency += duration;
+      if (duration > plan_stats.replan_latency_max) { plan_stats.replan_latency_max = duration; }
+    }
   #endif
+}
+#endif
 
-  for (idx=0; idx<N_AXIS; idx++) {
-    // Calculate target position in absolute steps, number of steps for each axis, and determine max step events.
-    // Also, compute individual axes distance for move and prep unit vector calculations.
-    // NOTE: Computes true distance from converted step values.
-    #ifdef COREXY
-      if ( !(idx == A_MOTOR) && !(idx == B_MOTOR) ) {
-        target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
-        block->steps[idx] = labs(target_steps[idx]-position_steps[idx]);
-      }
-      block->step_event_count = max(block->step_event_count, block->steps[idx]);
-      if (idx == A_MOTOR) {
-        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] + target_steps[Y_AXIS]-position_steps[Y_AXIS])/settings.steps_per_mm[idx];
-      } else if (idx == B_MOTOR) {
-        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] - target_steps[Y_AXIS]+position_steps[Y_AXIS])/settings.steps_per_mm[idx];
-      } else {
-        delta_mm = (target_steps[idx] - position_steps[idx])/settings.steps_per_mm[idx];
-      }
-    #else
-      target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
-      block->steps[idx] = labs(target_steps[idx]-position_steps[idx]);
-      block->step_event_count = max(block->step_event_count, block->steps[idx]);
-      delta_mm = (target_steps[idx] - position_steps[idx])/settings.steps_per_mm[idx];
-	  #endif
-    unit_vec[idx] = delta_mm; // Store unit vector numerator
 
-    // Set direction bits. Bit enabled always means direction is negative.
-    if (delta_mm < 0.0 )
-    {
-      #ifdef STM32
-        block->direction_bits |= direction_pin_mask[idx];
-      #elif ATMEGA328P
-      block->direction_bits |= get_direction_pin_mask(idx);
+// Applies a feed or rapid override change to the plan. Without LAZY_OVERRIDE_REPLAN, every
+// buffered block is updated and the whole buffer replanned before this returns. Otherwise only
+// the executing block and the first PLAN_RECONCILE_BLOCKS blocks are, and the main loop carries
+// the change through the rest of the buffer with plan_override_reconcile().
+void plan_override_update()
+{
+  #ifdef PLANNER_STATS
+    uint32_t stats_start_time = plan_stats_timestamp();
+    plan_stats.override_start = stats_start_time;
+  #endif
+
+  #ifdef LAZY_OVERRIDE_REPLAN
+    st_update_plan_block_parameters(); // Replan the executing block from its current speed.
+    block_buffer_planned = block_buffer_tail;
+    pl.reconcile_index = block_buffer_tail;
+    pl.reconcile_head = block_buffer_head;
+    pl.reconcile_nominal_speed = SOME_LARGE_VALUE; // Set high for first block nominal speed calculation.
+    if (block_buffer_head != block_buffer_tail) {
+      // The next block appended joins the newest one at its new nominal speed.
+      plan_block_t *block = &block_buffer[plan_prev_block_index(block_buffer_head)];
+      float nominal_speed = plan_compute_profile_nominal_speed(block);
+      #ifdef ADAPTIVE_LOOKAHEAD
+        // Estimated from the speed change of the newest block, instead of summing the buffer again.
+        lookahead.time *= pl.previous_nominal_speed/nominal_speed;
+        lookahead.stopping_mm = plan_ramp_distance(block, nominal_speed, 0.0f);
       #endif
+      pl.previous_nominal_speed = nominal_speed;
     }
-  }
+    plan_override_reconcile();
+  #else
+    plan_update_velocity_profile_parameters();
+    plan_cycle_reinitialize();
+  #endif
 
-  // Bail if this is a zero-length block. Highly unlikely to occur.
-  if (block->step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+  #ifdef PLANNER_STATS
+    uint32_t duration = plan_stats_timestamp() - stats_start_time;
+    plan_stats.override_count++;
+    plan_stats.override_time += duration;
+    if (duration > plan_stats.override_time_max) { plan_stats.override_time_max = duration; }
+    #ifndef LAZY_OVERRIDE_REPLAN
+      plan_stats.replan_count++;
+      plan_stats.replan_latency += duration;
+      if (duration > plan_stats.replan_latency_max) { plan_stats.replan_latency_max = duration; }
+    #endif
+  #endif
+}
 
-  // Calculate the unit vector of the line move and the block maximum feed rate and acceleration scaled
-  // down such that no individual axes maximum values are exceeded with respect to the line direction.
-  // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
-  // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
-  block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
+
+// Computes the block acceleration, maximum rate and jerk, scaled down such that no individual axes
+// maximum values are exceeded with respect to the direction unit_vec.
+// NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
+// if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
+static void plan_compute_block_limits(plan_block_t *block, float *unit_vec)
+{
 #ifdef ENABLE_ACCEL_SCALING
   block->pbacceleration = limit_value_by_axis_maximum(adjustments.accel_adjusted, unit_vec);
 #else
   block->pbacceleration = limit_value_by_axis_maximum(settings.eeacceleration, unit_vec);
 #endif
   block->rapid_rate = limit_value_by_axis_maximum(settings.max_rate, unit_vec);
+  #ifdef S_CURVE_ACCELERATION
+    // Limited like the acceleration, except that axes without a jerk setting are skipped.
+    block->jerk = 0.0f;
+    uint8_t idx;
+    for (idx=0; idx<N_AXIS; idx++) {
+      if ((unit_vec[idx] != 0.0f) && (settings.jerk[idx] > 0.0f)) {
+        float axis_jerk = settings.jerk[idx]/fabsf(unit_vec[idx]);
+        if ((block->jerk == 0.0f) || (axis_jerk < block->jerk)) { block->jerk = axis_jerk; }
+      }
+    }
+  #endif
+  #ifdef INPUT_SHAPING
+    st_shaper_block_timing(block);
+  #endif
+}
+
+
+#ifdef CENTRIPETAL_SPEED_LIMIT
+// A direction in the plane takes at most sqrt(unit_vec[idx]^2 + normal_vec[idx]^2) of each axis,
+// so the worst direction is limited by the axis with the lowest acceleration over that share.
+float plan_compute_curve_acceleration(float *unit_vec, float *normal_vec)
+{
+  float curve_acceleration = SOME_LARGE_VALUE;
+  float axis_share, axis_acceleration;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    axis_share = sqrtf(unit_vec[idx]*unit_vec[idx] + normal_vec[idx]*normal_vec[idx]);
+    if (axis_share > 0.0f) {
+      #ifdef ENABLE_ACCEL_SCALING
+        axis_acceleration = adjustments.accel_adjusted[idx]/axis_share;
+      #else
+        axis_acceleration = settings.eeacceleration[idx]/axis_share;
+      #endif
+      if (axis_acceleration < curve_acceleration) { curve_acceleration = axis_acceleration; }
+    }
+  }
+  return(curve_acceleration);
+}
+#endif
+
+
+// Completes a new block from its geometry, the unit vectors of its direction at its start and end
+// and its target in steps, and appends it to the buffer. A system motion is only prepared.
+static uint8_t plan_buffer_block(plan_block_t *block, plan_line_data_t *pl_data, float *unit_vec, float *exit_unit_vec,
+  int32_t *target_steps)
+{
+  uint8_t idx;
 
   // Store programmed rate.
   if (block->condition & PL_COND_FLAG_RAPID_MOTION) { block->programmed_rate = block->rapid_rate; }
@@ -413,6 +813,7 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     // Initialize block entry speed as zero. Assume it will be starting from rest. Planner will correct this later.
     // If system motion, the system motion block always is assumed to start from rest and end at a complete stop.
     block->entry_speed_sqr = 0.0;
+    block->max_entry_speed_sqr = 0.0;
     block->max_junction_speed_sqr = 0.0; // Starting from rest. Enforce start from zero velocity.
 
   } else {
@@ -428,10 +829,9 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     //
     // NOTE: If the junction deviation value is finite, Grbl executes the motions in an exact path
     // mode (G61). If the junction deviation value is zero, Grbl will execute the motion in an exact
-    // stop mode (G61.1) manner. In the future, if continuous mode (G64) is desired, the math here
-    // is exactly the same. Instead of motioning all the way to junction point, the machine will
-    // just follow the arc circle defined here. The Arduino doesn't have the CPU cycles to perform
-    // a continuous mode path, but ARM-based microcontrollers most certainly do.
+    // stop mode (G61.1) manner. Continuous mode (G64 P, ENABLE_PATH_BLENDING) uses the same math.
+    // Instead of motioning all the way to junction point, mc_line() has the machine follow an arc
+    // circle like the one defined here, but sized by the G64 path tolerance.
     //
     // NOTE: The max junction speed is a fixed value, since machine acceleration limits cannot be
     // changed dynamically during operation nor can the line move geometry. This must be kept in
@@ -467,6 +867,14 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
                        (junction_acceleration * settings.junction_deviation * sin_theta_d2)/(1.0-sin_theta_d2) );
       }
     }
+
+    #ifdef CENTRIPETAL_SPEED_LIMIT
+      // A junction between two chords of an arc is a point of the arc, not a corner. Take it at the
+      // speed the arc allows, v^2 = a*r, whatever the chord angle the arc tolerance made.
+      if (pl_data->curve_junction) {
+        block->max_junction_speed_sqr = pl_data->curve_acceleration*pl_data->curve_radius;
+      }
+    #endif
   }
 
   // Block system motion from updating this data to ensure next g-code motion is computed correctly.
@@ -475,21 +883,241 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
     plan_compute_profile_parameters(block, nominal_speed, pl.previous_nominal_speed);
     pl.previous_nominal_speed = nominal_speed;
 
+    #ifdef ADAPTIVE_LOOKAHEAD
+      // The first block of an empty buffer starts executing right away and is not lookahead.
+      if (block_buffer_head != block_buffer_tail) {
+        lookahead.millimeters += block->millimeters;
+        lookahead.time += block->millimeters*60000.0f/nominal_speed;
+      }
+      lookahead.stopping_mm = plan_ramp_distance(block, nominal_speed, 0.0f);
+    #endif
+
     // Update previous path unit_vector and planner position.
-    memcpy(pl.previous_unit_vec, unit_vec, sizeof(unit_vec)); // pl.previous_unit_vec[] = unit_vec[]
-    memcpy(pl.position, target_steps, sizeof(target_steps)); // pl.position[] = target_steps[]
+    memcpy(pl.previous_unit_vec, exit_unit_vec, sizeof(pl.previous_unit_vec)); // pl.previous_unit_vec[] = exit_unit_vec[]
+    memcpy(pl.position, target_steps, sizeof(pl.position)); // pl.position[] = target_steps[]
 
     // New block is all set. Update buffer head and next buffer head indices.
     block_buffer_head = next_buffer_head;
     next_buffer_head = plan_next_block_index(block_buffer_head);
+    #ifdef ADAPTIVE_LOOKAHEAD
+      uint16_t block_count = plan_get_block_buffer_count();
+      if (block_count > lookahead.blocks_max) { lookahead.blocks_max = block_count; }
+    #endif
+
+    #ifdef PLANNER_STATS
+      plan_stats.block_count++;
+    #endif
 
     // Finish up by recalculating the plan with the new block.
-    planner_recalculate();
+    planner_recalculate(false);
   }
   return(PLAN_OK);
 }
 
 
+/* Add a new linear movement to the buffer. target[N_AXIS] is the signed, absolute target position
+   in millimeters. Feed rate specifies the speed of the motion. If feed rate is inverted, the feed
+   rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
+   All position data passed to the planner must be in terms of machine position to keep the planner
+   independent of any coordinate system changes and offsets, which are handled by the g-code parser.
+   NOTE: Assumes buffer is available. Buffer checks are handled at a higher level by motion_control.
+   In other words, the buffer head is never equal to the buffer tail.  Also the feed rate input value
+   is used in three ways: as a normal feed rate if invert_feed_rate is false, as inverse time if
+   invert_feed_rate is true, or as seek/rapids rate if the feed_rate value is negative (and
+   invert_feed_rate always false).
+   The system motion condition tells the planner to plan a motion in the always unused block buffer
+   head. It avoids changing the planner state and preserves the buffer to ensure subsequent gcode
+   motions are still planned correctly, while the stepper module only points to the block buffer head
+   to execute the special system motion. */
+uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data)
+{
+  // Prepare and initialize new block. Copy relevant pl_data for block execution.
+  plan_block_t *block = &block_buffer[block_buffer_head];
+  // NOTE: Not cleared. Every field the stepper or the planner reads is written below.
+  block->condition = pl_data->condition;
+  block->direction_bits = 0;
+  #ifdef PLANNER_ARC_BLOCKS
+    block->arc = false;
+  #endif
+  #ifdef VARIABLE_SPINDLE
+    block->spindle_speed = pl_data->spindle_speed;
+  #endif
+  #ifdef USE_LINE_NUMBERS
+    block->line_number = pl_data->line_number;
+  #endif
+
+  // Compute and store initial move distance data.
+  int32_t target_steps[N_AXIS], position_steps[N_AXIS];
+  float unit_vec[N_AXIS], delta_mm;
+  uint32_t step_event_count = 0;
+  uint8_t idx;
+
+  // Copy position data based on type of motion being planned.
+  if (block->condition & PL_COND_FLAG_SYSTEM_MOTION) { 
+    #ifdef COREXY
+      position_steps[X_AXIS] = system_convert_corexy_to_x_axis_steps(sys_position);
+      position_steps[Y_AXIS] = system_convert_corexy_to_y_axis_steps(sys_position);
+      position_steps[Z_AXIS] = sys_position[Z_AXIS];
+    #else
+      memcpy(position_steps, sys_position, sizeof(sys_position)); 
+    #endif
+  } else { memcpy(position_steps, pl.position, sizeof(pl.position)); }
+
+  #ifdef COREXY
+    target_steps[A_MOTOR] = lround(target[A_MOTOR]*settings.steps_per_mm[A_MOTOR]);
+    target_steps[B_MOTOR] = lround(target[B_MOTOR]*settings.steps_per_mm[B_MOTOR]);
+    block->steps[A_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) + (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
+    block->steps[B_MOTOR] = labs((target_steps[X_AXIS]-position_steps[X_AXIS]) - (target_steps[Y_AXIS]-position_steps[Y_AXIS]));
+  #endif
+
+  for (idx=0; idx<N_AXIS; idx++) {
+    // Calculate target position in absolute steps, number of steps for each axis, and determine max step events.
+    // Also, compute individual axes distance for move and prep unit vector calculations.
+    // NOTE: Computes true distance from converted step values.
+    #ifdef COREXY
+      if ( !(idx == A_MOTOR) && !(idx == B_MOTOR) ) {
+        target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
+        block->steps[idx] = labs(target_steps[idx]-position_steps[idx]);
+      }
+      step_event_count = max(step_event_count, block->steps[idx]);
+      if (idx == A_MOTOR) {
+        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] + target_steps[Y_AXIS]-position_steps[Y_AXIS])/settings.steps_per_mm[idx];
+      } else if (idx == B_MOTOR) {
+        delta_mm = (target_steps[X_AXIS]-position_steps[X_AXIS] - target_steps[Y_AXIS]+position_steps[Y_AXIS])/settings.steps_per_mm[idx];
+      } else {
+        delta_mm = (target_steps[idx] - position_steps[idx])/settings.steps_per_mm[idx];
+      }
+    #else
+      target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
+      block->steps[idx] = labs(target_steps[idx]-position_steps[idx]);
+      step_event_count = max(step_event_count, block->steps[idx]);
+      delta_mm = (target_steps[idx] - position_steps[idx])/settings.steps_per_mm[idx];
+	  #endif
+    unit_vec[idx] = delta_mm; // Store unit vector numerator
+
+    // Set direction bits. Bit enabled always means direction is negative.
+    if (delta_mm < 0.0 )
+    {
+      #ifdef STM32
+        block->direction_bits |= direction_pin_mask[idx];
+      #elif ATMEGA328P
+      block->direction_bits |= get_direction_pin_mask(idx);
+      #endif
+    }
+  }
+
+  // Bail if this is a zero-length block. Highly unlikely to occur.
+  if (step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+
+  // Calculate the unit vector of the line move and the block maximum feed rate and acceleration.
+  block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
+  plan_compute_block_limits(block, unit_vec);
+
+  #ifdef CENTRIPETAL_SPEED_LIMIT
+    // Limit the chord of an arc to the speed at which the centripetal acceleration of the arc stays
+    // within the axis limits.
+    if (pl_data->curve_radius > 0.0f) {
+      float curve_rate = sqrtf(pl_data->curve_acceleration*pl_data->curve_radius);
+      if (block->rapid_rate > curve_rate) { block->rapid_rate = curve_rate; }
+    }
+  #endif
+
+  return(plan_buffer_block(block, pl_data, unit_vec, unit_vec, target_steps));
+}
+
+
+#ifdef PLANNER_ARC_BLOCKS
+/* Add a new arc motion to the buffer, from the planner position to target[N_AXIS] in machine
+   position. The arc turns by angular_travel about the center at offset[] from the start, in the
+   plane of axis_0 and axis_1. Any other axis moves linearly along it, as the linear axis of a helix.
+   The block is planned along the helix length. Its acceleration and maximum rate are limited by the
+   axis maximums in the worst direction the helix can take, the plane axes at their full share of the
+   helix and the other axes at theirs, and its maximum rate also by the centripetal acceleration. The
+   junctions use the tangents at the arc ends. The stepper steps the arc in chords.
+   NOTE: Assumes both the block and the arc buffer have room. Never a system motion. */
+uint8_t plan_buffer_arc(float *target, plan_line_data_t *pl_data, float *offset, float radius,
+  float angular_travel, uint8_t axis_0, uint8_t axis_1)
+{
+  // Prepare and initialize new block. Copy relevant pl_data for block execution.
+  plan_block_t *block = &block_buffer[block_buffer_head];
+  block->condition = pl_data->condition;
+  block->direction_bits = 0; // Set for each chord by the stepper.
+  block->arc = true;
+  #ifdef VARIABLE_SPINDLE
+    block->spindle_speed = pl_data->spindle_speed;
+  #endif
+  #ifdef USE_LINE_NUMBERS
+    block->line_number = pl_data->line_number;
+  #endif
+
+  plan_arc_t *arc = &arc_buffer[arc_buffer_head];
+  arc->offset[0] = offset[axis_0];
+  arc->offset[1] = offset[axis_1];
+  arc->angular_travel = angular_travel;
+  arc->axis_0 = axis_0;
+  arc->axis_1 = axis_1;
+
+  // Steps to the target, and the linear travel of the other axes. As for a line, the distances are
+  // computed from the converted step values.
+  int32_t target_steps[N_AXIS];
+  float unit_vec[N_AXIS], exit_unit_vec[N_AXIS], limit_vec[N_AXIS];
+  float arc_mm = radius*fabsf(angular_travel); // Length of the arc in the plane
+  float linear_mm_sqr = 0.0f;
+  uint32_t step_event_count = 0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    target_steps[idx] = lround(target[idx]*settings.steps_per_mm[idx]);
+    arc->steps[idx] = target_steps[idx]-pl.position[idx];
+    if ((idx == axis_0) || (idx == axis_1)) {
+      block->steps[idx] = ceilf(arc_mm*settings.steps_per_mm[idx]);
+      unit_vec[idx] = 0.0f;
+    } else {
+      block->steps[idx] = labs(arc->steps[idx]);
+      unit_vec[idx] = arc->steps[idx]/settings.steps_per_mm[idx];
+      linear_mm_sqr += unit_vec[idx]*unit_vec[idx];
+    }
+    step_event_count = max(step_event_count, block->steps[idx]);
+  }
+  if (step_event_count == 0) { return(PLAN_EMPTY_BLOCK); }
+  block->millimeters = sqrtf(arc_mm*arc_mm + linear_mm_sqr);
+  arc->millimeters = block->millimeters;
+
+  // The plane axes take up to arc_mm/millimeters of the direction each, at the points the arc runs
+  // along them. The other axes always take their share.
+  float inv_millimeters = 1.0f/block->millimeters;
+  for (idx=0; idx<N_AXIS; idx++) { limit_vec[idx] = unit_vec[idx]*inv_millimeters; }
+  limit_vec[axis_0] = limit_vec[axis_1] = arc_mm*inv_millimeters;
+  plan_compute_block_limits(block, limit_vec);
+
+  // Limit the speed to the centripetal acceleration the plane axes allow, a = v^2/r along the helix
+  // curvature radius r*(millimeters/arc_mm)^2.
+  #ifdef ENABLE_ACCEL_SCALING
+    float centripetal_acceleration = min(adjustments.accel_adjusted[axis_0], adjustments.accel_adjusted[axis_1]);
+  #else
+    float centripetal_acceleration = min(settings.eeacceleration[axis_0], settings.eeacceleration[axis_1]);
+  #endif
+  float centripetal_rate = sqrtf(centripetal_acceleration*radius)*block->millimeters/arc_mm;
+  if (block->rapid_rate > centripetal_rate) { block->rapid_rate = centripetal_rate; }
+
+  // Tangents at the start and end, perpendicular to the radius vector, which turns from -offset
+  // to the target. The plane part is scaled to the arc length to combine it with the linear travel.
+  memcpy(exit_unit_vec, unit_vec, sizeof(unit_vec));
+  unit_vec[axis_0] = angular_travel*offset[axis_1];
+  unit_vec[axis_1] = -angular_travel*offset[axis_0];
+  float r_axis0 = arc->steps[axis_0]/settings.steps_per_mm[axis_0] - offset[axis_0];
+  float r_axis1 = arc->steps[axis_1]/settings.steps_per_mm[axis_1] - offset[axis_1];
+  float r_scale = angular_travel*radius/sqrtf(r_axis0*r_axis0 + r_axis1*r_axis1);
+  exit_unit_vec[axis_0] = -r_scale*r_axis1;
+  exit_unit_vec[axis_1] = r_scale*r_axis0;
+  convert_delta_vector_to_unit_vector(unit_vec);
+  convert_delta_vector_to_unit_vector(exit_unit_vec);
+
+  arc_buffer_head = plan_next_arc_index(arc_buffer_head);
+  return(plan_buffer_block(block, pl_data, unit_vec, exit_unit_vec, target_steps));
+}
+#endif
+
+
 // Reset the planner position vectors. Called by the system abort/initialization routine.
 void plan_sync_position()
 {
@@ -513,7 +1141,7 @@ void plan_sync_position()
 
 
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available()
+uint16_t plan_get_block_buffer_available()
 {
   if (block_buffer_head >= block_buffer_tail) { return((BLOCK_BUFFER_SIZE-1)-(block_buffer_head-block_buffer_tail)); }
   return((block_buffer_tail-block_buffer_head-1));
@@ -522,13 +1150,28 @@ uint8_t plan_get_block_buffer_available()
 
 // Returns the number of active blocks are in the planner buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count()
+uint16_t plan_get_block_buffer_count()
 {
   if (block_buffer_head >= block_buffer_tail) { return(block_buffer_head-block_buffer_tail); }
   return(BLOCK_BUFFER_SIZE - (block_buffer_tail-block_buffer_head));
 }
 
 
+#ifdef ADAPTIVE_LOOKAHEAD
+plan_lookahead_t *plan_get_lookahead()
+{
+  lookahead.blocks = plan_get_block_buffer_count();
+  return(&lookahead);
+}
+
+
+void plan_lookahead_reset()
+{
+  lookahead.blocks_max = plan_get_block_buffer_count();
+}
+#endif
+
+
 // Re-initialize buffer plan with a partially completed block, assumed to exist at the buffer tail.
 // Called after a steppers have come to a complete stop for a feed hold and the cycle is stopped.
 void plan_cycle_reinitialize()
@@ -536,5 +1179,5 @@ void plan_cycle_reinitialize()
   // Re-plan from a complete stop. Reset planner entry speeds and buffer planned pointer.
   st_update_plan_block_parameters();
   block_buffer_planned = block_buffer_tail;
-  planner_recalculate();
+  planner_recalculate(true);
 }
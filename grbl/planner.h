@@ -27,7 +27,11 @@
 // The number of linear motions that can be in the plan at any give time
 #ifndef BLOCK_BUFFER_SIZE
 	#ifdef STM32
-		#define BLOCK_BUFFER_SIZE 200
+		#if defined(STM32F4) && defined(PLANNER_BLOCKS_F4)
+			#define BLOCK_BUFFER_SIZE PLANNER_BLOCKS_F4
+		#else
+			#define BLOCK_BUFFER_SIZE 200 // Also the most the 20KB of F1 RAM has room for.
+		#endif
 	#endif
 	#ifdef ATMEGA328P
 		#ifdef USE_LINE_NUMBERS
@@ -38,6 +42,57 @@
 	#endif
 #endif
 
+#ifdef ADAPTIVE_LOOKAHEAD
+	// Blocks always buffered before the lookahead distance and time decide whether the buffer is full.
+	#ifndef LOOKAHEAD_BLOCKS
+		#ifdef STM32F4
+			#define LOOKAHEAD_BLOCKS 200
+		#else
+			#define LOOKAHEAD_BLOCKS 150
+		#endif
+	#endif
+	#if (LOOKAHEAD_BLOCKS > BLOCK_BUFFER_SIZE-1)
+		#error "LOOKAHEAD_BLOCKS must be less than BLOCK_BUFFER_SIZE"
+	#endif
+	// Motion time, in ms, the buffered path must also cover before the buffer counts as full.
+	#ifndef LOOKAHEAD_TIME
+		#define LOOKAHEAD_TIME 250
+	#endif
+#endif
+
+// Most blocks a new block replans back from the head. Bounds planner_recalculate() in time with a deep pool.
+#ifndef LOOKAHEAD_RECALC_BLOCKS
+	#if (BLOCK_BUFFER_SIZE > 512)
+		#define LOOKAHEAD_RECALC_BLOCKS 512
+	#else
+		#define LOOKAHEAD_RECALC_BLOCKS BLOCK_BUFFER_SIZE // The whole pool, as Grbl replans it.
+	#endif
+#endif
+#if (LOOKAHEAD_RECALC_BLOCKS < 2) || (LOOKAHEAD_RECALC_BLOCKS > BLOCK_BUFFER_SIZE)
+	#error "LOOKAHEAD_RECALC_BLOCKS must be 2 to BLOCK_BUFFER_SIZE"
+#endif
+
+#ifdef LAZY_OVERRIDE_REPLAN
+	// Blocks an override change is carried into per plan_override_reconcile() call.
+	#ifndef PLAN_RECONCILE_BLOCKS
+		#define PLAN_RECONCILE_BLOCKS 32
+	#endif
+	#if (PLAN_RECONCILE_BLOCKS < 2)
+		#error "PLAN_RECONCILE_BLOCKS must be at least 2"
+	#endif
+#endif
+
+#ifdef PLANNER_ARC_BLOCKS
+	// Native arcs the planner holds at once. Each arc block also takes a planner block.
+	#ifndef PLANNER_ARC_BUFFER_SIZE
+		#ifdef STM32F4
+			#define PLANNER_ARC_BUFFER_SIZE 256
+		#else
+			#define PLANNER_ARC_BUFFER_SIZE 16 // 512 bytes, which the smaller F1 blocks make room for.
+		#endif
+	#endif
+#endif
+
 // Returned status message from planner.
 #define PLAN_OK true
 #define PLAN_EMPTY_BLOCK false
@@ -58,38 +113,67 @@
 // This struct stores a linear movement of a g-code block motion with its critical "nominal" values
 // are as specified in the source g-code.
 typedef struct {
-  // Fields used by the bresenham algorithm for tracing the line
-  // NOTE: Used by stepper algorithm to execute the block correctly. Do not alter these values.
-  uint32_t steps[N_AXIS];    // Step count along each axis
-  uint32_t step_event_count; // The maximum step axis count and number of steps required to complete this block.
-  uint8_t direction_bits;    // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
-
-  // Block condition data to ensure correct execution depending on states and overrides.
-  uint8_t condition;      // Block bitflag variable defining block run conditions. Copied from pl_line_data.
-  #ifdef USE_LINE_NUMBERS
-    int32_t line_number;  // Block line number for real-time reporting. Copied from pl_line_data.
-  #endif
-
   // Fields used by the motion planner to manage acceleration. Some of these values may be updated
   // by the stepper module during execution of special motion cases for replanning purposes.
+  // NOTE: Kept together at the start of the block. planner_recalculate() reads no other fields.
   float entry_speed_sqr;     // The current planned entry speed at block junction in (mm/min)^2
   float max_entry_speed_sqr; // Maximum allowable entry speed based on the minimum of junction limit and
                              //   neighboring nominal speeds with overrides in (mm/min)^2
   float pbacceleration;        // Axis-limit adjusted line acceleration in (mm/min^2). Does not change.
   float millimeters;         // The remaining distance for this block to be executed in (mm).
                              // NOTE: This value may be altered by stepper algorithm during execution.
+  #ifdef S_CURVE_ACCELERATION
+    float jerk;                // Axis-limit adjusted line jerk in (mm/min^3), 0 if unlimited. Does not change.
+  #endif
+  #ifdef INPUT_SHAPING
+    // Shaper of the moving axes, see plan_ramp_distance(). Set by st_shaper_block_timing().
+    float shaper_time_high;    // Longer of the shaper centroid and duration less it in (min), 0 if unshaped
+    float shaper_time_low;     // Shorter of them in (min)
+  #endif
 
   // Stored rate limiting data used by planner when changes occur.
   float max_junction_speed_sqr; // Junction entry speed limit based on direction vectors in (mm/min)^2
   float rapid_rate;             // Axis-limit adjusted maximum rate for this block direction in (mm/min)
   float programmed_rate;        // Programmed rate of this block (mm/min).
 
+  // Fields used by the bresenham algorithm for tracing the line
+  // NOTE: Used by stepper algorithm to execute the block correctly. Do not alter these values.
+  // NOTE: The number of steps to complete the block, the largest axis step count, is not stored to keep
+  // the block compact. The stepper takes it from steps[] when it loads the block.
+  // NOTE: For an arc block, the steps each axis takes at most along the arc, which bound its step rate.
+  uint32_t steps[N_AXIS];    // Step count along each axis
+
   #ifdef VARIABLE_SPINDLE
     // Stored spindle speed data used by spindle overrides and resuming methods.
     float spindle_speed;    // Block spindle speed. Copied from pl_line_data.
   #endif
+
+  // Block condition data to ensure correct execution depending on states and overrides.
+  #ifdef USE_LINE_NUMBERS
+    int32_t line_number;  // Block line number for real-time reporting. Copied from pl_line_data.
+  #endif
+  uint8_t condition;      // Block bitflag variable defining block run conditions. Copied from pl_line_data.
+  uint8_t direction_bits;    // The direction bit set for this block (refers to *_DIRECTION_BIT in config.h)
+  #ifdef PLANNER_ARC_BLOCKS
+    uint8_t arc;             // True for an arc block. Its geometry is the first arc in the arc ring.
+  #endif
+  // NOTE: The byte fields come last, so the only padding is at the end of the block.
 } plan_block_t;
 
+#ifdef PLANNER_ARC_BLOCKS
+// Geometry of an arc block. Arcs are kept in their own ring, in the order of their blocks. The
+// stepper traces the arc relative to its start, so the float math only sees small distances.
+typedef struct {
+  float offset[2];          // Arc center from the start along the plane axes (mm)
+  float angular_travel;     // Signed angle swept, counterclockwise positive (rad)
+  float millimeters;        // Helix length, the block millimeters before execution starts
+  int32_t steps[N_AXIS];    // Signed steps from the start to the target. Other axes than the plane
+                            //   axes move linearly along the helix.
+  uint8_t axis_0;           // Plane axes
+  uint8_t axis_1;
+} plan_arc_t;
+#endif
+
 
 // Planner data prototype. Must be used when passing new motions to the planner.
 typedef struct {
@@ -99,6 +183,14 @@ typedef struct {
   #ifdef USE_LINE_NUMBERS
     int32_t line_number;    // Desired line number to report when executing.
   #endif
+  #ifdef ENABLE_PATH_BLENDING
+    float path_tolerance;   // G64 P in mm. Corners with the next line are blended within it. Used by mc_line().
+  #endif
+  #ifdef CENTRIPETAL_SPEED_LIMIT
+    float curve_radius;       // Curvature radius of the arc a line is a chord of, zero for other lines (mm).
+    float curve_acceleration; // Lowest acceleration the axes allow in the plane of that arc (mm/min^2).
+    uint8_t curve_junction;   // True, if the line starts on the arc, after its first chord.
+  #endif
 } plan_line_data_t;
 
 
@@ -111,6 +203,26 @@ void plan_reset_buffer(); // Reset buffer only.
 // rate is taken to mean "frequency" and would complete the operation in 1/feed_rate minutes.
 uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data);
 
+#ifdef CENTRIPETAL_SPEED_LIMIT
+  // Returns the lowest acceleration the axis maximums allow in the plane spanned by the orthogonal
+  // unit vectors unit_vec and normal_vec. A curve in that plane turns with at most this acceleration.
+  float plan_compute_curve_acceleration(float *unit_vec, float *normal_vec);
+#endif
+
+#ifdef PLANNER_ARC_BLOCKS
+  // Add a new arc motion to the buffer. offset[] is the arc center from the current planner
+  // position, along axis_0 and axis_1, and angular_travel the signed angle it sweeps. Like
+  // plan_buffer_line(), assumes both the block and the arc buffer have room.
+  uint8_t plan_buffer_arc(float *target, plan_line_data_t *pl_data, float *offset, float radius,
+    float angular_travel, uint8_t axis_0, uint8_t axis_1);
+
+  // Gets the geometry of the first arc block in the buffer. Called by the stepper for an arc block.
+  plan_arc_t *plan_get_current_arc();
+
+  // Returns the status of the arc ring buffer. True, if full.
+  uint8_t plan_check_full_arc_buffer();
+#endif
+
 // Called when the current block is no longer needed. Discards the block and makes the memory
 // availible for new blocks.
 void plan_discard_current_block();
@@ -122,17 +234,38 @@ plan_block_t *plan_get_system_motion_block();
 plan_block_t *plan_get_current_block();
 
 // Called periodically by step segment buffer. Mostly used internally by planner.
-uint8_t plan_next_block_index(uint8_t block_index);
+uint16_t plan_next_block_index(uint16_t block_index);
 
 // Called by step segment buffer when computing executing block velocity profile.
 float plan_get_exec_block_exit_speed_sqr();
 
 // Called by main program during planner calculations and step segment buffer during initialization.
 float plan_compute_profile_nominal_speed(plan_block_t *block);
+#ifdef ST_PREP_FIXED_POINT
+  uint32_t plan_compute_profile_nominal_speed_fixed(plan_block_t *block, uint32_t programmed_rate, uint32_t rapid_rate, uint32_t minimum_rate);
+#endif
+
+// Ramp distance between two speeds and the speed reached over a distance, at the block acceleration
+// and, with S_CURVE_ACCELERATION, its jerk, and with INPUT_SHAPING, its shaper. Called by the
+// planner and the segment generator.
+float plan_ramp_distance(plan_block_t *block, float start_speed, float end_speed);
+float plan_ramp_speed_sqr(plan_block_t *block, float speed_sqr, float distance);
+#if defined(S_CURVE_ACCELERATION) || defined(INPUT_SHAPING)
+  uint8_t plan_ramp_extended(plan_block_t *block);
+  float plan_ramp_exit_speed(plan_block_t *block, float speed, float distance);
+#endif
 
 // Re-calculates buffered motions profile parameters upon a motion-based override change.
 void plan_update_velocity_profile_parameters();
 
+// Applies a feed or rapid override change to the plan. Called by the realtime override handler.
+void plan_override_update();
+
+#ifdef LAZY_OVERRIDE_REPLAN
+  // Carries the last override change a few more blocks into the plan. Called from the main loop.
+  void plan_override_reconcile();
+#endif
+
 // Reset the planner position vector (in steps)
 void plan_sync_position();
 
@@ -140,16 +273,61 @@ void plan_sync_position();
 void plan_cycle_reinitialize();
 
 // Returns the number of available blocks are in the planner buffer.
-uint8_t plan_get_block_buffer_available();
+uint16_t plan_get_block_buffer_available();
 
 // Returns the number of active blocks are in the planner buffer.
-// NOTE: Deprecated. Not used unless classic status reports are enabled in config.h
-uint8_t plan_get_block_buffer_count();
+// NOTE: Only used by classic status reports and the line hold of mc_line().
+uint16_t plan_get_block_buffer_count();
 
 // Returns the status of the block ring buffer. True, if buffer is full.
 uint8_t plan_check_full_buffer();
 
 void plan_get_planner_mpos(float *target);
 
+#ifdef ADAPTIVE_LOOKAHEAD
+  // Lookahead window of the planner buffer, counted beyond the executing block.
+  typedef struct {
+    uint16_t blocks;        // Blocks in the buffer.
+    uint16_t blocks_max;    // Most blocks buffered since the last plan_lookahead_reset().
+    float millimeters;      // Path length buffered beyond the executing block.
+    float time;             // Motion time of that path at nominal speeds, in ms.
+    float stopping_mm;      // Distance the newest block needs to stop from its nominal speed.
+  } plan_lookahead_t;
+
+  // Returns the current lookahead window.
+  plan_lookahead_t *plan_get_lookahead();
+
+  // Restarts the blocks_max high water mark.
+  void plan_lookahead_reset();
+#endif
+
+#ifdef PLANNER_STATS
+  // Planner workload counters, read by the host benchmark (sim/bench.c). Durations are in units
+  // of plan_stats_timestamp(), which the platform provides.
+  typedef struct {
+    uint32_t block_count;           // Blocks appended by plan_buffer_line().
+    uint32_t recalculate_count;     // planner_recalculate() calls.
+    uint64_t recalculate_time;      // Total time spent in planner_recalculate().
+    uint32_t recalculate_time_max;  // Longest single planner_recalculate().
+    uint64_t reverse_depth_total;   // Blocks visited by reverse passes.
+    uint32_t reverse_depth_max;     // Deepest reverse pass.
+    uint32_t reverse_full_count;    // Reverse passes that walked all the way back to the buffer tail.
+    uint64_t forward_depth_total;   // Blocks visited by forward passes.
+    uint32_t override_count;        // Feed and rapid override changes applied to the plan.
+    uint64_t override_time;         // Total time spent in plan_override_update().
+    uint32_t override_time_max;     // Longest single plan_override_update(), the foreground stall.
+    uint32_t override_start;        // Timestamp of the last override change.
+    uint32_t replan_count;          // Override changes carried through the whole buffer.
+    uint64_t replan_latency;        // Total time from an override change until the whole buffer is replanned.
+    uint32_t replan_latency_max;
+    uint32_t reconcile_count;       // plan_override_reconcile() steps.
+    uint64_t reconcile_time;        // Total time spent in them.
+    uint32_t reconcile_time_max;    // Longest single step.
+  } plan_stats_t;
+  extern plan_stats_t plan_stats;
+
+  uint32_t plan_stats_timestamp();
+#endif
+
 
 #endif
@@ -151,6 +151,11 @@ void protocol_main_loop()
       }
     }
 
+    #ifdef MC_LINE_HOLD
+      // Release a line held back by mc_line() before the planner runs out of motion.
+      if (plan_get_block_buffer_count() < 2) { mc_hold_flush(); }
+    #endif
+
     // If there are no more characters in the serial read buffer to be processed and executed,
     // this indicates that g-code streaming has either filled the planner buffer or has
     // completed. In either case, auto-cycle start, if enabled, any queued moves.
@@ -168,6 +173,9 @@ void protocol_main_loop()
 // during a synchronize call, if it should happen. Also, waits for clean cycle end.
 void protocol_buffer_synchronize()
 {
+  #ifdef MC_LINE_HOLD
+    mc_hold_flush(); // Plan a line held back by mc_line().
+  #endif
   // If system is queued, ensure cycle resumes if the auto start flag is present.
   protocol_auto_cycle_start();
   do {
@@ -215,6 +223,9 @@ void protocol_execute_realtime()
 void protocol_exec_rt_system()
 {
   uint8_t rt_exec; // Temp variable to avoid calling volatile multiple times.
+  #ifdef STM32_SIM
+    sim_poll(); // Host simulator: every realtime check is where virtual time advances.
+  #endif
   rt_exec = sys_rt_exec_alarm; // Copy volatile sys_rt_exec_alarm.
   if (rt_exec) { // Enter only if any bit flag is true
     // System alarm. Everything has shutdown by something that has gone severely wrong. Report
@@ -232,6 +243,9 @@ void protocol_exec_rt_system()
         // the user and a GUI time to do what is needed before resetting, like killing the
         // incoming stream. The same could be said about soft limits. While the position is not
         // lost, continued streaming could cause a serious crash if by chance it gets executed.
+        #ifdef STM32_SIM
+          sim_poll(); // Host simulator: let virtual time and serial input advance.
+        #endif
       } while (bit_isfalse(sys_rt_exec_state,EXEC_RESET));
     }
     system_clear_exec_alarm(); // Clear alarm
@@ -425,8 +439,7 @@ void protocol_exec_rt_system()
       sys.f_override = new_f_override;
       sys.r_override = new_r_override;
       sys.report_ovr_counter = 0; // Set to report change immediately
-      plan_update_velocity_profile_parameters();
-      plan_cycle_reinitialize();
+      plan_override_update();
     }
   }
 
@@ -490,6 +503,10 @@ void protocol_exec_rt_system()
     }
   #endif
 
+  #ifdef LAZY_OVERRIDE_REPLAN
+    plan_override_reconcile(); // Carry the last override change further into the plan.
+  #endif
+
   // Reload step segment buffer
   if (sys.state & (STATE_CYCLE | STATE_HOLD | STATE_SAFETY_DOOR | STATE_HOMING | STATE_SLEEP| STATE_JOG)) {
     st_prep_buffer();
@@ -84,6 +84,10 @@ static void report_util_setting_string(uint8_t n) {
         case 1: printPgmString(PSTR(":mm/min")); break;
         case 2: printPgmString(PSTR(":mm/s^2")); break;
         case 3: printPgmString(PSTR(":mm max")); break;
+        case 4: printPgmString(PSTR(":mm/s^3")); break;
+        case 5: printPgmString(PSTR(":shaper")); break;
+        case 6: printPgmString(PSTR(":Hz")); break;
+        case 7: printPgmString(PSTR(":damping")); break;
       }
       break;
   }
@@ -174,7 +178,11 @@ void report_init_message()
 
 // Grbl help message
 void report_grbl_help() {
-  printPgmString(PSTR("[HLP:$$ $# $G $I $N $x=val $Nx=line $J=line $SLP $C $X $H ~ ! ? ctrl-x]\r\n"));    
+  #if defined(ENABLE_PREP_PROFILE) || defined(ENABLE_STEP_ISR_PROFILE)
+    printPgmString(PSTR("[HLP:$$ $# $G $I $N $x=val $Nx=line $J=line $SLP $C $X $H $P ~ ! ? ctrl-x]\r\n"));
+  #else
+    printPgmString(PSTR("[HLP:$$ $# $G $I $N $x=val $Nx=line $J=line $SLP $C $X $H ~ ! ? ctrl-x]\r\n"));
+  #endif
 }
 
 
@@ -218,6 +226,14 @@ void report_grbl_settings() {
     report_util_uint8_setting(50,settings.spindle_enable_pin_mode);
   #endif
 
+  #ifdef SEGMENT_BUFFER_ARENA
+    report_util_uint8_setting(60,settings.segment_buffer_ms);
+  #endif
+
+  #ifdef ENABLE_LINE_COALESCING
+    report_util_float_setting(61,settings.coalesce_tolerance,N_DECIMAL_SETTINGVALUE);
+  #endif
+
 
 
 
@@ -231,6 +247,14 @@ void report_grbl_settings() {
         case 1: report_util_float_setting(val+idx,settings.max_rate[idx],N_DECIMAL_SETTINGVALUE); break;
         case 2: report_util_float_setting(val+idx,settings.eeacceleration[idx]/(60*60),N_DECIMAL_SETTINGVALUE); break;
         case 3: report_util_float_setting(val+idx,-settings.max_travel[idx],N_DECIMAL_SETTINGVALUE); break;
+        #ifdef S_CURVE_ACCELERATION
+          case 4: report_util_float_setting(val+idx,settings.jerk[idx]/(60*60*60),N_DECIMAL_SETTINGVALUE); break;
+        #endif
+        #ifdef INPUT_SHAPING
+          case 5: report_util_uint8_setting(val+idx,settings.shaper_type[idx]); break;
+          case 6: report_util_float_setting(val+idx,settings.shaper_frequency[idx],N_DECIMAL_SETTINGVALUE); break;
+          case 7: report_util_float_setting(val+idx,settings.shaper_damping[idx],N_DECIMAL_SETTINGVALUE); break;
+        #endif
       }
     }
     val += AXIS_SETTINGS_INCREMENT;
@@ -291,6 +315,10 @@ void report_gcode_modes()
   if (gc_state.modal.motion >= MOTION_MODE_PROBE_TOWARD) {
     printPgmString(PSTR("38."));
     print_uint8_base10(gc_state.modal.motion - (MOTION_MODE_PROBE_TOWARD-2));
+  #ifdef ENABLE_SPLINE_MOTION
+  } else if (gc_state.modal.motion == MOTION_MODE_QUADRATIC_SPLINE) {
+    printPgmString(PSTR("5.1"));
+  #endif
   } else {
     print_uint8_base10(gc_state.modal.motion);
   }
@@ -310,6 +338,13 @@ void report_gcode_modes()
   report_util_gcode_modes_G();
   print_uint8_base10(94-gc_state.modal.feed_rate);
 
+  #ifdef ENABLE_PATH_BLENDING
+    if (gc_state.modal.control == CONTROL_MODE_CONTINUOUS) {
+      report_util_gcode_modes_G();
+      print_uint8_base10(64);
+    }
+  #endif
+
   if (gc_state.modal.program_flow) {
     report_util_gcode_modes_M();
     switch (gc_state.modal.program_flow) {
@@ -449,9 +484,9 @@ void report_build_info(char *line)
 
   // NOTE: Compiled values, like override increments/max/min values, may be added at some point later.
   serial_write(',');
-  print_uint8_base10(BLOCK_BUFFER_SIZE-1);
+  print_uint32_base10(BLOCK_BUFFER_SIZE-1);
   serial_write(',');
-  print_uint8_base10(RX_BUFFER_SIZE);
+  print_uint32_base10(RX_BUFFER_SIZE);
 
   report_util_feedback_line_feed();
 }
@@ -475,7 +510,7 @@ void report_realtime_status()
 {
   uint8_t idx;
   int32_t current_position[N_AXIS]; // Copy current state of the system position variable
-  memcpy(current_position,sys_position,sizeof(sys_position));
+  st_get_position(current_position);
   float print_position[N_AXIS];
   system_convert_array_steps_to_mpos(print_position,current_position);
 
@@ -540,9 +575,9 @@ void report_realtime_status()
   #ifdef REPORT_FIELD_BUFFER_STATE
     if (bit_istrue(settings.status_report_mask,BITFLAG_RT_STATUS_BUFFER_STATE)) {
       printPgmString(PSTR("|Bf:"));
-      print_uint8_base10(plan_get_block_buffer_available());
+      print_uint32_base10(plan_get_block_buffer_available());
       serial_write(',');
-      print_uint8_base10(serial_get_rx_buffer_available());
+      print_uint32_base10(serial_get_rx_buffer_available());
     }
   #endif
 
@@ -658,11 +693,89 @@ void report_realtime_status()
     }
   #endif
 
+  #ifdef ENABLE_STEP_ISR_PROFILE
+    st_isr_profile_t *isr_profile = st_get_isr_profile();
+    printPgmString(PSTR("|ISR:"));
+    print_uint32_base10(isr_profile->cycles_max);
+    serial_write(',');
+    print_uint32_base10(isr_profile->count ? (uint32_t)(isr_profile->cycles_total/isr_profile->count) : 0);
+    serial_write(',');
+    print_uint32_base10(isr_profile->overruns);
+    serial_write(',');
+    print_uint32_base10(isr_profile->latency_max);
+    serial_write(',');
+    print_uint32_base10(isr_profile->reentries);
+    for (idx=0; idx<STEP_ISR_HISTOGRAM_BINS; idx++) {
+      serial_write(',');
+      print_uint32_base10(isr_profile->histogram[idx]);
+    }
+  #endif
+
   serial_write('>');
   report_util_line_feed();
 }
 
 
+#ifdef ENABLE_PREP_PROFILE
+  // Prints the step segment generator profile. Cycle counts are CPU cycles per generated segment,
+  // to be compared against the segment budget on the last line.
+  void report_prep_profile()
+  {
+    st_prep_profile_t *profile = st_get_prep_profile();
+    const char *ramp_name[PREP_PROFILE_RAMPS] = { "ACCEL", "CRUISE", "DECEL", "DECEL_OVR" };
+    uint8_t idx;
+    for (idx=0; idx<PREP_PROFILE_RAMPS; idx++) {
+      printPgmString(PSTR("[PREP:"));
+      printString(ramp_name[idx]);
+      serial_write(',');
+      print_uint32_base10(profile->segments[idx]);
+      serial_write(',');
+      if (profile->segments[idx]) { print_uint32_base10((uint32_t)(profile->cycles[idx]/profile->segments[idx])); }
+      else { serial_write('0'); }
+      serial_write(',');
+      print_uint32_base10(profile->cycles_max[idx]);
+      report_util_feedback_line_feed();
+    }
+    printPgmString(PSTR("[PREPBUF:"));
+    print_uint8_base10(profile->low_water);
+    serial_write(',');
+    #ifdef SEGMENT_BUFFER_ARENA
+      print_uint8_base10(profile->buffer_size);
+    #else
+      print_uint8_base10(SEGMENT_BUFFER_SIZE);
+    #endif
+    serial_write(',');
+    print_uint32_base10(profile->underruns);
+    serial_write(',');
+    print_uint32_base10(SystemCoreClock/ACCELERATION_TICKS_PER_SECOND);
+    report_util_feedback_line_feed();
+    #ifdef SEGMENT_BUFFER_ARENA
+      printPgmString(PSTR("[PREPTIME:"));
+      printFloat((float)profile->low_water_us/1000.0f,2);
+      serial_write(',');
+      printFloat((float)profile->mean_us/1000.0f,2);
+      serial_write(',');
+      printFloat((float)profile->depth_us/1000.0f,2);
+      report_util_feedback_line_feed();
+    #endif
+    #ifdef ADAPTIVE_LOOKAHEAD
+      plan_lookahead_t *lookahead = plan_get_lookahead();
+      printPgmString(PSTR("[PLAN:"));
+      print_uint32_base10(lookahead->blocks);
+      serial_write(',');
+      print_uint32_base10(lookahead->blocks_max);
+      serial_write(',');
+      printFloat(lookahead->millimeters,2);
+      serial_write(',');
+      printFloat(lookahead->time,1);
+      serial_write(',');
+      printFloat(lookahead->stopping_mm,2);
+      report_util_feedback_line_feed();
+    #endif
+  }
+#endif
+
+
 #ifdef DEBUG
   void report_realtime_debug()
   {
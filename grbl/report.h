@@ -131,6 +131,11 @@ void report_execute_startup_message(char *line, uint8_t status_code);
 // Prints build info and user info
 void report_build_info(char *line);
 
+#ifdef ENABLE_PREP_PROFILE
+  // Prints the step segment generator profile ($P)
+  void report_prep_profile();
+#endif
+
 #ifdef DEBUG
   void report_realtime_debug();
 #endif
@@ -25,7 +25,11 @@
 
 
 #ifdef STM32
-	#define RX_BUFFER_SIZE 254
+	#ifdef STM32F4
+		#define RX_BUFFER_SIZE 1024 // Lets a character counting sender queue more short lines ahead.
+	#else
+		#define RX_BUFFER_SIZE 254
+	#endif
 	#define TX_BUFFER_SIZE 128
 
 	void process_it_char(uint8_t data);
@@ -58,15 +62,15 @@ uint8_t serial_read();
 void serial_reset_read_buffer();
 
 // Returns the number of bytes available in the RX serial buffer.
-uint8_t serial_get_rx_buffer_available();
+uint16_t serial_get_rx_buffer_available();
 
 // Returns the number of bytes used in the RX serial buffer.
 // NOTE: Deprecated. Not used unless classic status reports are enabled in config.h.
-uint8_t serial_get_rx_buffer_count();
+uint16_t serial_get_rx_buffer_count();
 
 // Returns the number of bytes used in the TX serial buffer.
 // NOTE: Not used except for debugging and ensuring no TX bottlenecks.
-uint8_t serial_get_tx_buffer_count();
+uint16_t serial_get_tx_buffer_count();
 
 #ifdef STM32
 void HandleUartIT(uint8_t data);
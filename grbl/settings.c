@@ -92,6 +92,12 @@ void settings_restore(uint8_t restore_flag) {
 
     settings.analog_max = DEFAULT_ANALOG_MAX;
     settings.spindle_enable_pin_mode = DEFAULT_VARIABLE_SPINDLE_ENABLE_PIN;
+    #ifdef SEGMENT_BUFFER_ARENA
+      settings.segment_buffer_ms = DEFAULT_SEGMENT_BUFFER_MS;
+    #endif
+    #ifdef ENABLE_LINE_COALESCING
+      settings.coalesce_tolerance = DEFAULT_COALESCE_TOLERANCE;
+    #endif
 
     settings.flags = 0;
     if (DEFAULT_REPORT_INCHES) { settings.flags |= BITFLAG_REPORT_INCHES; }
@@ -147,6 +153,28 @@ void settings_restore(uint8_t restore_flag) {
       settings.max_travel[B_AXIS] = (-DEFAULT_B_MAX_TRAVEL);
       settings.max_travel[C_AXIS] = (-DEFAULT_C_MAX_TRAVEL);
     #endif
+    #ifdef S_CURVE_ACCELERATION
+      settings.jerk[X_AXIS] = DEFAULT_X_JERK;
+      settings.jerk[Y_AXIS] = DEFAULT_Y_JERK;
+      settings.jerk[Z_AXIS] = DEFAULT_Z_JERK;
+      #if (N_AXIS > 3)
+        settings.jerk[A_AXIS] = DEFAULT_A_JERK;
+      #endif
+      #if (N_AXIS > 4)
+        settings.jerk[B_AXIS] = DEFAULT_B_JERK;
+      #endif
+      #if (N_AXIS > 5)
+        settings.jerk[C_AXIS] = DEFAULT_C_JERK;
+      #endif
+    #endif
+    #ifdef INPUT_SHAPING
+      uint8_t idx;
+      for (idx=0; idx<N_AXIS; idx++) {
+        settings.shaper_type[idx] = DEFAULT_SHAPER_TYPE;
+        settings.shaper_frequency[idx] = DEFAULT_SHAPER_FREQUENCY;
+        settings.shaper_damping[idx] = DEFAULT_SHAPER_DAMPING;
+      }
+    #endif
 
     write_global_settings();
   }
@@ -274,6 +302,23 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
             break;
           case 2: settings.eeacceleration[parameter] = value*60*60; break; // Convert to mm/min^2 for grbl internal use.
           case 3: settings.max_travel[parameter] = -value; break;  // Store as negative for grbl internal use.
+          #ifdef S_CURVE_ACCELERATION
+            case 4: settings.jerk[parameter] = value*60*60*60; break; // Convert to mm/min^3 for grbl internal use.
+          #endif
+          #ifdef INPUT_SHAPING
+            case 5:
+              if (value > SHAPER_MZV) { return(STATUS_INVALID_STATEMENT); }
+              settings.shaper_type[parameter] = trunc(value);
+              st_update_shapers();
+              break;
+            case 6: settings.shaper_frequency[parameter] = value; st_update_shapers(); break;
+            case 7:
+              if (value >= 1.0) { return(STATUS_INVALID_STATEMENT); }
+              settings.shaper_damping[parameter] = value;
+              st_update_shapers();
+              break;
+          #endif
+          default: return(STATUS_INVALID_STATEMENT); // $14x without S_CURVE_ACCELERATION
         }
         break; // Exit while-loop after setting has been configured and proceed to the EEPROM write call.
       } else {
@@ -369,6 +414,17 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
         break;
       #endif
 
+      #ifdef SEGMENT_BUFFER_ARENA
+      case 60:
+        settings.segment_buffer_ms = int_value;
+        st_reset(); // Lay the segment buffer out again. It is empty while idle.
+        break;
+      #endif
+
+      #ifdef ENABLE_LINE_COALESCING
+      case 61: settings.coalesce_tolerance = value; break;
+      #endif
+
       default:
         return(STATUS_INVALID_STATEMENT);
     }
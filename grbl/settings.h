@@ -28,17 +28,19 @@
 
 // Version of the EEPROM data. Will be used to migrate existing data from older versions of Grbl
 // when firmware is upgraded. Always stored in byte 0 of eeprom
+// Raised by 4 from 13-10 when settings_t gained $60, $61 and $140-$175, so no axis count reuses an
+// older version.
 #if ( defined(STM32F1_3) || defined(STM32F4_3) )
-	#define SETTINGS_VERSION 13  // NOTE: Check settings_reset() when moving to next version.
+	#define SETTINGS_VERSION 17  // NOTE: Check settings_reset() when moving to next version.
 #endif
 #if ( defined(STM32F1_4) || defined(STM32F4_4) )
-	#define SETTINGS_VERSION 12
+	#define SETTINGS_VERSION 16
 #endif
 #if ( defined(STM32F1_5) || defined(STM32F4_5) )
-	#define SETTINGS_VERSION 11
+	#define SETTINGS_VERSION 15
 #endif
 #if ( defined(STM32F1_6) || defined(STM32F4_6) )
-	#define SETTINGS_VERSION 10
+	#define SETTINGS_VERSION 14
 #endif
 
 
@@ -84,10 +86,22 @@
 // #define SETTING_INDEX_G92    N_COORDINATE_SYSTEM+2  // Coordinate offset (G92.2,G92.3 not supported)
 
 // Define Grbl axis settings numbering scheme. Starts at START_VAL, every INCREMENT, over N_SETTINGS.
-#define AXIS_N_SETTINGS          4
+#if defined(INPUT_SHAPING)
+  #define AXIS_N_SETTINGS        8  // Adds the input shapers $150-$175, after the jerk settings
+#elif defined(S_CURVE_ACCELERATION)
+  #define AXIS_N_SETTINGS        5  // Adds the jerk settings $140-$145
+#else
+  #define AXIS_N_SETTINGS        4
+#endif
 #define AXIS_SETTINGS_START_VAL  100 // NOTE: Reserving settings values >= 100 for axis settings. Up to 255.
 #define AXIS_SETTINGS_INCREMENT  10  // Must be greater than the number of axis settings
 
+// Input shaper types of settings.shaper_type
+#define SHAPER_NONE  0
+#define SHAPER_ZV    1
+#define SHAPER_ZVD   2
+#define SHAPER_MZV   3
+
 // Global persistent settings (Stored from byte EEPROM_ADDR_GLOBAL onwards)
 typedef struct {
   // Axis settings
@@ -120,6 +134,21 @@ typedef struct {
   //-- GRBL32 Customs
   float analog_max;                 //-- $40
   uint8_t spindle_enable_pin_mode;  //-- $50  0: default behavior, nothing.  1: call set enable pin normal.  2: call set enable pin inverted
+  #ifdef SEGMENT_BUFFER_ARENA
+    uint8_t segment_buffer_ms;      //-- $60  motion time the segment buffer holds, in ms
+  #endif
+  #ifdef ENABLE_LINE_COALESCING
+    float coalesce_tolerance;       //-- $61  lines merged within this distance in mm, 0 to merge none
+  #endif
+
+  #ifdef S_CURVE_ACCELERATION
+    float jerk[N_AXIS];             //-- $140-$145 in mm/min^3, 0 for no limit
+  #endif
+  #ifdef INPUT_SHAPING
+    uint8_t shaper_type[N_AXIS];    //-- $150-$155 SHAPER_NONE, SHAPER_ZV, SHAPER_ZVD or SHAPER_MZV
+    float shaper_frequency[N_AXIS]; //-- $160-$165 in Hz
+    float shaper_damping[N_AXIS];   //-- $170-$175 damping ratio
+  #endif
 
 } settings_t;
 extern settings_t settings;
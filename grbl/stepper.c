@@ -42,24 +42,132 @@
 // timer, and the CPU overhead. Level 0 (no AMASS, normal operation) frequency bin starts at the
 // Level 1 cutoff frequency and up to as fast as the CPU allows (over 30kHz in limited testing).
 // NOTE: AMASS cutoff frequency multiplied by ISR overdrive factor must not exceed maximum step frequency.
-// NOTE: Current settings are set to overdrive the ISR to no more than 16kHz, balancing CPU overhead
-// and timer accuracy.  Do not alter these settings unless you know what you are doing.
+// NOTE: Grbl sets the cutoffs to overdrive the ISR to no more than 16kHz, balancing CPU overhead
+// and timer accuracy. With AMASS_ISR_LOAD, the overdriven ISR rate is instead bounded by its
+// share of the CPU, from the core clock and the cost of an ISR tick, over up to 6 levels.
+// NOTE: Step timing is counted in ticks of the step timer, which may run slower than the core.
+#ifndef STEP_TIMER_CLOCK
+  #define STEP_TIMER_CLOCK F_CPU
+#endif
 #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-	#define MAX_AMASS_LEVEL 3
-	// AMASS_LEVEL0: Normal operation. No AMASS. No upper cutoff frequency. Starts at LEVEL1 cutoff frequency.
-	#define AMASS_LEVEL1 (F_CPU/8000) // Over-drives ISR (x2). Defined as F_CPU/(Cutoff frequency in Hz)
-	#define AMASS_LEVEL2 (F_CPU/4000) // Over-drives ISR (x4)
-	#define AMASS_LEVEL3 (F_CPU/2000) // Over-drives ISR (x8)
-
-  #if MAX_AMASS_LEVEL <= 0
-    error "AMASS must have 1 or more levels to operate correctly."
+  #ifndef MAX_AMASS_LEVEL
+    #ifdef AMASS_ISR_LOAD
+      #define MAX_AMASS_LEVEL 5
+    #else
+      #define MAX_AMASS_LEVEL 3
+    #endif
+  #endif
+  // AMASS_LEVEL0: Normal operation. No AMASS. No upper cutoff frequency. Starts at LEVEL1 cutoff.
+  // Level n starts at (AMASS_ISR_TICKS << n) step timer ticks per step, where the ISR overdriven
+  // 2^n times still ticks no faster than every AMASS_ISR_TICKS.
+  #ifdef AMASS_ISR_LOAD
+    #ifndef STEP_ISR_CYCLES
+      #define STEP_ISR_CYCLES 500
+    #endif
+    // STEP_ISR_CYCLES of CPU per tick take AMASS_ISR_LOAD percent of the core clock.
+    #define AMASS_ISR_TICKS ((uint32_t)(((uint64_t)STEP_ISR_CYCLES*100*STEP_TIMER_CLOCK)/((uint64_t)AMASS_ISR_LOAD*F_CPU)))
+  #else
+    #define AMASS_ISR_TICKS (STEP_TIMER_CLOCK/16000) // 16kHz
+  #endif
+
+  #if (MAX_AMASS_LEVEL < 0) || (MAX_AMASS_LEVEL > 6)
+    #error "MAX_AMASS_LEVEL must be 0 to 6. Block step counts are scaled by 2^MAX_AMASS_LEVEL."
+  #endif
+#endif
+
+#if defined(SEGMENT_BUFFER_ARENA) || defined(ADAPTIVE_SEGMENT_DURATION)
+  #define ST_BUFFER_TIMING // Segments record the motion time queued up to their end.
+#endif
+
+#ifdef ADAPTIVE_SEGMENT_DURATION
+  // Cruise segments last up to a quarter of the buffer time, ST_BUFFER_TIME, and no more steps
+  // than n_step holds at the top AMASS level.
+  #define ST_CRUISE_SEGMENT_TIME (ST_BUFFER_TIME/4)
+  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    #define ST_SEGMENT_MAX_STEPS (0xffff >> MAX_AMASS_LEVEL)
+  #else
+    #define ST_SEGMENT_MAX_STEPS 0xffff
+  #endif
+#endif
+
+// Per-axis loops in the stepper ISR are fully unrolled, so the Bresenham table costs no loop
+// overhead over one hand-written block per axis. GCC before 8 has no unroll pragma.
+#if defined(__GNUC__) && (__GNUC__ >= 8)
+  #define ST_PRAGMA_(x) _Pragma(#x)
+  #define ST_PRAGMA(x) ST_PRAGMA_(x)
+  #define ST_UNROLL_AXES ST_PRAGMA(GCC unroll N_AXIS)
+#else
+  #define ST_UNROLL_AXES
+#endif
+
+// Step timer period register width. A 32-bit timer reaches any feed rate without a prescaler
+// or the clamp to the slowest 16-bit period.
+#ifdef STEP_TIMER_32BIT
+  #ifndef STM32F4
+    #error "STEP_TIMER_32BIT needs the 32-bit TIM5 step timer of the F4. See config.h."
+  #endif
+  typedef uint32_t st_cycles_t;
+  #define ST_CYCLES_MAX 0xffffffff
+#else
+  typedef uint16_t st_cycles_t;
+  #define ST_CYCLES_MAX 0xffff
+#endif
+
+// Ramps traced in time by st_ramp_start() instead of at constant acceleration.
+#if defined(S_CURVE_ACCELERATION) || defined(INPUT_SHAPING)
+  #define ST_RAMP_SHAPING
+  #ifdef ST_PREP_FIXED_POINT
+    #error "S_CURVE_ACCELERATION and INPUT_SHAPING shape ramps in the float segment generator. Define ST_PREP_FLOAT."
+  #endif
+#endif
+
+#ifdef INPUT_SHAPING
+  #define SHAPER_AXIS_IMPULSES 3   // ZVD and MZV
+  #define SHAPER_MAX_IMPULSES  27  // Three different shapers combined in one block
+
+  // Impulses of an axis shaper, starting at time 0 and adding up to 1.
+  typedef struct {
+    uint8_t count;  // 0 when the axis is not shaped
+    float amplitude[SHAPER_AXIS_IMPULSES];
+    float time[SHAPER_AXIS_IMPULSES]; // (min)
+    float centroid; // Amplitude weighted mean impulse time (min)
+  } st_shaper_t;
+  static st_shaper_t axis_shaper[N_AXIS];
+#endif
+
+#ifdef STM32
+  // STEP_PULSE_DELAY, in microseconds, is the AVR name of the direction setup time.
+  #if defined(STEP_PULSE_DELAY) && !defined(STEP_DIR_SETUP_NS)
+    #define STEP_DIR_SETUP_NS (STEP_PULSE_DELAY*1000)
+  #endif
+  #if defined(STEP_DIR_SETUP_NS) && !defined(STEP_PULSE_ONE_SHOT)
+    #error "The direction setup time is timed by STEP_PULSE_ONE_SHOT. See config.h."
+  #endif
+  #if defined(STEP_PULSE_ONE_SHOT) && !defined(STEP_PULSE_SET_CHANNEL)
+    #error "STEP_PULSE_ONE_SHOT is not available on this board. See config.h."
   #endif
+  #ifndef STEP_DIR_SETUP_NS
+    #define STEP_DIR_SETUP_NS 0
+  #endif
+#endif
+
+#ifdef STEP_PULSE_DMA
+  #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    #error "STEP_PULSE_DMA requires AMASS. The DMA stream reloads ARR only, not the prescaler."
+  #endif
+  #ifndef STEP_DMA
+    #error "STEP_PULSE_DMA is not available on this board. See config.h."
+  #endif
+  #define STEP_DMA_BUFFER_SIZE 128  // Entries in the circular DMA buffer. Refilled one half at a time.
+  #define STEP_DMA_STAGE STEP_DMA_BUFFER_SIZE // Extra entry for the first interval, loaded by st_wake_up().
+  #define STEP_DMA_NONE 0xffff
+  #define STEP_DMA_MIN_TICKS 48     // Shortest interval. Leaves time for both DMA writes after an update.
 #endif
 
 
 // Stores the planner block Bresenham algorithm execution data for the segments in the segment
 // buffer. Normally, this buffer is partially in-use, but, for the worst case scenario, it will
-// never exceed the number of accessible stepper buffer segments (SEGMENT_BUFFER_SIZE-1).
+// never exceed the number of accessible stepper buffer segments (segment_buffer_size-1).
 // NOTE: This data is copied from the prepped planner blocks so that the planner blocks may be
 // discarded when entirely consumed and completed by the segment buffer. Also, AMASS alters this
 // data for its own use.
@@ -71,7 +179,6 @@ typedef struct {
 		uint8_t is_pwm_rate_adjusted; // Tracks motions that require constant laser power/rate
 	#endif
 } st_block_t;
-static st_block_t st_block_buffer[SEGMENT_BUFFER_SIZE-1];
 
 // Primary stepper segment ring buffer. Contains small, short line segments for the stepper
 // algorithm to execute, which are "checked-out" incrementally from the first block in the
@@ -79,7 +186,7 @@ static st_block_t st_block_buffer[SEGMENT_BUFFER_SIZE-1];
 // the planner, where the remaining planner block steps still can.
 typedef struct {
   uint16_t n_step;           // Number of step events to be executed for this segment
-  uint16_t cycles_per_tick;  // Step distance traveled per ISR tick, aka step rate.
+  st_cycles_t cycles_per_tick; // Step distance traveled per ISR tick, aka step rate.
   uint8_t  st_block_index;   // Stepper block data index. Uses this information to execute this segment.
   #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
     uint8_t amass_level;    // Indicates AMASS level for the ISR to execute this segment
@@ -89,20 +196,47 @@ typedef struct {
   #ifdef VARIABLE_SPINDLE
     SPINDLE_PWM_TYPE spindle_pwm;
   #endif
+  #ifdef ST_BUFFER_TIMING
+    uint32_t end_time;       // prep.buffer_time at the end of this segment. Not used by the ISR.
+    #ifdef STEP_PULSE_DMA
+      uint32_t end_tick;     // prep.buffer_ticks at the end of this segment
+    #endif
+  #endif
 } segment_t;
-static segment_t segment_buffer[SEGMENT_BUFFER_SIZE];
+
+#ifdef SEGMENT_BUFFER_ARENA
+  // Both buffers are laid out in the arena by st_buffer_layout(), sized from the buffer depth
+  // setting, $60, on every reset. The segment buffer holds the depth in DT_SEGMENT segments
+  // after the executing one, plus the executing one and the entry the ring keeps free.
+  static uint32_t st_buffer_arena[SEGMENT_BUFFER_ARENA_SIZE/sizeof(uint32_t)] ST_CCM_RAM;
+  static st_block_t *st_block_buffer;   // segment_buffer_size-1 entries
+  static segment_t *segment_buffer;
+  static uint8_t segment_buffer_size;
+  static uint32_t segment_buffer_depth; // Motion time after the executing segment (ticks)
+  #define ST_BUFFER_TIME segment_buffer_depth
+#else
+  static st_block_t st_block_buffer[SEGMENT_BUFFER_SIZE-1] ST_CCM_RAM;
+  static segment_t segment_buffer[SEGMENT_BUFFER_SIZE] ST_CCM_RAM;
+  static const uint8_t segment_buffer_size = SEGMENT_BUFFER_SIZE;
+  // Motion time the SEGMENT_BUFFER_SIZE-1 segments of DT_SEGMENT hold (ticks)
+  #define ST_BUFFER_TIME ((uint32_t)(SEGMENT_BUFFER_SIZE-1)*(STEP_TIMER_CLOCK/ACCELERATION_TICKS_PER_SECOND))
+#endif
 
 // Stepper ISR data struct. Contains the running data for the main stepper ISR.
 
 typedef struct {
   // Used by the bresenham line algorithm
-  uint32_t counter_x,        // Counter variables for the bresenham line tracer
-           counter_y,
-           counter_z,
-           counter_a,
-           counter_b,
-           counter_c;
-  #ifdef STEP_PULSE_DELAY
+  uint32_t counter[N_AXIS]; // Counter variables for the bresenham line tracer
+  int8_t position_step[N_AXIS]; // sys_position change per step, from the block direction bits
+
+  // Position accounting. A run starts whenever the counters are initialized for a block. The ISR
+  // only sums its segment ticks, and the steps are folded into sys_position when the run ends.
+  // The block data is copied, since its st_block_buffer entry may be reused before that.
+  uint32_t run_ticks;            // Ticks of the run's completed segments, at the top AMASS level
+  uint32_t run_event_count;      // Block step_event_count, zero before the first run
+  uint32_t run_steps[N_AXIS];    // Block axis steps, without the AMASS scaling
+  int32_t run_folded[N_AXIS];    // Steps of the run already folded into sys_position
+  #if defined(STEP_PULSE_DELAY) && defined(ATMEGA328P)
     uint8_t step_bits;  // Stores out_bits output to complete the step pulse delay
   #endif
 
@@ -110,6 +244,13 @@ typedef struct {
   uint8_t step_pulse_time;  // Step pulse reset time after step rise
   PIN_MASK step_outbits;         // The next stepping-bits to be output
   PIN_MASK dir_outbits;
+  #ifdef STM32
+    uint32_t step_bsrr;     // step_outbits, inverted, as a step port BSRR word
+    uint32_t dir_bsrr;      // dir_outbits as a direction port BSRR word
+  #endif
+  #ifdef STEP_PULSE_ONE_SHOT
+    uint32_t pulse_bsrr;    // step_bsrr of the pulse in flight, read by the one-shot DMA
+  #endif
   #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
     uint32_t steps[N_AXIS];
   #endif
@@ -119,7 +260,19 @@ typedef struct {
   st_block_t *exec_block;   // Pointer to the block data for the segment being executed
   segment_t *exec_segment;  // Pointer to the segment being executed
 } stepper_t;
-static stepper_t st;
+#ifdef STEP_PULSE_ONE_SHOT
+  static stepper_t st; // st.pulse_bsrr is read by DMA
+#else
+  static stepper_t st ST_CCM_RAM;
+#endif
+
+#ifdef STM32
+  static void st_fold_run_position();
+#endif
+
+#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+  static uint32_t amass_isr_ticks; // AMASS_ISR_TICKS, set by stepper_init() once the clock is known
+#endif
 
 // Step segment ring buffer indices
 static volatile uint8_t segment_buffer_tail;
@@ -129,6 +282,9 @@ static uint8_t segment_next_head;
 // Step and direction port invert masks.
 static PIN_MASK step_port_invert_mask;
 static PIN_MASK dir_port_invert_mask;
+#ifdef STM32
+  static uint32_t step_port_idle_bsrr; // BSRR word returning every step pin to idle
+#endif
 
 // Used to avoid ISR nesting of the "Stepper Driver Interrupt". Should never occur though.
 static volatile uint8_t busy;
@@ -138,13 +294,56 @@ static volatile uint8_t busy;
 static plan_block_t *pl_block;     // Pointer to the planner block being prepped
 static st_block_t *st_prep_block;  // Pointer to the stepper block data being prepped
 
+#ifdef PLANNER_ARC_BLOCKS
+// Point of an arc block, relative to the arc start.
+typedef struct {
+  float r[2];              // Radius vector along the plane axes (mm)
+  float theta;             // Its angle from the start radius vector (rad)
+  uint8_t count;           // Rotations by small angle approximation since the last exact one
+  float point[N_AXIS];     // Position (steps)
+  int32_t steps[N_AXIS];   // Position rounded to whole steps
+} st_arc_point_t;
+#endif
+
 // Segment preparation data struct. Contains all the necessary information to compute new segments
 // based on the current executing planner block.
 typedef struct {
   uint8_t st_block_index;  // Index of stepper common data block being prepped
   uint8_t recalculate_flag;
 
+#ifdef ST_PREP_FIXED_POINT
+  // Fixed-point segment generator. Distances are in Q32.32 steps of the block step_event_count
+  // and times in step timer ticks. See the units below the struct.
+  uint32_t dt_remainder;   // (ticks)
+  uint32_t dt_excess;      // Time queued segments step over their profile time, from rounding their
+                           // step timing up. Taken back from the next segments, across blocks. (ticks)
+  uint32_t steps_remaining;
+  float step_per_mm;
+  uint64_t steps_to_go;    // Distance left in the block at the end of the segment buffer. Exact
+                           // version of pl_block->millimeters, which is kept in sync for the planner.
+
+  #ifdef PARKING_ENABLE
+    uint8_t last_st_block_index;
+    uint32_t last_steps_remaining;
+    float last_step_per_mm;
+    uint32_t last_dt_remainder;
+    uint32_t last_dt_excess;
+    uint64_t last_steps_to_go;
+  #endif
+
+  uint8_t ramp_type;         // Current segment ramp state
+  uint64_t mm_complete;      // End of velocity profile from end of current planner block (Q32.32 steps)
+  uint32_t current_speed;    // Current speed at the end of the segment buffer (Q.40 steps/tick)
+  uint32_t maximum_speed;    // Maximum speed of executing block. Not always nominal speed.
+  uint32_t exit_speed;       // Exit speed of executing block
+  uint64_t accelerate_until; // Acceleration ramp end measured from end of block (Q32.32 steps)
+  uint64_t decelerate_after; // Deceleration ramp start measured from end of block
+  uint32_t acceleration;     // Block acceleration (Q.60 steps/tick^2)
+  float speed_scale;         // Converts mm/min to Q.40 steps/tick for the prepped block
+#else
   float dt_remainder;
+  float dt_excess;        // Time queued segments step over their profile time, from rounding their
+                          // step timing up. Taken back from the next segments, across blocks. (min)
   float steps_remaining;
   float step_per_mm;
   float req_mm_increment;
@@ -154,6 +353,7 @@ typedef struct {
     float last_steps_remaining;
     float last_step_per_mm;
     float last_dt_remainder;
+    float last_dt_excess;
   #endif
 
   uint8_t ramp_type;      // Current segment ramp state
@@ -165,6 +365,53 @@ typedef struct {
   float accelerate_until; // Acceleration ramp end measured from end of block (mm)
   float decelerate_after; // Deceleration ramp start measured from end of block (mm)
 
+  #ifdef ST_RAMP_SHAPING
+    // Shaped ramp in progress, traced in time from its start. See st_ramp_start().
+    uint8_t ramp_shaped;       // Ramp type being shaped, for replans that leave it unchanged
+    float ramp_time;           // Time into the ramp (min)
+    float ramp_duration;       // Duration of the planner's constant acceleration ramp (min)
+    float ramp_base;           // Duration of the ramp before input shaping (min)
+    float ramp_entry_speed;    // (mm/min)
+    float ramp_exit_speed;     // (mm/min)
+    float ramp_delta;          // Speed change, negative when decelerating (mm/min)
+    float ramp_accel;          // Peak acceleration, same sign as ramp_delta (mm/min^2)
+    float ramp_jerk_time;      // Duration of each jerk phase at the ends of the ramp (min)
+    float ramp_end;            // Ramp end measured from end of block (mm)
+  #endif
+  #ifdef INPUT_SHAPING
+    uint8_t ramp_impulses;     // Impulses of the shaper applied to the ramp, 0 when unshaped
+    // Shaper combined from the shaped axes moving in the block. See st_shaper_load().
+    uint8_t shaper_axes;       // Axes combined, as a bit mask
+    uint8_t shaper_count;
+    float shaper_amplitude[SHAPER_MAX_IMPULSES];
+    float shaper_time[SHAPER_MAX_IMPULSES];  // (min)
+    float shaper_duration;     // Time of the last impulse (min)
+    float shaper_centroid;     // Amplitude weighted mean impulse time (min)
+  #endif
+#endif
+
+  #ifdef PLANNER_ARC_BLOCKS
+    // Arc block being traced. See st_arc_chord().
+    plan_arc_t *arc;            // Geometry of the last arc block loaded
+    st_arc_point_t arc_point;   // End of the last segment
+    st_arc_point_t arc_next;    // End of the segment being prepped
+    uint8_t arc_block_used;     // The stepper block at st_block_index steps a chord already
+    #ifdef ST_PREP_FIXED_POINT
+      uint64_t arc_chord;       // Longest segment, the chord within $12 (Q32.32 steps)
+    #else
+      float arc_chord;          // (mm)
+    #endif
+  #endif
+
+  #ifdef ST_BUFFER_TIMING
+    // End of the last segment prepped, in step timer ticks counted since reset and wrapping.
+    // Segment end_time is the same at the end of each segment in the buffer.
+    uint32_t buffer_time;
+    #ifdef STEP_PULSE_DMA
+      uint32_t buffer_ticks; // Same in ISR ticks, which a DMA buffer refill takes all at once.
+    #endif
+  #endif
+
   #ifdef VARIABLE_SPINDLE
     float inv_rate;    // Used by PWM laser mode to speed up segment calculations.
     SPINDLE_PWM_TYPE current_spindle_pwm;
@@ -172,6 +419,112 @@ typedef struct {
 } st_prep_t;
 static st_prep_t prep;
 
+#ifdef ST_PREP_FIXED_POINT
+  /* Fixed-point units. The Cortex-M3 of the F1 boards has no FPU, so every float operation of the
+     segment generator is a library call. Instead, the velocity profile is traced in the block's
+     own units, steps along the dominant axis and step timer ticks, where a whole step is an integer
+     and the step count of a segment needs no conversion or rounding.
+       distance  uint64_t  Q32.32 steps
+       time      uint32_t  ticks of the step timer, STEP_TIMER_CLOCK
+       speed     uint32_t  Q.40 steps/tick, saturating at 1/256 step/tick (281kHz at 72MHz)
+       speed^2   uint64_t  Q.80
+       accel     uint32_t  Q.60 steps/tick^2, saturating at 1.9e7 steps/s^2 at 72MHz
+     The planner stays in floats. Its speeds are converted when a block profile is computed, and
+     pl_block->millimeters is written back once per segment.
+  */
+  #define ST_FX_SPEED_ONE   1099511627776.0f  // 2^40
+  #define ST_FX_ACCEL_ONE   1152921504606846976.0f  // 2^60
+  #define ST_FX_STEP        ((uint64_t)1 << 32)
+  #define ST_FX_REQ_INCREMENT ((uint64_t)(REQ_MM_INCREMENT_SCALAR*ST_FX_STEP)) // Guarantees at least one step
+#endif
+
+// Current speed at the end of the segment buffer in mm/min.
+static float st_prep_current_speed()
+{
+  #ifdef ST_PREP_FIXED_POINT
+    if (prep.speed_scale == 0.0f) { return(0.0f); }
+    return(prep.current_speed/prep.speed_scale);
+  #else
+    return(prep.current_speed);
+  #endif
+}
+
+#ifdef ADAPTIVE_SEGMENT_DURATION
+// True once the segment buffer holds ST_BUFFER_TIME of motion after the segment the ISR is
+// executing, which is left out since how much of it is left is not known here. With the DMA step
+// engine, also half a DMA buffer of ticks, since a refill consumes them at once.
+static uint8_t st_buffer_time_full()
+{
+  uint8_t tail = segment_buffer_tail;
+  if (tail == segment_buffer_head) { return(false); }
+  #ifdef STEP_PULSE_DMA
+    if (prep.buffer_ticks - segment_buffer[tail].end_tick < STEP_DMA_BUFFER_SIZE/2) { return(false); }
+  #endif
+  return(prep.buffer_time - segment_buffer[tail].end_time >= ST_BUFFER_TIME);
+}
+
+// Duration of a segment starting in cruise. Speed is constant, so one long segment steps exactly
+// like many short ones and costs the generator one iteration.
+#ifdef ST_PREP_FIXED_POINT
+static uint32_t st_cruise_segment_time() // (ticks)
+{
+  uint32_t time = ST_CRUISE_SEGMENT_TIME;
+  if (prep.maximum_speed) {
+    uint64_t step_time = ((uint64_t)ST_SEGMENT_MAX_STEPS << 40)/prep.maximum_speed;
+    if (step_time < time) { time = (uint32_t)step_time; }
+  }
+  return(time);
+}
+#else
+static float st_cruise_segment_time() // (min)
+{
+  float time = ST_CRUISE_SEGMENT_TIME/fTICKS_PER_MINUTE;
+  float step_rate = prep.maximum_speed*prep.step_per_mm; // (step/min)
+  if (step_rate*time > ST_SEGMENT_MAX_STEPS) { time = ST_SEGMENT_MAX_STEPS/step_rate; }
+  return(time);
+}
+#endif
+#endif
+
+#ifdef ENABLE_PREP_PROFILE
+  static st_prep_profile_t prep_profile;
+  static uint8_t prep_profile_stepping; // Set from st_wake_up() to st_go_idle().
+  #ifdef SEGMENT_BUFFER_ARENA
+    // Motion time queued after the executing segment at each st_prep_buffer() call while stepping
+    static uint32_t prep_profile_time_low;     // (ticks)
+    static uint64_t prep_profile_time_sum;     // (ticks)
+    static uint32_t prep_profile_time_samples;
+  #endif
+#endif
+
+#ifdef ENABLE_STEP_ISR_PROFILE
+  static st_isr_profile_t isr_profile;
+#endif
+
+#ifdef STEP_PULSE_DMA
+  // DMA step engine data. Entry n is written by the n-th step timer update: bsrr[n] to the
+  // step/direction port and arr[n] to the timer, which times the interval to the next update.
+  typedef struct {
+    uint32_t bsrr[STEP_DMA_BUFFER_SIZE+1];
+    uint16_t arr[STEP_DMA_BUFFER_SIZE+1];
+    uint32_t owed_word[2];    // Entries generated by the last tick that are still to be stored
+    uint32_t owed_ticks[2];
+    uint8_t owed_count;
+    PIN_MASK step_bits;       // Step bits of the last tick, output at the start of the next one
+    PIN_MASK step_dir;        // Direction output bits for those steps
+    uint16_t last;            // Last stored entry without a step edge, if it is not in flight yet
+    uint16_t last_motion;     // Last stored entry that is not padding
+    uint8_t end;              // Segment buffer ran dry. Only padding follows.
+    uint8_t end_half;         // Buffer half holding the last motion entry, 0xff until known
+    uint8_t finished;         // Stopped by the engine itself, every motion entry was output
+    uint8_t active;           // This cycle is stepped by DMA rather than the stepper ISR
+  } st_dma_t;
+  static st_dma_t st_dma;
+
+  static void st_dma_start();
+  static void st_dma_stop();
+#endif
+
 
 /*    BLOCK VELOCITY PROFILE DEFINITION
           __________________________
@@ -228,9 +581,12 @@ void st_wake_up()
 
   // Initialize stepper output bits to ensure first ISR call does not step.
   st.step_outbits = step_port_invert_mask;
+  #ifdef STM32
+    st.step_bsrr = step_port_idle_bsrr;
+  #endif
 
   // Initialize step pulse timing from settings. Here to ensure updating after re-writing.
-  #ifdef STEP_PULSE_DELAY
+  #if defined(STEP_PULSE_DELAY) && defined(ATMEGA328P)
     // Set total step pulse time after direction pin set. Ad hoc computation from oscilloscope.
     st.step_pulse_time = -(((settings.pulse_microseconds+STEP_PULSE_DELAY-2)*TICKS_PER_MICROSECOND) >> 3);
     // Set delay between direction pin write and step command.
@@ -253,17 +609,44 @@ void st_wake_up()
 
   // Enable Stepper Driver Interrupt
   #ifdef STM32
-		LL_TIM_SetAutoReload(STEP_RESET_TIMER, st.step_pulse_time - 1);
-		LL_TIM_GenerateEvent_UPDATE(STEP_RESET_TIMER);
-		LL_TIM_ClearFlag_UPDATE(STEP_RESET_TIMER);
+		#ifdef STEP_PULSE_DMA
+			// Homing and probing check their switches every step, so they keep using the stepper ISR.
+			st_dma.active = ((sys.state != STATE_HOMING) && (sys_probe_state != PROBE_ACTIVE));
+			if (st_dma.active) {
+				#ifdef ENABLE_PREP_PROFILE
+					prep_profile_stepping = true;
+				#endif
+				st_dma_start();
+				return;
+			}
+		#endif
+		#ifdef STEP_PULSE_ONE_SHOT
+			// Rounded up: the setup time is a minimum. The pulse is timed in full, not in uint8_t.
+			Step_Pulse_Timing((STEP_DIR_SETUP_NS*uTICKS_PER_MICROSECOND+999)/1000,
+			                  settings.fpulse_microseconds*uTICKS_PER_MICROSECOND);
+		#else
+			LL_TIM_SetAutoReload(STEP_RESET_TIMER, st.step_pulse_time - 1);
+			LL_TIM_GenerateEvent_UPDATE(STEP_RESET_TIMER);
+			LL_TIM_ClearFlag_UPDATE(STEP_RESET_TIMER);
+		#endif
 
+		// Time the first tick from the segment the ISR is about to load. exec_segment is NULL
+		// after the buffer ran dry and must not be dereferenced.
+		segment_t *first_segment = st.exec_segment;
+		if (first_segment == NULL) { first_segment = &segment_buffer[segment_buffer_tail]; }
+		// The step timer free-runs with ARR preloaded, see HandleStepSetIT(). The update event
+		// loads the first period and restarts the counter.
+		LL_TIM_EnableARRPreload(STEP_SET_TIMER);
 		//TIM4->ARR = st.exec_segment->cycles_per_tick - 1;
-		LL_TIM_SetAutoReload(STEP_SET_TIMER,st.exec_segment->cycles_per_tick - 1);
+		LL_TIM_SetAutoReload(STEP_SET_TIMER,first_segment->cycles_per_tick - 1);
 		// Set the Autoreload value
 		#ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-			LL_TIM_SetPrescaler(STEP_SET_TIMER,st.exec_segment->prescaler);
+			LL_TIM_SetPrescaler(STEP_SET_TIMER,first_segment->prescaler);
 		#endif
 		LL_TIM_GenerateEvent_UPDATE(STEP_SET_TIMER);
+		#ifdef ENABLE_PREP_PROFILE
+			prep_profile_stepping = true;
+		#endif
 		NVIC_EnableIRQ(STEP_SET_IRQ);
 
 
@@ -279,11 +662,18 @@ void st_go_idle()
   // Disable Stepper Driver Interrupt. Allow Stepper Port Reset Interrupt to finish, if active.
 #ifdef STM32
 	Step_Set_DisableIRQ();
+	#ifdef STEP_PULSE_DMA
+		if (st_dma.active) { st_dma_stop(); }
+	#endif
+	st_fold_run_position();
 #elif ATMEGA328P
   TIMSK1 &= ~(1<<OCIE1A); // Disable Timer1 interrupt
   TCCR1B = (TCCR1B & ~((1<<CS12) | (1<<CS11))) | (1<<CS10); // Reset clock to no prescaling.
 #endif
   busy = false;
+  #ifdef ENABLE_PREP_PROFILE
+    prep_profile_stepping = false;
+  #endif
 
   // Set stepper driver idle state, disabled or enabled, depending on settings and circumstances.
   bool pin_state = false; // Keep enabled.
@@ -347,101 +737,263 @@ void st_go_idle()
 
    NOTE: This interrupt must be as efficient as possible and complete before the next ISR tick,
    which for Grbl must be less than 33.3usec (@30kHz ISR rate). Oscilloscope measured time in
-   ISR is 5usec typical and 25usec maximum, well below requirement.
+   ISR is 5usec typical and 25usec maximum, well below requirement. On Grbl32 the ISR time is
+   measured in CPU cycles with ENABLE_STEP_ISR_PROFILE and reported in the status report.
    NOTE: This ISR expects at least one step to be executed per segment.
+   NOTE: On Grbl32 the step timer free-runs from update to update and ARR is preloaded, so a
+   tick lasts exactly its segment's period however late the ISR is entered. The ISR programs
+   the period of the tick after the one starting: a segment's rate is preloaded by the last
+   tick of the segment before it.
 */
-// TODO: Replace direct updating of the int32 position counters in the ISR somehow. Perhaps use smaller
-// int8 variables and update position counters only when a segment completes. This can get complicated
-// with probing and homing cycles that require true real-time positions.
 
 #ifdef STM32
-void HandleStepSetIT(void)
+// BSRR word driving the pins in mask to the given levels. One store updates them atomically,
+// without reading back the port other code may be changing.
+static inline uint32_t st_port_word(PIN_MASK levels, PIN_MASK mask)
 {
-  if (busy) { return; } // The busy-flag is used to avoid reentering this interrupt
+  return((levels & mask) | ((uint32_t)(~levels & mask) << 16));
+}
 
-  // Set the direction pins a couple of nanoseconds before we step the steppers
-  GPIO_Write(DIR_GPIO_Port, (GPIO_ReadOutputData(DIR_GPIO_Port) & ~DIR_MASK) | (st.dir_outbits & DIR_MASK));
-  //Step_Reset_IT_Clear(TIM_IT_UPDATE);
-	//HAL_TIM_CLEAR_IT(STEP_SET_TIMER, TIM_IT_UPDATE);
-  //TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
-  LL_TIM_ClearFlag_UPDATE(STEP_RESET_TIMER);
+// Ticks of a segment, weighted so that a run's total equals the block step_event_count.
+#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+  #define ST_SEGMENT_TICKS(segment, n)  ((uint32_t)(n) << (MAX_AMASS_LEVEL - (segment)->amass_level))
+  #define ST_BLOCK_AXIS_STEPS(block, idx)  ((block)->steps[idx] >> MAX_AMASS_LEVEL)
+#else
+  #define ST_SEGMENT_TICKS(segment, n)  ((uint32_t)(n))
+  #define ST_BLOCK_AXIS_STEPS(block, idx)  ((block)->steps[idx])
+#endif
 
+// Steps an axis has taken in a run of the given ticks, recovered from its Bresenham counter. Each
+// tick adds the axis steps to the counter and each step takes step_event_count back out, so
+//   counter = step_event_count/2 + steps*ticks - step_event_count*taken
+static int32_t st_run_axis_steps(uint32_t step_event_count, uint32_t steps, uint32_t ticks, uint32_t counter)
+{
+  if ((ticks == step_event_count) && (counter == (step_event_count >> 1))) { return(steps); } // Run completed the block
+  return((((uint64_t)steps*ticks) + (step_event_count >> 1) - counter)/step_event_count);
+}
 
-  // Then pulse the stepping pins
-  #ifdef STEP_PULSE_DELAY
-    st.step_bits = (STEP_PORT & ~STEP_MASK) | st.step_outbits; // Store out_bits to prevent overwriting.
-  #else  // Normal operation
-    GPIO_Write(STEP_GPIO_Port, (GPIO_ReadOutputData(STEP_GPIO_Port) & ~STEP_MASK) | st.step_outbits);
+// Ticks executed by the current run so far.
+static inline uint32_t st_run_ticks()
+{
+  if (st.exec_segment == NULL) { return(st.run_ticks); }
+  return(st.run_ticks + ST_SEGMENT_TICKS(st.exec_segment, st.exec_segment->n_step - st.step_count));
+}
+
+// Adds the steps of the current run not yet accounted for to sys_position. Called by the stepper
+// ISR when a new run starts and by st_go_idle(), so sys_position is exact whenever the ISR is off.
+static void st_fold_run_position()
+{
+  if (st.run_event_count == 0) { return; }
+  uint32_t ticks = st_run_ticks();
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    int32_t taken = st_run_axis_steps(st.run_event_count, st.run_steps[idx], ticks, st.counter[idx]);
+    sys_position[idx] += st.position_step[idx]*(taken - st.run_folded[idx]);
+    st.run_folded[idx] = taken;
+  }
+}
+
+// Copies the real-time machine position in steps. The ISR does not update sys_position per step,
+// so the steps of the current run are recovered from a snapshot of the Bresenham counters. Exact
+// at any tick, which probing relies on.
+void st_get_position(int32_t *position)
+{
+  uint32_t counter[N_AXIS];
+  uint32_t steps[N_AXIS];
+  int32_t folded[N_AXIS];
+  int8_t position_step[N_AXIS];
+  // Also called from the step ISR by the probe monitor. Restore the interrupt mask as it was.
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint32_t step_event_count = st.run_event_count;
+  uint32_t ticks = st_run_ticks();
+  memcpy(position, sys_position, sizeof(sys_position));
+  memcpy(counter, st.counter, sizeof(counter));
+  memcpy(steps, st.run_steps, sizeof(steps));
+  memcpy(folded, st.run_folded, sizeof(folded));
+  memcpy(position_step, st.position_step, sizeof(position_step));
+  __set_PRIMASK(primask);
+  if (step_event_count == 0) { return; }
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    position[idx] += position_step[idx]*(st_run_axis_steps(step_event_count, steps[idx], ticks, counter[idx]) - folded[idx]);
+  }
+}
+
+// Loads the next step segment into the stepper data and, when it starts a new planner block, the
+// block's Bresenham data. Returns false when the segment buffer is empty.
+// NOTE: Does not touch the step timer. The caller programs the segment timing.
+static inline uint8_t st_load_segment()
+{
+  // Anything in the buffer? If so, load and initialize next step segment.
+  if (segment_buffer_head == segment_buffer_tail) { return(false); }
+
+  // If the new segment starts a new planner block, account for the steps of the previous run while
+  // no segment is loaded, then initialize stepper variables and counters.
+  // NOTE: When the segment data index changes, this indicates a new planner block.
+  uint8_t new_run = (st.exec_block_index != segment_buffer[segment_buffer_tail].st_block_index);
+  if (new_run) { st_fold_run_position(); }
+
+  // Initialize new step segment and load number of steps to execute
+  st.exec_segment = &segment_buffer[segment_buffer_tail];
+
+  st.step_count = st.exec_segment->n_step; // NOTE: Can sometimes be zero when moving slow.
+  if (new_run) {
+    st.exec_block_index = st.exec_segment->st_block_index;
+    st.exec_block = &st_block_buffer[st.exec_block_index];
+    st.run_ticks = 0;
+    st.run_event_count = st.exec_block->step_event_count;
+
+    // Initialize Bresenham line and distance counters
+    uint8_t idx;
+    for (idx=0; idx<N_AXIS; idx++) {
+      st.run_steps[idx] = ST_BLOCK_AXIS_STEPS(st.exec_block, idx);
+      st.run_folded[idx] = 0;
+      st.counter[idx] = st.exec_block->step_event_count >> 1;
+      st.position_step[idx] = (st.exec_block->direction_bits & direction_pin_mask[idx]) ? -1 : 1;
+    }
+  }
+  st.dir_outbits = st.exec_block->direction_bits ^ dir_port_invert_mask;
+  st.dir_bsrr = st_port_word(st.dir_outbits, DIR_MASK);
+
+  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    // With AMASS enabled, adjust Bresenham axis increment counters according to AMASS level.
+    uint8_t idx;
+    for (idx=0; idx<N_AXIS; idx++) { st.steps[idx] = st.exec_block->steps[idx] >> st.exec_segment->amass_level; }
   #endif
 
-  // Enable step pulse reset timer so that The Stepper Port Reset Interrupt can reset the signal after
-  // exactly settings.pulse_microseconds microseconds, independent of the main Timer1 prescaler.
-  NVIC_EnableIRQ(STEP_RESET_IRQ);
+  #ifdef VARIABLE_SPINDLE
+    // Set real-time spindle output as segment is loaded, just prior to the first step.
+    spindle_set_speed(st.exec_segment->spindle_pwm);
+  #endif
 
-  busy = true;
+  return(true);
+}
 
-  // If there is no step segment, attempt to pop one from the stepper buffer
-  if (st.exec_segment == NULL) {
-    // Anything in the buffer? If so, load and initialize next step segment.
-    if (segment_buffer_head != segment_buffer_tail) {
-      // Initialize new step segment and load number of steps to execute
-      st.exec_segment = &segment_buffer[segment_buffer_tail];
-
-      // Initialize step segment timing per step and load number of steps to execute.
-      STEP_SET_TIMER->ARR = st.exec_segment->cycles_per_tick - 1;
-      // Set the Autoreload value
-      #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-        //TIM4->PSC = st.exec_segment->prescaler;
-      	STEP_SET_TIMER->PSC = st.exec_segment->prescaler;
-      #endif
+// Executes one Bresenham tick of the current step segment. Leaves the step bits, before the
+// invert mask, in st.step_outbits and discards the segment once all its steps are done.
+static inline void st_step_tick()
+{
+  // Execute step displacement profile by Bresenham line algorithm, one axis per table entry.
+  uint32_t step_event_count = st.exec_block->step_event_count;
+  PIN_MASK step_outbits = 0;
+  uint8_t idx;
+  ST_UNROLL_AXES
+  for (idx=0; idx<N_AXIS; idx++) {
+    #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      st.counter[idx] += st.steps[idx];
+    #else
+      st.counter[idx] += st.exec_block->steps[idx];
+    #endif
+    if (st.counter[idx] > step_event_count) {
+      step_outbits |= step_pin_mask[idx];
+      st.counter[idx] -= step_event_count;
+    }
+  }
+  st.step_outbits = step_outbits;
 
+  // During a homing cycle, lock out and prevent desired axes from moving.
+  if (sys.state == STATE_HOMING) { st.step_outbits &= sys.homing_axis_lock; }
 
-      st.step_count = st.exec_segment->n_step; // NOTE: Can sometimes be zero when moving slow.
-      // If the new segment starts a new planner block, initialize stepper variables and counters.
-      // NOTE: When the segment data index changes, this indicates a new planner block.
-      if ( st.exec_block_index != st.exec_segment->st_block_index ) {
-        st.exec_block_index = st.exec_segment->st_block_index;
-        st.exec_block = &st_block_buffer[st.exec_block_index];
+  st.step_count--; // Decrement step events count
+  if (st.step_count == 0) {
+    // Segment is complete. Discard current segment and advance segment indexing.
+    st.run_ticks += ST_SEGMENT_TICKS(st.exec_segment, st.exec_segment->n_step);
+    st.exec_segment = NULL;
 
-        // Initialize Bresenham line and distance counters
-        st.counter_x = st.counter_y = st.counter_z = st.counter_a = st.counter_b = st.counter_c = (st.exec_block->step_event_count >> 1);
-      }
-      st.dir_outbits = st.exec_block->direction_bits ^ dir_port_invert_mask;
+    //if ( ++segment_buffer_tail == segment_buffer_size) { segment_buffer_tail = 0; }
+  	uint8_t segment_tail_next = segment_buffer_tail + 1;
+  	if (segment_tail_next == segment_buffer_size)
+  		segment_tail_next = 0;
+  	segment_buffer_tail = segment_tail_next;
+  }
+}
 
-      #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-        // With AMASS enabled, adjust Bresenham axis increment counters according to AMASS level.
-        st.steps[X_AXIS] = st.exec_block->steps[X_AXIS] >> st.exec_segment->amass_level;
-        st.steps[Y_AXIS] = st.exec_block->steps[Y_AXIS] >> st.exec_segment->amass_level;
-        st.steps[Z_AXIS] = st.exec_block->steps[Z_AXIS] >> st.exec_segment->amass_level;
+// Programs the step timer period of a segment's ticks. ARR and PSC are preloaded and take effect
+// at the next update.
+static inline void st_segment_timing(segment_t *segment)
+{
+  STEP_SET_TIMER->ARR = segment->cycles_per_tick - 1;
+  #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+    //TIM4->PSC = st.exec_segment->prescaler;
+    STEP_SET_TIMER->PSC = segment->prescaler;
+  #endif
+}
 
+#ifdef ENABLE_STEP_ISR_PROFILE
+// Bins one stepper ISR execution and checks whether it finished in time for the next tick.
+static void st_isr_profile_record(uint32_t isr_start, uint32_t entry_ticks)
+{
+  uint32_t cycles = GetCycleCount() - isr_start;
+  uint32_t range = cycles >> STEP_ISR_HISTOGRAM_SHIFT;
+  uint8_t bin = 0;
+  while (range && (bin < STEP_ISR_HISTOGRAM_BINS-1)) { range >>= 1; bin++; }
+  isr_profile.histogram[bin]++;
+  isr_profile.cycles_total += cycles;
+  isr_profile.count++;
+  if (cycles > isr_profile.cycles_max) { isr_profile.cycles_max = cycles; }
+  if (LL_TIM_IsActiveFlag_UPDATE(STEP_SET_TIMER)) { isr_profile.overruns++; }
+  if (entry_ticks > isr_profile.latency_max) { isr_profile.latency_max = entry_ticks; }
+}
+#endif
 
-        #if ( defined(STM32F1_4) || defined(STM32F4_4) )
-          st.steps[A_AXIS] = st.exec_block->steps[A_AXIS] >> st.exec_segment->amass_level;
-        #endif
-        #if ( defined(STM32F1_5) || defined(STM32F4_5) )
-          st.steps[A_AXIS] = st.exec_block->steps[A_AXIS] >> st.exec_segment->amass_level;
-          st.steps[B_AXIS] = st.exec_block->steps[B_AXIS] >> st.exec_segment->amass_level;
-        #endif
-        #if ( defined(STM32F1_6) || defined(STM32F4_6) )
-          st.steps[A_AXIS] = st.exec_block->steps[A_AXIS] >> st.exec_segment->amass_level;
-          st.steps[B_AXIS] = st.exec_block->steps[B_AXIS] >> st.exec_segment->amass_level;
-          st.steps[C_AXIS] = st.exec_block->steps[C_AXIS] >> st.exec_segment->amass_level;
-        #endif
-      #endif
+void HandleStepSetIT(void)
+{
+  #ifdef ENABLE_STEP_ISR_PROFILE
+    uint32_t isr_start = GetCycleCount();
+    uint32_t entry_ticks = LL_TIM_GetCounter(STEP_SET_TIMER); // Counted from the update
+    if (busy) { isr_profile.reentries++; }
+  #endif
+  if (busy) { return; } // The busy-flag is used to avoid reentering this interrupt
 
-      #ifdef VARIABLE_SPINDLE
-        // Set real-time spindle output as segment is loaded, just prior to the first step.
-        spindle_set_speed(st.exec_segment->spindle_pwm);
-      #endif
+  // Set the direction pins a couple of nanoseconds before we step the steppers
+  GPIO_SetResetBits(DIR_GPIO_Port, st.dir_bsrr);
+
+  #ifdef STEP_PULSE_ONE_SHOT
+    // The one-pulse timer outputs the step bits after the direction setup time and returns them
+    // to idle after the pulse time, both by DMA. No reset interrupt.
+    if (st.step_bsrr != step_port_idle_bsrr) {
+      st.pulse_bsrr = st.step_bsrr;
+      Step_Pulse_Fire();
+    }
+  #else
+    //Step_Reset_IT_Clear(TIM_IT_UPDATE);
+    //HAL_TIM_CLEAR_IT(STEP_SET_TIMER, TIM_IT_UPDATE);
+    //TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
+    LL_TIM_ClearFlag_UPDATE(STEP_RESET_TIMER);
+
+    // Then pulse the stepping pins
+    GPIO_SetResetBits(STEP_GPIO_Port, st.step_bsrr);
+
+    // Enable step pulse reset timer so that The Stepper Port Reset Interrupt can reset the signal after
+    // exactly settings.pulse_microseconds microseconds, independent of the main Timer1 prescaler.
+    NVIC_EnableIRQ(STEP_RESET_IRQ);
+  #endif
 
+  busy = true;
+
+  // If there is no step segment, attempt to pop one from the stepper buffer
+  if (st.exec_segment == NULL) {
+    if (st_load_segment()) {
+      // Initialize step segment timing per step. Normally preloaded already by the last tick of
+      // the previous segment. A segment queued after that tick, once the buffer had run dry,
+      // runs its first tick at the previous rate.
+      st_segment_timing(st.exec_segment);
     } else {
       // Segment buffer empty. Shutdown.
+      #ifdef ENABLE_PREP_PROFILE
+        // Ran dry while the segment generator still had motion to deliver.
+        if ((pl_block != NULL) && bit_isfalse(sys.step_control,STEP_CONTROL_END_MOTION)) { prep_profile.underruns++; }
+      #endif
       st_go_idle();
       #ifdef VARIABLE_SPINDLE
         // Ensure pwm is set properly upon completion of rate-controlled motion.
         if (st.exec_block->is_pwm_rate_adjusted) { spindle_set_speed(SPINDLE_PWM_OFF_VALUE); }
       #endif
       system_set_exec_state_flag(EXEC_CYCLE_STOP); // Flag main program for cycle end
+      #ifdef ENABLE_STEP_ISR_PROFILE
+        st_isr_profile_record(isr_start, entry_ticks);
+      #endif
       return; // Nothing to do but exit.
     }
   }
@@ -450,140 +1002,19 @@ void HandleStepSetIT(void)
   // Check probing state.
   if (sys_probe_state == PROBE_ACTIVE) { probe_state_monitor(); }
 
-  // Reset step out bits.
-  st.step_outbits = 0;
-
-  // Execute step displacement profile by Bresenham line algorithm
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_x += st.steps[X_AXIS];
-  #else
-    st.counter_x += st.exec_block->steps[X_AXIS];
-  #endif
-  if (st.counter_x > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_X_Pin;
-    st.counter_x -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_X_Pin) { sys_position[X_AXIS]--; }
-    else { sys_position[X_AXIS]++; }
-  }
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_y += st.steps[Y_AXIS];
-  #else
-    st.counter_y += st.exec_block->steps[Y_AXIS];
-  #endif
-  if (st.counter_y > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_Y_Pin;
-    st.counter_y -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_Y_Pin) { sys_position[Y_AXIS]--; }
-    else { sys_position[Y_AXIS]++; }
-  }
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_z += st.steps[Z_AXIS];
-  #else
-    st.counter_z += st.exec_block->steps[Z_AXIS];
-  #endif
-  if (st.counter_z > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_Z_Pin;
-    st.counter_z -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_Z_Pin) { sys_position[Z_AXIS]--; }
-    else { sys_position[Z_AXIS]++; }
-  }
+  st_step_tick();
 
-#if ( defined(STM32F1_4) || defined(STM32F4_4) )
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_a += st.steps[A_AXIS];
-  #else
-    st.counter_a += st.exec_block->steps[A_AXIS];
-  #endif
-  if (st.counter_a > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_A_Pin;
-    st.counter_a -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_A_Pin) { sys_position[A_AXIS]--; }
-    else { sys_position[A_AXIS]++; }
+  // Preload the next segment's rate for the tick after the one just started.
+  if ((st.exec_segment == NULL) && (segment_buffer_head != segment_buffer_tail)) {
+    st_segment_timing(&segment_buffer[segment_buffer_tail]);
   }
-#endif
-#if ( defined(STM32F1_5) || defined(STM32F4_5) )
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_a += st.steps[A_AXIS];
-  #else
-    st.counter_a += st.exec_block->steps[A_AXIS];
-  #endif
-  if (st.counter_a > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_A_Pin;
-    st.counter_a -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_A_Pin) { sys_position[A_AXIS]--; }
-    else { sys_position[A_AXIS]++; }
-  }
-
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_b += st.steps[B_AXIS];
-  #else
-    st.counter_b += st.exec_block->steps[B_AXIS];
-  #endif
-  if (st.counter_b > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_B_Pin;
-    st.counter_b -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_B_Pin) { sys_position[B_AXIS]--; }
-    else { sys_position[B_AXIS]++; }
-  }
-#endif
-#if ( defined(STM32F1_6) || defined(STM32F4_6) )
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_a += st.steps[A_AXIS];
-  #else
-    st.counter_a += st.exec_block->steps[A_AXIS];
-  #endif
-  if (st.counter_a > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_A_Pin;
-    st.counter_a -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_A_Pin) { sys_position[A_AXIS]--; }
-    else { sys_position[A_AXIS]++; }
-  }
-
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_b += st.steps[B_AXIS];
-  #else
-    st.counter_b += st.exec_block->steps[B_AXIS];
-  #endif
-  if (st.counter_b > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_B_Pin;
-    st.counter_b -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_B_Pin) { sys_position[B_AXIS]--; }
-    else { sys_position[B_AXIS]++; }
-  }
-
-  #ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
-    st.counter_c += st.steps[C_AXIS];
-  #else
-    st.counter_c += st.exec_block->steps[C_AXIS];
-  #endif
-  if (st.counter_c > st.exec_block->step_event_count) {
-    st.step_outbits |= STEP_C_Pin;
-    st.counter_c -= st.exec_block->step_event_count;
-    if (st.exec_block->direction_bits & DIR_C_Pin) { sys_position[C_AXIS]--; }
-    else { sys_position[C_AXIS]++; }
-  }
-#endif
-
-  // During a homing cycle, lock out and prevent desired axes from moving.
-  if (sys.state == STATE_HOMING) { st.step_outbits &= sys.homing_axis_lock; }
-
-  st.step_count--; // Decrement step events count
-  if (st.step_count == 0) {
-    // Segment is complete. Discard current segment and advance segment indexing.
-    st.exec_segment = NULL;
-
-    //if ( ++segment_buffer_tail == SEGMENT_BUFFER_SIZE) { segment_buffer_tail = 0; }
-  	uint8_t segment_tail_next = segment_buffer_tail + 1;
-  	if (segment_tail_next == SEGMENT_BUFFER_SIZE)
-  		segment_tail_next = 0;
-  	segment_buffer_tail = segment_tail_next;
-  }
-
-
-
 
   st.step_outbits ^= step_port_invert_mask;  // Apply step port invert mask
+  st.step_bsrr = st_port_word(st.step_outbits, STEP_MASK);
   busy = false;
+  #ifdef ENABLE_STEP_ISR_PROFILE
+    st_isr_profile_record(isr_start, entry_ticks);
+  #endif
 
 
 }
@@ -605,11 +1036,11 @@ void HandleStepSetIT(void)
 
 void HandleStepResetIT()
 {
-  GPIO_Write(STEP_GPIO_Port, (GPIO_ReadOutputData(STEP_GPIO_Port) & ~STEP_MASK) | (step_port_invert_mask & STEP_MASK));
+  GPIO_SetResetBits(STEP_GPIO_Port, step_port_idle_bsrr);
 }
 
 
-#ifdef STEP_PULSE_DELAY
+#if defined(STEP_PULSE_DELAY) && defined(ATMEGA328P)
   // This interrupt is used only when STEP_PULSE_DELAY is enabled. Here, the step pulse is
   // initiated after the STEP_PULSE_DELAY time period has elapsed. The ISR TIMER2_OVF interrupt
   // will then trigger after the appropriate settings.pulse_microseconds, as in normal operation.
@@ -622,6 +1053,178 @@ void HandleStepResetIT()
 #endif
 
 
+#ifdef STEP_PULSE_DMA
+/* The DMA step engine: instead of one stepper ISR per tick, the Bresenham ticks are expanded ahead
+   of time into a circular buffer of port words and interval lengths. Every step timer update makes
+   the DMA write the next port word to the step/direction port's BSRR and the next interval to the
+   timer's ARR, so the step rising edge, the pulse reset and idle ticks all run without the CPU.
+   Half-transfer and transfer-complete interrupts refill the half of the buffer just sent, which
+   replaces both HandleStepSetIT() and HandleStepResetIT() with one interrupt per half buffer.
+     The stream reproduces the stepper ISR timing exactly: the step bits of a tick are output at
+   the update that starts the next tick, with the direction bits, and the pulse takes its length
+   out of that interval. Direction changes are moved forward onto the preceding idle or pulse
+   reset entry when it is not in flight yet, giving the drivers a full interval of setup time.
+     The machine position is counted when a tick is generated, so it runs ahead of the port by at most one
+   buffer. Steps generated but never output are taken back out when the stream is stopped early.
+   Homing and probing still use the stepper ISR, as they check switches every step.
+*/
+
+// Takes steps that were generated but never output back out of sys_position.
+static void st_dma_unstep(PIN_MASK step_bits, PIN_MASK dir_outbits)
+{
+  uint8_t idx;
+  PIN_MASK direction_bits = dir_outbits ^ dir_port_invert_mask;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (step_bits & step_pin_mask[idx]) {
+      if (direction_bits & direction_pin_mask[idx]) { sys_position[idx]++; }
+      else { sys_position[idx]--; }
+    }
+  }
+}
+
+// As above, for a port word. Only words that start a step pulse drive every step pin active.
+static void st_dma_unstep_word(uint32_t word)
+{
+  if ((word & ((uint32_t)STEP_MASK << 16 | STEP_MASK)) == 0) { return; }
+  st_dma_unstep(((word & STEP_MASK) ^ step_port_invert_mask) & STEP_MASK, word & DIR_MASK);
+}
+
+static void st_dma_store(uint16_t idx, uint32_t word, uint32_t ticks)
+{
+  st_dma.bsrr[idx] = word;
+  st_dma.arr[idx] = ticks - 1;
+  // Entries that start a step pulse are never stretched.
+  if ((word & STEP_MASK & ~step_port_invert_mask) || ((word >> 16) & STEP_MASK & step_port_invert_mask)) { st_dma.last = STEP_DMA_NONE; }
+  else { st_dma.last = idx; }
+}
+
+// Queues the entries that start a tick interval of the given length: the pulse for the step
+// bits owed by the previous tick, or an idle interval, merged into the last entry if possible.
+static void st_dma_queue_interval(uint32_t ticks)
+{
+  if (st_dma.step_bits) {
+    uint32_t dir_word = st_port_word(st_dma.step_dir, DIR_MASK);
+    if (st_dma.last != STEP_DMA_NONE) {
+      // Set the direction pins at the start of the previous interval instead.
+      st_dma.bsrr[st_dma.last] = (st_dma.bsrr[st_dma.last] & ~((uint32_t)DIR_MASK << 16 | DIR_MASK)) | dir_word;
+    }
+    uint32_t pulse = st.step_pulse_time;
+    if (pulse + STEP_DMA_MIN_TICKS > ticks) { pulse = ticks - STEP_DMA_MIN_TICKS; }
+    if (pulse < STEP_DMA_MIN_TICKS) { pulse = STEP_DMA_MIN_TICKS; }
+    uint32_t rest = (ticks > pulse + STEP_DMA_MIN_TICKS) ? ticks - pulse : STEP_DMA_MIN_TICKS;
+    st_dma.owed_word[0] = st_port_word(st_dma.step_bits ^ step_port_invert_mask, STEP_MASK) | dir_word;
+    st_dma.owed_ticks[0] = pulse;
+    st_dma.owed_word[1] = step_port_idle_bsrr | dir_word;
+    st_dma.owed_ticks[1] = rest;
+    st_dma.owed_count = 2;
+  } else if ((st_dma.last != STEP_DMA_NONE) && (st_dma.arr[st_dma.last] + 1 + ticks <= 0x10000)) {
+    st_dma.arr[st_dma.last] += ticks;
+  } else {
+    st_dma.owed_word[0] = 0;
+    st_dma.owed_ticks[0] = ticks;
+    st_dma.owed_count = 1;
+  }
+}
+
+// Fills entries [idx, end) of the buffer, continuing the step stream where the last fill stopped.
+// Once the segment buffer runs dry and the last pulse is stored, the rest is short idle padding.
+static void st_dma_fill(uint16_t idx, uint16_t end)
+{
+  while (idx < end) {
+    if (st_dma.owed_count) {
+      st_dma_store(idx, st_dma.owed_word[0], st_dma.owed_ticks[0]);
+      st_dma.last_motion = idx++;
+      st_dma.owed_word[0] = st_dma.owed_word[1];
+      st_dma.owed_ticks[0] = st_dma.owed_ticks[1];
+      st_dma.owed_count--;
+    } else if (!st_dma.end) {
+      // Execute the next tick, as the stepper ISR would.
+      if (st.exec_segment == NULL) {
+        if (!st_load_segment()) {
+          // Segment buffer empty. Output the last pulse, then shut down.
+          #ifdef ENABLE_PREP_PROFILE
+            if ((pl_block != NULL) && bit_isfalse(sys.step_control,STEP_CONTROL_END_MOTION)) { prep_profile.underruns++; }
+          #endif
+          if (st_dma.step_bits) { st_dma_queue_interval(st.step_pulse_time + STEP_DMA_MIN_TICKS); }
+          st_dma.step_bits = 0;
+          st_dma.end = true;
+          continue;
+        }
+      }
+      st_dma_queue_interval(st.exec_segment->cycles_per_tick);
+      st_step_tick();
+      st_dma.step_bits = st.step_outbits;
+      st_dma.step_dir = st.dir_outbits;
+    } else {
+      st_dma.bsrr[idx] = 0;
+      st_dma.arr[idx++] = STEP_DMA_MIN_TICKS - 1;
+    }
+  }
+  if (st_dma.end && !st_dma.owed_count && (st_dma.end_half == 0xff)) {
+    st_dma.end_half = (st_dma.last_motion >= STEP_DMA_BUFFER_SIZE/2) && (st_dma.last_motion != STEP_DMA_STAGE);
+  }
+}
+
+// Called by st_wake_up(). Fills the whole buffer and starts the stream. The first interval is
+// loaded by hand, so the first DMA transfer happens at the update ending it.
+static void st_dma_start()
+{
+  st_dma.owed_count = 0;
+  st_dma.step_bits = 0;
+  st_dma.last = STEP_DMA_NONE;
+  st_dma.last_motion = STEP_DMA_STAGE;
+  st_dma.end = false;
+  st_dma.end_half = 0xff;
+  st_dma.finished = false;
+  st_dma_fill(STEP_DMA_STAGE, STEP_DMA_STAGE+1);
+  st_dma_fill(0, STEP_DMA_BUFFER_SIZE);
+
+  GPIO_SetResetBits(STEP_GPIO_Port, st_dma.bsrr[STEP_DMA_STAGE]);
+  Step_DMA_Start(st_dma.bsrr, st_dma.arr, STEP_DMA_BUFFER_SIZE, st_dma.arr[STEP_DMA_STAGE]);
+}
+
+// Called by st_go_idle(). Stops the stream and leaves the step pins idle. Unless the engine ran
+// to the end by itself, the steps in entries not yet output are taken back out of sys_position.
+static void st_dma_stop()
+{
+  uint16_t idx = STEP_DMA_BUFFER_SIZE - Step_DMA_Stop();
+  st_dma.active = false;
+  if (!st_dma.finished) {
+    // The rest of the half in flight and all of the other half are still to be output.
+    uint16_t count = STEP_DMA_BUFFER_SIZE - (idx % (STEP_DMA_BUFFER_SIZE/2));
+    while (count--) {
+      if (idx == STEP_DMA_BUFFER_SIZE) { idx = 0; }
+      st_dma_unstep_word(st_dma.bsrr[idx++]);
+    }
+    while (st_dma.owed_count) { st_dma_unstep_word(st_dma.owed_word[--st_dma.owed_count]); }
+    st_dma_unstep(st_dma.step_bits, st_dma.step_dir);
+    st_dma.step_bits = 0;
+  }
+  GPIO_SetResetBits(STEP_GPIO_Port, step_port_idle_bsrr);
+}
+
+// DMA half-transfer/transfer-complete interrupt. Refills the half just sent, or ends the cycle
+// once the half holding the last step pulse is out.
+void HandleStepDMAIT(uint8_t half)
+{
+  if (!st_dma.active) { return; }
+  if (half == st_dma.end_half) {
+    st_dma.finished = true;
+    st_go_idle();
+    #ifdef VARIABLE_SPINDLE
+      // Ensure pwm is set properly upon completion of rate-controlled motion.
+      if (st.exec_block->is_pwm_rate_adjusted) { spindle_set_speed(SPINDLE_PWM_OFF_VALUE); }
+    #endif
+    system_set_exec_state_flag(EXEC_CYCLE_STOP); // Flag main program for cycle end
+    return;
+  }
+  st_dma.last = STEP_DMA_NONE; // The other half is in flight.
+  uint16_t idx = half ? (STEP_DMA_BUFFER_SIZE/2) : 0;
+  st_dma_fill(idx, idx + STEP_DMA_BUFFER_SIZE/2);
+}
+#endif
+
+
 // Generates the step and direction port invert masks used in the Stepper Interrupt Driver.
 void st_generate_step_dir_invert_masks()
 {
@@ -637,7 +1240,33 @@ void st_generate_step_dir_invert_masks()
       if (bit_istrue(settings.dir_invert_mask,bit(idx))) { dir_port_invert_mask |= get_direction_pin_mask(idx); }
     #endif
   }
+  #ifdef STM32
+    step_port_idle_bsrr = st_port_word(step_port_invert_mask, STEP_MASK);
+  #endif
+}
+
+
+#ifdef SEGMENT_BUFFER_ARENA
+// Sizes the segment buffer for the $60 depth and lays it out at the start of the arena, with the
+// block data after it. The depth is cut back to what the arena and the 8-bit buffer indices hold.
+// NOTE: Only called from st_reset(), with both buffers empty.
+static void st_buffer_layout()
+{
+  uint32_t dt_segment = STEP_TIMER_CLOCK/ACCELERATION_TICKS_PER_SECOND;
+  uint32_t depth = (uint32_t)settings.segment_buffer_ms*(STEP_TIMER_CLOCK/1000);
+  uint32_t size = (depth+dt_segment-1)/dt_segment + 2;
+  uint32_t size_max = (sizeof(st_buffer_arena)+sizeof(st_block_t))/(sizeof(segment_t)+sizeof(st_block_t));
+  if (size > size_max) { size = size_max; }
+  if (size > 0xff) { size = 0xff; }
+  if (size < 3) { size = 3; }
+  segment_buffer_size = size;
+  segment_buffer_depth = (size-2)*dt_segment;
+  if (depth && (depth < segment_buffer_depth)) { segment_buffer_depth = depth; }
+
+  segment_buffer = (segment_t *)st_buffer_arena;
+  st_block_buffer = (st_block_t *)&segment_buffer[size];
 }
+#endif
 
 
 // Reset and clear stepper subsystem variables
@@ -649,6 +1278,9 @@ void st_reset()
   // Initialize stepper algorithm variables.
   memset(&prep, 0, sizeof(st_prep_t));
   memset(&st, 0, sizeof(stepper_t));
+  #ifdef SEGMENT_BUFFER_ARENA
+    st_buffer_layout();
+  #endif
   st.exec_segment = NULL;
   pl_block = NULL;  // Planner block pointer used by segment buffer
   segment_buffer_tail = 0;
@@ -657,6 +1289,9 @@ void st_reset()
   busy = false;
 
   st_generate_step_dir_invert_masks();
+  #ifdef INPUT_SHAPING
+    st_update_shapers();
+  #endif
   st.dir_outbits = dir_port_invert_mask; // Initialize direction bits to default.
 
   // Initialize step and direction port pins.
@@ -673,11 +1308,27 @@ void st_reset()
 // Initialize and start the stepper motor subsystem
 void stepper_init()
 {
+#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+	amass_isr_ticks = AMASS_ISR_TICKS;
+#endif
+#ifdef ENABLE_PREP_PROFILE
+	st_prep_profile_reset();
+#endif
+#ifdef ENABLE_STEP_ISR_PROFILE
+	st_isr_profile_reset();
+#endif
 #ifdef STM32
 	Step_Set_Enable();
-	Step_Reset_Enable();
+	#ifdef STEP_PULSE_ONE_SHOT
+		Step_Pulse_Init(&st.pulse_bsrr, &step_port_idle_bsrr);
+	#else
+		Step_Reset_Enable();
+	#endif
 	Step_Set_DisableIRQ();
 	Step_Reset_DisableIRQ();
+	#ifdef STEP_PULSE_DMA
+		Step_DMA_Init();
+	#endif
 #elif ATMEGA328P
   // Configure step and direction interface pins
   STEP_DDR |= STEP_MASK;
@@ -703,62 +1354,664 @@ void stepper_init()
 #endif
 }
 
-
-// Called by planner_recalculate() when the executing block is updated by the new plan.
-void st_update_plan_block_parameters()
+
+// Called by planner_recalculate() when the executing block is updated by the new plan.
+void st_update_plan_block_parameters()
+{
+  if (pl_block != NULL) { // Ignore if at start of a new block.
+    prep.recalculate_flag |= PREP_FLAG_RECALCULATE;
+    float current_speed = st_prep_current_speed();
+    pl_block->entry_speed_sqr = current_speed*current_speed; // Update entry speed.
+    pl_block = NULL; // Flag st_prep_segment() to load and check active velocity profile.
+  }
+}
+
+
+// Increments the step segment buffer block data ring buffer.
+static uint8_t st_next_block_index(uint8_t block_index)
+{
+  block_index++;
+  if ( block_index == (segment_buffer_size-1) ) { return(0); }
+  return(block_index);
+}
+
+
+#ifdef PARKING_ENABLE
+  // Changes the run state of the step segment buffer to execute the special parking motion.
+  void st_parking_setup_buffer()
+  {
+    // Store step execution data of partially completed block, if necessary.
+    if (prep.recalculate_flag & PREP_FLAG_HOLD_PARTIAL_BLOCK) {
+      prep.last_st_block_index = prep.st_block_index;
+      prep.last_steps_remaining = prep.steps_remaining;
+      prep.last_dt_remainder = prep.dt_remainder;
+      prep.last_dt_excess = prep.dt_excess;
+      prep.last_step_per_mm = prep.step_per_mm;
+      #ifdef ST_PREP_FIXED_POINT
+        prep.last_steps_to_go = prep.steps_to_go;
+      #endif
+    }
+    // Set flags to execute a parking motion
+    prep.recalculate_flag |= PREP_FLAG_PARKING;
+    prep.recalculate_flag &= ~(PREP_FLAG_RECALCULATE);
+    pl_block = NULL; // Always reset parking motion to reload new block.
+  }
+
+
+  // Restores the step segment buffer to the normal run state after a parking motion.
+  void st_parking_restore_buffer()
+  {
+    // Restore step execution data and flags of partially completed block, if necessary.
+    if (prep.recalculate_flag & PREP_FLAG_HOLD_PARTIAL_BLOCK) {
+      st_prep_block = &st_block_buffer[prep.last_st_block_index];
+      prep.st_block_index = prep.last_st_block_index;
+      prep.steps_remaining = prep.last_steps_remaining;
+      prep.dt_remainder = prep.last_dt_remainder;
+      prep.dt_excess = prep.last_dt_excess;
+      prep.step_per_mm = prep.last_step_per_mm;
+      prep.recalculate_flag = (PREP_FLAG_HOLD_PARTIAL_BLOCK | PREP_FLAG_RECALCULATE);
+      #ifdef ST_PREP_FIXED_POINT
+        prep.steps_to_go = prep.last_steps_to_go;
+      #else
+        prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm; // Recompute this value.
+      #endif
+    } else {
+      prep.recalculate_flag = false;
+    }
+    pl_block = NULL; // Set to reload next block.
+  }
+#endif
+
+
+#ifdef ST_PREP_FIXED_POINT
+// Float to fixed point conversions, saturating. Only used when a block profile is computed.
+static uint32_t st_fx_u32(float value)
+{
+  if (value >= 4294967295.0f) { return(0xffffffff); }
+  if (value > 0.0f) { return((uint32_t)value); }
+  return(0);
+}
+
+static uint64_t st_fx_u64(float value)
+{
+  if (value >= 18446744073709551615.0f) { return(0xffffffffffffffffULL); }
+  if (value > 0.0f) { return((uint64_t)value); }
+  return(0);
+}
+
+// Integer square root, floor(sqrt(value)). Converts speed^2 to speed.
+static uint32_t st_fx_sqrt(uint64_t value)
+{
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > value) { bit >>= 2; }
+  while (bit) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return((uint32_t)root);
+}
+
+// Sets the unit conversions of the prepped block from its steps per mm.
+static void st_fx_scale_block()
+{
+  prep.speed_scale = prep.step_per_mm*(ST_FX_SPEED_ONE/fTICKS_PER_MINUTE);
+  prep.acceleration = st_fx_u32(pl_block->pbacceleration*prep.step_per_mm*(ST_FX_ACCEL_ONE/(fTICKS_PER_MINUTE*fTICKS_PER_MINUTE)));
+  if (prep.acceleration == 0) { prep.acceleration = 1; }
+}
+
+// Distance to change speed^2 by speed_sqr at the block acceleration, v^2/(2a). Saturates well
+// beyond any block length, so adding it to a distance cannot overflow.
+static uint64_t st_fx_ramp_distance(uint64_t speed_sqr)
+{
+  uint64_t distance = speed_sqr/prep.acceleration; // Q.20 steps of v^2/a
+  if (distance >= ((uint64_t)1 << 52)) { return((uint64_t)1 << 63); }
+  return(distance << 11);
+}
+
+// Speed^2 gained over a distance at the block acceleration, 2*a*d.
+static uint64_t st_fx_ramp_speed_sqr(uint64_t distance)
+{
+  distance >>= 11; // Q.21, so that a Q.60 product is 2*a*d in Q.80
+  if (distance > (0xffffffffffffffffULL/prep.acceleration)) { return(0xffffffffffffffffULL); }
+  return(distance*prep.acceleration);
+}
+
+// Distance traveled in time ticks at speed.
+static inline uint64_t st_fx_distance(uint32_t time, uint32_t speed)
+{
+  return(((uint64_t)time*speed) >> 8);
+}
+
+// Time to travel distance at speed, rounded down. Zero speed takes no time, as with the float
+// generator the ramp then ends on the distance check.
+static uint32_t st_fx_time(uint64_t distance, uint64_t speed)
+{
+  if (speed == 0) { return(0); }
+  uint64_t time = (distance << 8)/speed;
+  if (time > 0xffffffff) { return(0xffffffff); }
+  return((uint32_t)time);
+}
+#endif
+
+
+#ifdef INPUT_SHAPING
+/* Input shapers. An axis resonance at frequency f with damping ratio z rings at the damped period
+   Td = 1/(f*sqrt(1-z^2)). The shaper impulses, K = exp(-z*pi/sqrt(1-z^2)), normalized to a sum of 1:
+     ZV   1, K at 0, Td/2
+     ZVD  1, 2K, K^2 at 0, Td/2, Td
+     MZV  1-1/sqrt(2), (sqrt(2)-1)*K', (1-1/sqrt(2))*K'^2 at 0, 3Td/8, 3Td/4, with K' = K^(3/4)
+   The vibration excited by each impulse is cancelled by the later ones, so an acceleration
+   convolved with the shaper leaves no residual vibration at f, and little around it.
+*/
+void st_update_shapers()
+{
+  uint8_t idx, i;
+  for (idx=0; idx<N_AXIS; idx++) {
+    st_shaper_t *shaper = &axis_shaper[idx];
+    float frequency = settings.shaper_frequency[idx];
+    float damping = settings.shaper_damping[idx];
+    shaper->count = 0;
+    if ((settings.shaper_type[idx] == SHAPER_NONE) || (frequency <= 0.0f)) { continue; }
+    float damped = sqrtf(1.0f-damping*damping);
+    float period = 1.0f/(60.0f*frequency*damped); // (min)
+    float k = expf(-damping*M_PI/damped);
+    switch (settings.shaper_type[idx]) {
+      case SHAPER_ZV:
+        shaper->count = 2;
+        shaper->amplitude[0] = 1.0f; shaper->time[0] = 0.0f;
+        shaper->amplitude[1] = k;    shaper->time[1] = 0.5f*period;
+        break;
+      case SHAPER_ZVD:
+        shaper->count = 3;
+        shaper->amplitude[0] = 1.0f;   shaper->time[0] = 0.0f;
+        shaper->amplitude[1] = 2.0f*k; shaper->time[1] = 0.5f*period;
+        shaper->amplitude[2] = k*k;    shaper->time[2] = period;
+        break;
+      default: // SHAPER_MZV
+        k = expf(-0.75f*damping*M_PI/damped);
+        shaper->count = 3;
+        shaper->amplitude[0] = 1.0f-M_SQRT1_2;        shaper->time[0] = 0.0f;
+        shaper->amplitude[1] = (M_SQRT2-1.0f)*k;      shaper->time[1] = 0.375f*period;
+        shaper->amplitude[2] = (1.0f-M_SQRT1_2)*k*k;  shaper->time[2] = 0.75f*period;
+    }
+    float sum = 0.0f;
+    for (i=0; i<shaper->count; i++) { sum += shaper->amplitude[i]; }
+    shaper->centroid = 0.0f;
+    for (i=0; i<shaper->count; i++) {
+      shaper->amplitude[i] /= sum;
+      shaper->centroid += shaper->amplitude[i]*shaper->time[i];
+    }
+  }
+  prep.shaper_axes = 0; // Rebuild the block shaper.
+  prep.shaper_count = 0;
+}
+
+// Shaped axes moving in a block.
+static uint8_t st_shaper_moving_axes(plan_block_t *block)
+{
+  uint8_t axes = 0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (block->steps[idx] && axis_shaper[idx].count) { axes |= bit(idx); }
+  }
+  return(axes);
+}
+
+// Axes whose shapers the block shaper combines: each different one once, up to SHAPER_MAX_IMPULSES.
+static uint8_t st_shaper_combined_axes(uint8_t axes)
+{
+  uint8_t combined = 0;
+  uint8_t count = 1;
+  uint8_t idx, other;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (!(axes & bit(idx))) { continue; }
+    for (other=0; other<idx; other++) {
+      if ((axes & bit(other)) && (settings.shaper_type[other] == settings.shaper_type[idx]) &&
+          (settings.shaper_frequency[other] == settings.shaper_frequency[idx]) &&
+          (settings.shaper_damping[other] == settings.shaper_damping[idx])) { break; }
+    }
+    if (other < idx) { continue; } // Same shaper as an axis already combined.
+    if (count*axis_shaper[idx].count > SHAPER_MAX_IMPULSES) { continue; }
+    count *= axis_shaper[idx].count;
+    combined |= bit(idx);
+  }
+  return(combined);
+}
+
+// Sets the shaper timing the planner plans the ramps of a new block with. The duration and
+// centroid of a convolution are the sums of those of the shapers combined.
+void st_shaper_block_timing(plan_block_t *block)
+{
+  uint8_t axes = st_shaper_combined_axes(st_shaper_moving_axes(block));
+  float duration = 0.0f;
+  float centroid = 0.0f;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (axes & bit(idx)) {
+      duration += axis_shaper[idx].time[axis_shaper[idx].count-1];
+      centroid += axis_shaper[idx].centroid;
+    }
+  }
+  block->shaper_time_high = max(centroid, duration-centroid);
+  block->shaper_time_low = min(centroid, duration-centroid);
+}
+
+// Loads the shaper of the new block: the convolution of the shapers of its moving axes, as
+// combined by st_shaper_combined_axes(). Consecutive blocks along the same axes reuse it.
+static void st_shaper_load()
+{
+  uint8_t axes = st_shaper_moving_axes(pl_block);
+  uint8_t idx, i, j;
+  if (axes == prep.shaper_axes) { return; }
+  prep.shaper_axes = axes;
+  prep.shaper_count = 0;
+  prep.shaper_duration = 0.0f;
+  prep.shaper_centroid = 0.0f;
+  axes = st_shaper_combined_axes(axes);
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (!(axes & bit(idx))) { continue; }
+    st_shaper_t *shaper = &axis_shaper[idx];
+    if (prep.shaper_count == 0) {
+      prep.shaper_count = shaper->count;
+      memcpy(prep.shaper_amplitude, shaper->amplitude, sizeof(shaper->amplitude));
+      memcpy(prep.shaper_time, shaper->time, sizeof(shaper->time));
+    } else {
+      // Convolve in place, from the last impulse down so that none is overwritten before use.
+      i = prep.shaper_count;
+      while (i--) {
+        for (j=shaper->count; j--; ) {
+          prep.shaper_amplitude[i*shaper->count+j] = prep.shaper_amplitude[i]*shaper->amplitude[j];
+          prep.shaper_time[i*shaper->count+j] = prep.shaper_time[i]+shaper->time[j];
+        }
+      }
+      prep.shaper_count *= shaper->count;
+    }
+    prep.shaper_duration += shaper->time[shaper->count-1];
+    prep.shaper_centroid += shaper->centroid;
+  }
+}
+#endif
+
+
+#ifdef ST_RAMP_SHAPING
+/* Shaped ramps. A ramp from the current speed to target_speed over distance takes the same
+   time as the planner's constant acceleration ramp, T = 2*distance/(v0+v1), and covers the same
+   distance, since its acceleration is symmetric in time.
+
+   With S_CURVE_ACCELERATION, the acceleration rises at the block jerk to its peak within T,
+   holds it and falls back to zero. Of the profiles that fit, the one with the lowest peak is
+   taken: with jerk phases of t1 = a/J, the speed change dv = a*(T-t1) gives
+     a = 2*dv/(T + sqrt(T^2 - 4*dv/J))
+   If T^2 < 4*dv/J, no profile meets the jerk and the acceleration is a triangle, t1 = T/2.
+   The planner and st_ramp_compute_profile() size each ramp with plan_ramp_distance(), whose
+   duration is dv/a + t1 at the block acceleration, so the peak found here is that acceleration.
+
+   With INPUT_SHAPING, that base ramp lasts the ramp duration less the shaper duration D and is
+   convolved with the shaper impulses, a copy scaled by each amplitude starting at each impulse
+   time. Its acceleration is no longer symmetric when the shaper is damped: with c the mean
+   impulse time, the ramp covers dv*(D/2-c) less than at constant acceleration, and lasts
+     T = 2*(distance - dv*(D/2-c))/(v0+v1)
+   The planned distance includes the D longer ramp, so the base ramp keeps the block acceleration.
+   A ramp given too little distance for the shaper, T <= D, is not shaped. Planned ramps always
+   get enough.
+*/
+static void st_ramp_start(float target_speed, float distance, float ramp_end)
+{
+  prep.ramp_shaped = prep.ramp_type;
+  prep.ramp_time = 0.0f;
+  prep.ramp_duration = 0.0f;
+  prep.ramp_entry_speed = prep.current_speed;
+  prep.ramp_exit_speed = target_speed;
+  prep.ramp_delta = target_speed-prep.current_speed;
+  prep.ramp_end = ramp_end;
+  prep.ramp_jerk_time = 0.0f; // No jerk limit, constant acceleration.
+  #ifdef INPUT_SHAPING
+    prep.ramp_impulses = 0;
+  #endif
+  float speed_sum = prep.current_speed+target_speed;
+  if ((speed_sum <= 0.0f) || (distance <= 0.0f)) { return; } // Ends immediately.
+  float time = 2.0f*distance/speed_sum;
+  float base = time;
+  #ifdef INPUT_SHAPING
+    if (prep.shaper_count) {
+      float shaped_time = 2.0f*(distance-prep.ramp_delta*(0.5f*prep.shaper_duration-prep.shaper_centroid))/speed_sum;
+      if (shaped_time > prep.shaper_duration) {
+        time = shaped_time;
+        base = time-prep.shaper_duration;
+        prep.ramp_impulses = prep.shaper_count;
+      }
+    }
+  #endif
+  #ifdef S_CURVE_ACCELERATION
+    if (pl_block->jerk > 0.0f) {
+      float delta = fabsf(prep.ramp_delta);
+      float radicand = base*base-4.0f*delta/pl_block->jerk;
+      if (radicand > 0.0f) { prep.ramp_jerk_time = 2.0f*delta/(pl_block->jerk*(base+sqrtf(radicand))); }
+      else { prep.ramp_jerk_time = 0.5f*base; }
+    }
+  #endif
+  prep.ramp_duration = time;
+  prep.ramp_base = base;
+  prep.ramp_accel = prep.ramp_delta/(base-prep.ramp_jerk_time);
+}
+
+// Starts the ramp of a newly computed velocity profile. A replan that leaves the ramp in progress
+// with the same type and target speed, such as the planner raising the exit speed of a block
+// that is still accelerating to its nominal speed, continues it instead.
+static void st_ramp_begin(float mm_remaining)
+{
+  float target_speed = prep.exit_speed;
+  float ramp_end = prep.mm_complete;
+  if (prep.ramp_type == RAMP_CRUISE) { return; }
+  if (prep.ramp_type != RAMP_DECEL) {
+    target_speed = prep.maximum_speed;
+    ramp_end = prep.accelerate_until;
+  }
+  if ((prep.ramp_time < prep.ramp_duration) && (prep.ramp_shaped == prep.ramp_type) &&
+      (prep.ramp_exit_speed == target_speed)) {
+    if (prep.ramp_type == RAMP_DECEL) {
+      if (prep.ramp_end == ramp_end) { return; }
+    } else if (prep.ramp_end >= prep.decelerate_after) {
+      prep.accelerate_until = prep.ramp_end;
+      return;
+    }
+  }
+  st_ramp_start(target_speed, mm_remaining-ramp_end, ramp_end);
+}
+
+// Speed change and distance beyond the entry speed of the base ramp, at time from its start.
+static float st_ramp_base_speed_change(float time)
+{
+  if (time <= 0.0f) { return(0.0f); }
+  float t1 = prep.ramp_jerk_time;
+  float t_end = prep.ramp_base-time;
+  if (t_end <= 0.0f) { return(prep.ramp_delta); }
+  if (time < t1) { return(prep.ramp_accel*time*time/(2.0f*t1)); }
+  if ((t1 > 0.0f) && (t_end < t1)) { return(prep.ramp_delta-prep.ramp_accel*t_end*t_end/(2.0f*t1)); }
+  return(prep.ramp_accel*(time-0.5f*t1));
+}
+
+static float st_ramp_base_distance(float time)
+{
+  if (time <= 0.0f) { return(0.0f); }
+  float t1 = prep.ramp_jerk_time;
+  float t_end = prep.ramp_base-time;
+  if (t_end <= 0.0f) { return(prep.ramp_delta*(0.5f*prep.ramp_base-t_end)); }
+  if (time < t1) { return(prep.ramp_accel*time*time*time/(6.0f*t1)); }
+  if ((t1 > 0.0f) && (t_end < t1)) {
+    return(prep.ramp_delta*(0.5f*prep.ramp_base-t_end)+prep.ramp_accel*t_end*t_end*t_end/(6.0f*t1));
+  }
+  return(prep.ramp_accel*(0.5f*time*time-0.5f*t1*time+t1*t1/6.0f));
+}
+
+// Speed change and distance from the start of the ramp at time.
+static float st_ramp_speed_change(float time)
+{
+  #ifdef INPUT_SHAPING
+    if (prep.ramp_impulses) {
+      float speed_change = 0.0f;
+      uint8_t i;
+      for (i=0; i<prep.ramp_impulses; i++) {
+        speed_change += prep.shaper_amplitude[i]*st_ramp_base_speed_change(time-prep.shaper_time[i]);
+      }
+      return(speed_change);
+    }
+  #endif
+  return(st_ramp_base_speed_change(time));
+}
+
+static float st_ramp_distance(float time)
+{
+  float distance = prep.ramp_entry_speed*time;
+  #ifdef INPUT_SHAPING
+    if (prep.ramp_impulses) {
+      uint8_t i;
+      for (i=0; i<prep.ramp_impulses; i++) {
+        distance += prep.shaper_amplitude[i]*st_ramp_base_distance(time-prep.shaper_time[i]);
+      }
+      return(distance);
+    }
+  #endif
+  return(distance+st_ramp_base_distance(time));
+}
+
+// Advances the ramp by time_var, unless it ends first, or mm_remaining would pass mm_end through
+// round-off. Returns the time spent in the ramp. At the end, mm_remaining is set to mm_end and
+// the caller sets the final speed.
+static float st_ramp_advance(float time_var, float *mm_remaining, float mm_end)
+{
+  float time = prep.ramp_time+time_var;
+  if (time < prep.ramp_duration) {
+    float mm_var = *mm_remaining-(st_ramp_distance(time)-st_ramp_distance(prep.ramp_time));
+    if (mm_var > mm_end) {
+      *mm_remaining = mm_var;
+      prep.ramp_time = time;
+      prep.current_speed = prep.ramp_entry_speed+st_ramp_speed_change(time);
+      return(time_var);
+    }
+  }
+  time_var = prep.ramp_duration-prep.ramp_time;
+  if (time_var < 0.0f) { time_var = 0.0f; }
+  prep.ramp_time = prep.ramp_duration;
+  *mm_remaining = mm_end;
+  return(time_var);
+}
+#endif
+
+#ifdef ST_RAMP_SHAPING
+/* Velocity profile of a block with extended ramps, as st_prep_buffer() computes it for constant
+   acceleration, with the ramp distances of plan_ramp_distance(). Where the block is too short to
+   reach its nominal speed, the peak speed, where the acceleration and deceleration ramps meet, is
+   bisected: their distances add up to less than the block below it.
+*/
+static void st_ramp_compute_profile()
 {
-  if (pl_block != NULL) { // Ignore if at start of a new block.
-    prep.recalculate_flag |= PREP_FLAG_RECALCULATE;
-    pl_block->entry_speed_sqr = prep.current_speed*prep.current_speed; // Update entry speed.
-    pl_block = NULL; // Flag st_prep_segment() to load and check active velocity profile.
+  float entry_speed = sqrtf(pl_block->entry_speed_sqr);
+  if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD) { // [Forced Deceleration to Zero Velocity]
+    prep.ramp_type = RAMP_DECEL;
+    float decel_dist = pl_block->millimeters - plan_ramp_distance(pl_block, entry_speed, 0.0f);
+    if (decel_dist < 0.0f) { // End of feed hold is not in this block.
+      prep.exit_speed = plan_ramp_exit_speed(pl_block, entry_speed, pl_block->millimeters);
+    } else {
+      prep.mm_complete = decel_dist; // End of feed hold.
+      prep.exit_speed = 0.0f;
+    }
+    return;
+  }
+
+  // [Normal Operation]
+  prep.ramp_type = RAMP_ACCEL;
+  prep.accelerate_until = pl_block->millimeters;
+  if (sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION) { prep.exit_speed = 0.0f; } // Enforce stop at end of system motion.
+  else { prep.exit_speed = sqrtf(plan_get_exec_block_exit_speed_sqr()); }
+  float nominal_speed = plan_compute_profile_nominal_speed(pl_block);
+
+  if (entry_speed > nominal_speed) { // Only occurs during override reductions.
+    prep.accelerate_until = pl_block->millimeters - plan_ramp_distance(pl_block, entry_speed, nominal_speed);
+    if (prep.accelerate_until <= 0.0f) { // Deceleration-only.
+      prep.ramp_type = RAMP_DECEL;
+      prep.exit_speed = plan_ramp_exit_speed(pl_block, entry_speed, pl_block->millimeters);
+      prep.recalculate_flag |= PREP_FLAG_DECEL_OVERRIDE; // Flag to load next block as deceleration override.
+    } else { // Decelerate to cruise or cruise-decelerate types.
+      prep.decelerate_after = plan_ramp_distance(pl_block, nominal_speed, prep.exit_speed);
+      prep.maximum_speed = nominal_speed;
+      prep.ramp_type = RAMP_DECEL_OVERRIDE;
+    }
+    return;
+  }
+
+  float accel_dist = plan_ramp_distance(pl_block, entry_speed, nominal_speed);
+  prep.decelerate_after = plan_ramp_distance(pl_block, nominal_speed, prep.exit_speed);
+  if (accel_dist+prep.decelerate_after <= pl_block->millimeters) { // Trapezoid type
+    prep.maximum_speed = nominal_speed;
+    if (entry_speed == nominal_speed) { prep.ramp_type = RAMP_CRUISE; } // Cruise-deceleration or cruise-only type.
+    else { prep.accelerate_until -= accel_dist; } // Full-trapezoid or acceleration-cruise types
+  } else if (plan_ramp_distance(pl_block, entry_speed, prep.exit_speed) >= pl_block->millimeters) {
+    if (prep.exit_speed > entry_speed) { // Acceleration-only type
+      prep.accelerate_until = 0.0f;
+      prep.maximum_speed = prep.exit_speed;
+    } else { // Deceleration-only type
+      prep.ramp_type = RAMP_DECEL;
+    }
+  } else { // Triangle type
+    float low = max(entry_speed, prep.exit_speed); // Ramps fit
+    float high = nominal_speed; // Ramps overlap
+    uint8_t i;
+    for (i=0; i<16; i++) {
+      float mid = 0.5f*(low+high);
+      if (plan_ramp_distance(pl_block, entry_speed, mid)+plan_ramp_distance(pl_block, mid, prep.exit_speed) > pl_block->millimeters) { high = mid; }
+      else { low = mid; }
+    }
+    prep.maximum_speed = low;
+    prep.accelerate_until -= plan_ramp_distance(pl_block, entry_speed, low);
+    prep.decelerate_after = plan_ramp_distance(pl_block, low, prep.exit_speed);
   }
 }
+#endif
 
 
-// Increments the step segment buffer block data ring buffer.
-static uint8_t st_next_block_index(uint8_t block_index)
+#ifdef PLANNER_ARC_BLOCKS
+/* Arc blocks. The velocity profile is traced along the helix as for a line, in virtual steps of
+   the fastest stepping axis, which bound the steps of every axis. Each segment then steps the chord
+   from the arc point the last one ended at to the point it ends at, with Bresenham data of its own.
+   The radius vector is turned on by the small angle approximation of mc_arc(), corrected exactly
+   every N_ARC_CORRECTION segments. Points are relative to the arc start, in steps, so the end of the
+   arc is exactly its target.
+*/
+
+// Starts tracing the arc of a newly loaded arc block. Called once prep.step_per_mm is set.
+static void st_arc_load()
 {
-  block_index++;
-  if ( block_index == (SEGMENT_BUFFER_SIZE-1) ) { return(0); }
-  return(block_index);
+  prep.arc = plan_get_current_arc();
+  memset(&prep.arc_point, 0, sizeof(st_arc_point_t));
+  prep.arc_point.r[0] = -prep.arc->offset[0];
+  prep.arc_point.r[1] = -prep.arc->offset[1];
+  prep.arc_block_used = false;
+
+  // Longest segment, the chord deviating $12 from the arc, scaled to the helix.
+  float radius = sqrtf(prep.arc_point.r[0]*prep.arc_point.r[0] + prep.arc_point.r[1]*prep.arc_point.r[1]);
+  float tolerance = min(settings.arc_tolerance, radius);
+  float chord = 2.0f*sqrtf(tolerance*(2.0f*radius - tolerance))*prep.arc->millimeters/(radius*fabsf(prep.arc->angular_travel));
+  #ifdef ST_PREP_FIXED_POINT
+    prep.arc_chord = max(st_fx_u64(chord*prep.step_per_mm*4294967296.0f), ST_FX_STEP);
+  #else
+    prep.arc_chord = max(chord, 1.0f/prep.step_per_mm);
+  #endif
 }
 
 
-#ifdef PARKING_ENABLE
-  // Changes the run state of the step segment buffer to execute the special parking motion.
-  void st_parking_setup_buffer()
-  {
-    // Store step execution data of partially completed block, if necessary.
-    if (prep.recalculate_flag & PREP_FLAG_HOLD_PARTIAL_BLOCK) {
-      prep.last_st_block_index = prep.st_block_index;
-      prep.last_steps_remaining = prep.steps_remaining;
-      prep.last_dt_remainder = prep.dt_remainder;
-      prep.last_step_per_mm = prep.step_per_mm;
+// Computes the point of the arc a fraction remaining of its length from its end into prep.arc_next.
+// Returns the step events of the chord to it from prep.arc_point, the steps of its dominant axis, and
+// in last_step the fraction of the chord traveled when that axis is halfway through its last step.
+static uint32_t st_arc_chord(float remaining, float *last_step)
+{
+  plan_arc_t *arc = prep.arc;
+  st_arc_point_t *point = &prep.arc_point;
+  st_arc_point_t *next = &prep.arc_next;
+  uint8_t idx;
+  if (remaining > 0.0f) {
+    float progress = 1.0f-remaining;
+    next->theta = arc->angular_travel*progress;
+    if (point->count < N_ARC_CORRECTION) {
+      // Turn the radius vector by the angle traveled since the last point.
+      float theta = next->theta - point->theta;
+      float cos_T = 2.0f - theta*theta;
+      float sin_T = theta*0.16666667f*(cos_T + 4.0f);
+      cos_T *= 0.5f;
+      next->r[0] = point->r[0]*cos_T - point->r[1]*sin_T;
+      next->r[1] = point->r[0]*sin_T + point->r[1]*cos_T;
+      next->count = point->count+1;
+    } else {
+      // Exact radius vector, from the start radius vector (= -offset).
+      float cos_Ti = cosf(next->theta);
+      float sin_Ti = sinf(next->theta);
+      next->r[0] = -arc->offset[0]*cos_Ti + arc->offset[1]*sin_Ti;
+      next->r[1] = -arc->offset[0]*sin_Ti - arc->offset[1]*cos_Ti;
+      next->count = 0;
     }
-    // Set flags to execute a parking motion
-    prep.recalculate_flag |= PREP_FLAG_PARKING;
-    prep.recalculate_flag &= ~(PREP_FLAG_RECALCULATE);
-    pl_block = NULL; // Always reset parking motion to reload new block.
+    for (idx=0; idx<N_AXIS; idx++) { next->point[idx] = arc->steps[idx]*progress; }
+    next->point[arc->axis_0] = (arc->offset[0] + next->r[0])*settings.steps_per_mm[arc->axis_0];
+    next->point[arc->axis_1] = (arc->offset[1] + next->r[1])*settings.steps_per_mm[arc->axis_1];
+    for (idx=0; idx<N_AXIS; idx++) { next->steps[idx] = lroundf(next->point[idx]); }
+  } else { // End of the arc.
+    for (idx=0; idx<N_AXIS; idx++) {
+      next->steps[idx] = arc->steps[idx];
+      next->point[idx] = arc->steps[idx];
+    }
+  }
+
+  uint32_t step_event_count = 0;
+  uint8_t dominant = 0;
+  for (idx=0; idx<N_AXIS; idx++) {
+    uint32_t steps = labs(next->steps[idx] - point->steps[idx]);
+    if (steps > step_event_count) {
+      step_event_count = steps;
+      dominant = idx;
+    }
+  }
+  *last_step = 1.0f;
+  if (step_event_count) {
+    // The dominant axis takes its last step when it passes halfway to the whole step it ends at.
+    float travel = next->point[dominant] - point->point[dominant];
+    float step_mid = next->steps[dominant] - ((travel > 0.0f) ? 0.5f : -0.5f);
+    *last_step = (step_mid - point->point[dominant])/travel;
+    if (*last_step > 1.0f) { *last_step = 1.0f; }
+    if (*last_step < 0.0f) { *last_step = 0.0f; }
   }
+  return(step_event_count);
+}
 
 
-  // Restores the step segment buffer to the normal run state after a parking motion.
-  void st_parking_restore_buffer()
-  {
-    // Restore step execution data and flags of partially completed block, if necessary.
-    if (prep.recalculate_flag & PREP_FLAG_HOLD_PARTIAL_BLOCK) {
-      st_prep_block = &st_block_buffer[prep.last_st_block_index];
-      prep.st_block_index = prep.last_st_block_index;
-      prep.steps_remaining = prep.last_steps_remaining;
-      prep.dt_remainder = prep.last_dt_remainder;
-      prep.step_per_mm = prep.last_step_per_mm;
-      prep.recalculate_flag = (PREP_FLAG_HOLD_PARTIAL_BLOCK | PREP_FLAG_RECALCULATE);
-      prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm; // Recompute this value.
-    } else {
-      prep.recalculate_flag = false;
+// Moves the arc trace on to prep.arc_next. If the segment has steps, loads the chord Bresenham data
+// into a stepper block of its own for it.
+static void st_arc_commit(segment_t *segment)
+{
+  if (segment->n_step) {
+    if (prep.arc_block_used) {
+      prep.st_block_index = st_next_block_index(prep.st_block_index);
+      st_block_t *st_block = &st_block_buffer[prep.st_block_index];
+      #ifdef VARIABLE_SPINDLE
+        st_block->is_pwm_rate_adjusted = st_prep_block->is_pwm_rate_adjusted;
+      #endif
+      st_prep_block = st_block;
     }
-    pl_block = NULL; // Set to reload next block.
+    prep.arc_block_used = true;
+    segment->st_block_index = prep.st_block_index;
+
+    uint32_t step_event_count = 0;
+    uint8_t idx;
+    st_prep_block->direction_bits = 0;
+    for (idx=0; idx<N_AXIS; idx++) {
+      int32_t steps = prep.arc_next.steps[idx] - prep.arc_point.steps[idx];
+      if (steps < 0) {
+        #ifdef STM32
+          st_prep_block->direction_bits |= direction_pin_mask[idx];
+        #elif ATMEGA328P
+          st_prep_block->direction_bits |= get_direction_pin_mask(idx);
+        #endif
+        steps = -steps;
+      }
+      step_event_count = max(step_event_count, (uint32_t)steps);
+      #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+        st_prep_block->steps[idx] = (uint32_t)steps << 1;
+      #else
+        st_prep_block->steps[idx] = (uint32_t)steps << MAX_AMASS_LEVEL;
+      #endif
+    }
+    #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      st_prep_block->step_event_count = step_event_count << 1;
+    #else
+      st_prep_block->step_event_count = step_event_count << MAX_AMASS_LEVEL;
+    #endif
   }
+  memcpy(&prep.arc_point, &prep.arc_next, sizeof(st_arc_point_t));
+}
 #endif
 
 
@@ -772,7 +2025,9 @@ static uint8_t st_next_block_index(uint8_t block_index)
    The number of steps "checked-out" from the planner buffer and the number of segments in
    the segment buffer is sized and computed such that no operation in the main program takes
    longer than the time it takes the stepper algorithm to empty it before refilling it.
-   Currently, the segment buffer conservatively holds roughly up to 40-50 msec of steps.
+   The segment buffer holds ST_BUFFER_TIME of steps after the executing segment: about 6 msec
+   with the 32 segments of 200 usec at ACCELERATION_TICKS_PER_SECOND 5000, or the $60 depth
+   with SEGMENT_BUFFER_ARENA.
    NOTE: Computation units are in steps, millimeters, and minutes.
 */
 void st_prep_buffer()
@@ -780,7 +2035,30 @@ void st_prep_buffer()
 	// Block step prep buffer, while in a suspend state and there is no suspend motion to execute.
 	if (bit_istrue(sys.step_control,STEP_CONTROL_END_MOTION)) { return; }
 
+	#ifdef ENABLE_PREP_PROFILE
+		// Only count while there is motion left to prep. The buffer drains normally at program end.
+		if (prep_profile_stepping && ((pl_block != NULL) || (plan_get_current_block() != NULL))) {
+			uint8_t tail = segment_buffer_tail;
+			uint8_t queued = segment_buffer_head - tail;
+			if (segment_buffer_head < tail) { queued += segment_buffer_size; }
+			if (queued < prep_profile.low_water) { prep_profile.low_water = queued; }
+			#ifdef SEGMENT_BUFFER_ARENA
+				uint32_t queued_time = (tail == segment_buffer_head) ? 0 : prep.buffer_time - segment_buffer[tail].end_time;
+				if (queued_time < prep_profile_time_low) { prep_profile_time_low = queued_time; }
+				prep_profile_time_sum += queued_time;
+				prep_profile_time_samples++;
+			#endif
+		}
+	#endif
+
 	while (segment_buffer_tail != segment_next_head) { // Check if we need to fill the buffer.
+		#ifdef ADAPTIVE_SEGMENT_DURATION
+			// Cruise segments are longer, so the buffer is filled with them in time rather than entries.
+			if ((prep.ramp_type == RAMP_CRUISE) && st_buffer_time_full()) { break; }
+		#endif
+		#ifdef ENABLE_PREP_PROFILE
+			uint32_t profile_start = GetCycleCount();
+		#endif
 
 		// Determine if we need to load a new planner block or if the block needs to be recomputed.
 		if (pl_block == NULL) {
@@ -811,31 +2089,63 @@ void st_prep_buffer()
 				st_prep_block = &st_block_buffer[prep.st_block_index];
 				st_prep_block->direction_bits = pl_block->direction_bits;
 				uint8_t idx;
+				uint32_t step_event_count = 0; // Not kept in the planner block. The largest axis step count.
+				for (idx=0; idx<N_AXIS; idx++) { step_event_count = max(step_event_count, pl_block->steps[idx]); }
 				#ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
 					for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = (pl_block->steps[idx] << 1); }
-					st_prep_block->step_event_count = (pl_block->step_event_count << 1);
+					st_prep_block->step_event_count = (step_event_count << 1);
 				#else
 					// With AMASS enabled, simply bit-shift multiply all Bresenham data by the max AMASS
 					// level, such that we never divide beyond the original data anywhere in the algorithm.
 					// If the original data is divided, we can lose a step from integer roundoff.
 					for (idx=0; idx<N_AXIS; idx++) { st_prep_block->steps[idx] = pl_block->steps[idx] << MAX_AMASS_LEVEL; }
-					st_prep_block->step_event_count = pl_block->step_event_count << MAX_AMASS_LEVEL;
+					st_prep_block->step_event_count = step_event_count << MAX_AMASS_LEVEL;
 				#endif
 
-				// Initialize segment buffer data for generating the segments.
-				prep.steps_remaining = (float)pl_block->step_event_count;
-				prep.step_per_mm = prep.steps_remaining/pl_block->millimeters;
-				prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm;
-				prep.dt_remainder = 0.0f; // Reset for new segment block
+				#ifdef ST_PREP_FIXED_POINT
+					// Initialize segment buffer data for generating the segments. The previous block exit
+					// speed is converted with the previous block scale.
+					float exit_speed = (prep.speed_scale > 0.0f) ? prep.exit_speed/prep.speed_scale : 0.0f;
+					prep.steps_remaining = step_event_count;
+					prep.steps_to_go = (uint64_t)step_event_count << 32;
+					prep.step_per_mm = step_event_count/pl_block->millimeters;
+					prep.dt_remainder = 0; // Reset for new segment block
+					st_fx_scale_block();
+
+					if ((sys.step_control & STEP_CONTROL_EXECUTE_HOLD) || (prep.recalculate_flag & PREP_FLAG_DECEL_OVERRIDE)) {
+						// New block loaded mid-hold. Override planner block entry speed to enforce deceleration.
+						prep.current_speed = st_fx_u32(exit_speed*prep.speed_scale);
+						pl_block->entry_speed_sqr = exit_speed*exit_speed;
+						prep.recalculate_flag &= ~(PREP_FLAG_DECEL_OVERRIDE);
+					} else {
+						prep.current_speed = st_fx_sqrt(st_fx_u64(pl_block->entry_speed_sqr*prep.speed_scale*prep.speed_scale));
+					}
+				#else
+					// Initialize segment buffer data for generating the segments.
+					prep.steps_remaining = (float)step_event_count;
+					prep.step_per_mm = prep.steps_remaining/pl_block->millimeters;
+					prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR/prep.step_per_mm;
+					prep.dt_remainder = 0.0f; // Reset for new segment block
+					#ifdef ST_RAMP_SHAPING
+						prep.ramp_duration = 0.0f; // No ramp to continue into a new block.
+					#endif
+					#ifdef INPUT_SHAPING
+						st_shaper_load();
+					#endif
+
+					if ((sys.step_control & STEP_CONTROL_EXECUTE_HOLD) || (prep.recalculate_flag & PREP_FLAG_DECEL_OVERRIDE)) {
+						// New block loaded mid-hold. Override planner block entry speed to enforce deceleration.
+						prep.current_speed = prep.exit_speed;
+						pl_block->entry_speed_sqr = prep.exit_speed*prep.exit_speed;
+						prep.recalculate_flag &= ~(PREP_FLAG_DECEL_OVERRIDE);
+					} else {
+						prep.current_speed = sqrtf(pl_block->entry_speed_sqr);
+					}
+				#endif
 
-				if ((sys.step_control & STEP_CONTROL_EXECUTE_HOLD) || (prep.recalculate_flag & PREP_FLAG_DECEL_OVERRIDE)) {
-					// New block loaded mid-hold. Override planner block entry speed to enforce deceleration.
-					prep.current_speed = prep.exit_speed;
-					pl_block->entry_speed_sqr = prep.exit_speed*prep.exit_speed;
-					prep.recalculate_flag &= ~(PREP_FLAG_DECEL_OVERRIDE);
-				} else {
-					prep.current_speed = sqrtf(pl_block->entry_speed_sqr);
-				}
+				#ifdef PLANNER_ARC_BLOCKS
+					if (pl_block->arc) { st_arc_load(); }
+				#endif
 
 				#ifdef VARIABLE_SPINDLE
 					// Setup laser mode variables. PWM rate adjusted motions will always complete a motion with the
@@ -857,8 +2167,102 @@ void st_prep_buffer()
 			 planner has updated it. For a commanded forced-deceleration, such as from a feed
 			 hold, override the planner velocities and decelerate to the target exit speed.
 			*/
+			#ifdef ST_PREP_FIXED_POINT
+			st_fx_scale_block();
+			prep.mm_complete = 0; // Default velocity profile complete at the end of block.
+			uint64_t millimeters = prep.steps_to_go;
+			uint64_t entry_speed_sqr = st_fx_u64(pl_block->entry_speed_sqr*prep.speed_scale*prep.speed_scale);
+			if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD) { // [Forced Deceleration to Zero Velocity]
+				// Compute velocity profile parameters for a feed hold in-progress. This profile overrides
+				// the planner block profile, enforcing a deceleration to zero speed.
+				prep.ramp_type = RAMP_DECEL;
+				// Compute decelerate distance relative to end of block.
+				uint64_t decel_dist = st_fx_ramp_distance(entry_speed_sqr);
+				if (decel_dist > millimeters) {
+					// Deceleration through entire planner block. End of feed hold is not in this block.
+					prep.exit_speed = st_fx_sqrt(entry_speed_sqr-st_fx_ramp_speed_sqr(millimeters));
+				} else {
+					prep.mm_complete = millimeters-decel_dist; // End of feed hold.
+					prep.exit_speed = 0;
+				}
+			} else { // [Normal Operation]
+				// Compute or recompute velocity profile parameters of the prepped planner block.
+				prep.ramp_type = RAMP_ACCEL; // Initialize as acceleration ramp.
+				prep.accelerate_until = millimeters;
+
+				uint64_t exit_speed_sqr;
+				if (sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION) {
+					prep.exit_speed = exit_speed_sqr = 0; // Enforce stop at end of system motion.
+				} else {
+					exit_speed_sqr = st_fx_u64(plan_get_exec_block_exit_speed_sqr()*prep.speed_scale*prep.speed_scale);
+					prep.exit_speed = st_fx_sqrt(exit_speed_sqr);
+				}
+
+				uint32_t nominal_speed = plan_compute_profile_nominal_speed_fixed(pl_block,
+								st_fx_u32(pl_block->programmed_rate*prep.speed_scale), st_fx_u32(pl_block->rapid_rate*prep.speed_scale),
+								st_fx_u32(MINIMUM_FEED_RATE*prep.speed_scale));
+				uint64_t nominal_speed_sqr = (uint64_t)nominal_speed*nominal_speed;
+				// Signed intersect_distance of the float generator, as a magnitude and sign.
+				uint64_t intersect_distance;
+				uint8_t intersect_positive;
+				if (entry_speed_sqr >= exit_speed_sqr) {
+					intersect_distance = (millimeters+st_fx_ramp_distance(entry_speed_sqr-exit_speed_sqr)) >> 1;
+					intersect_positive = (intersect_distance > 0);
+				} else {
+					uint64_t exit_dist = st_fx_ramp_distance(exit_speed_sqr-entry_speed_sqr);
+					intersect_positive = (millimeters > exit_dist);
+					intersect_distance = intersect_positive ? ((millimeters-exit_dist) >> 1) : 0;
+				}
+
+				if (entry_speed_sqr > nominal_speed_sqr) { // Only occurs during override reductions.
+					uint64_t decel_dist = st_fx_ramp_distance(entry_speed_sqr-nominal_speed_sqr);
+					if (decel_dist >= millimeters) { // Deceleration-only.
+						prep.ramp_type = RAMP_DECEL;
+
+						// Compute override block exit speed since it doesn't match the planner exit speed.
+						prep.exit_speed = st_fx_sqrt(entry_speed_sqr-st_fx_ramp_speed_sqr(millimeters));
+						prep.recalculate_flag |= PREP_FLAG_DECEL_OVERRIDE; // Flag to load next block as deceleration override.
+					} else {
+						// Decelerate to cruise or cruise-decelerate types. Guaranteed to intersect updated plan.
+						prep.accelerate_until = millimeters-decel_dist;
+						prep.decelerate_after = (nominal_speed_sqr > exit_speed_sqr) ? st_fx_ramp_distance(nominal_speed_sqr-exit_speed_sqr) : 0;
+						prep.maximum_speed = nominal_speed;
+						prep.ramp_type = RAMP_DECEL_OVERRIDE;
+					}
+				} else if (intersect_positive) {
+					if (intersect_distance < millimeters) { // Either trapezoid or triangle types
+						// NOTE: For acceleration-cruise and cruise-only types, following calculation will be 0.
+						prep.decelerate_after = (nominal_speed_sqr > exit_speed_sqr) ? st_fx_ramp_distance(nominal_speed_sqr-exit_speed_sqr) : 0;
+						if (prep.decelerate_after < intersect_distance) { // Trapezoid type
+							prep.maximum_speed = nominal_speed;
+							if (entry_speed_sqr == nominal_speed_sqr) {
+								// Cruise-deceleration or cruise-only type.
+								prep.ramp_type = RAMP_CRUISE;
+							} else {
+								// Full-trapezoid or acceleration-cruise types
+								uint64_t accel_dist = st_fx_ramp_distance(nominal_speed_sqr-entry_speed_sqr);
+								prep.accelerate_until = (accel_dist < millimeters) ? millimeters-accel_dist : 0;
+							}
+						} else { // Triangle type
+							prep.accelerate_until = intersect_distance;
+							prep.decelerate_after = intersect_distance;
+							prep.maximum_speed = st_fx_sqrt(st_fx_ramp_speed_sqr(intersect_distance)+exit_speed_sqr);
+						}
+					} else { // Deceleration-only type
+						prep.ramp_type = RAMP_DECEL;
+					}
+				} else { // Acceleration-only type
+					prep.accelerate_until = 0;
+					prep.maximum_speed = prep.exit_speed;
+				}
+			}
+			#else
 			prep.mm_complete = 0.0f; // Default velocity profile complete at 0.0mm from end of block.
 			float inv_2_accel = 0.5f/pl_block->pbacceleration;
+			#ifdef ST_RAMP_SHAPING
+			if (plan_ramp_extended(pl_block)) { st_ramp_compute_profile(); }
+			else
+			#endif
 			if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD) { // [Forced Deceleration to Zero Velocity]
 				// Compute velocity profile parameters for a feed hold in-progress. This profile overrides
 				// the planner block profile, enforcing a deceleration to zero speed.
@@ -941,6 +2345,10 @@ void st_prep_buffer()
 					prep.maximum_speed = prep.exit_speed;
 				}
 			}
+			#ifdef ST_RAMP_SHAPING
+				st_ramp_begin(pl_block->millimeters);
+			#endif
+			#endif
 
 			#ifdef VARIABLE_SPINDLE
 				bit_true(sys.step_control, STEP_CONTROL_UPDATE_SPINDLE_PWM); // Force update whenever updating block.
@@ -949,6 +2357,9 @@ void st_prep_buffer()
 
 		// Initialize new segment
 		segment_t *prep_segment = &segment_buffer[segment_buffer_head];
+		#ifdef ENABLE_PREP_PROFILE
+			uint8_t profile_ramp = prep.ramp_type; // Attribute the segment to the ramp it starts in.
+		#endif
 
 		// Set new segment to point to the current segment data block.
 		prep_segment->st_block_index = prep.st_block_index;
@@ -967,11 +2378,130 @@ void st_prep_buffer()
 			the end of planner block (typical) or mid-block at the end of a forced deceleration,
 			such as from a feed hold.
 		*/
+		#ifdef ST_PREP_FIXED_POINT
+		uint32_t dt_segment = STEP_TIMER_CLOCK/ACCELERATION_TICKS_PER_SECOND;
+		uint32_t dt_max = dt_segment; // Maximum segment time (ticks)
+		#ifdef ADAPTIVE_SEGMENT_DURATION
+			// Long segment in cruise. Cut back to dt_segment if the cruise ends within it.
+			if (prep.ramp_type == RAMP_CRUISE) {
+				uint32_t cruise_time = st_cruise_segment_time();
+				if (cruise_time > dt_max) { dt_max = cruise_time; }
+			}
+		#endif
+		#ifdef PLANNER_ARC_BLOCKS
+			// Keep the chord of an arc block within $12, at the highest speed the segment can reach.
+			if (pl_block->arc) {
+				uint32_t chord_time = st_fx_time(prep.arc_chord, max(prep.current_speed, prep.maximum_speed));
+				if ((chord_time > 0) && (dt_max > chord_time)) { dt_max = chord_time; }
+			}
+		#endif
+		uint32_t dt = 0; // Initialize segment time
+		uint32_t time_var = dt_max; // Time worker variable
+		uint64_t mm_var; // Distance worker variable (Q32.32 steps)
+		uint32_t speed_var; // Speed worker variable (Q.40 steps/tick)
+		uint64_t mm_remaining = prep.steps_to_go; // New segment distance from end of block.
+		uint64_t minimum_mm = (mm_remaining > ST_FX_REQ_INCREMENT) ? mm_remaining-ST_FX_REQ_INCREMENT : 0; // Guarantee at least one step.
+
+		do {
+			switch (prep.ramp_type) {
+				case RAMP_DECEL_OVERRIDE:
+					speed_var = ((uint64_t)prep.acceleration*time_var) >> 20;
+					if (prep.current_speed <= (uint64_t)prep.maximum_speed+speed_var) {
+						// Cruise or cruise-deceleration types only for deceleration override.
+						time_var = st_fx_time(2*(mm_remaining-prep.accelerate_until), (uint64_t)prep.current_speed+prep.maximum_speed);
+						mm_remaining = prep.accelerate_until;
+						prep.ramp_type = RAMP_CRUISE;
+						prep.current_speed = prep.maximum_speed;
+					} else { // Mid-deceleration override ramp.
+						mm_remaining -= st_fx_distance(time_var, prep.current_speed-(speed_var >> 1));
+						prep.current_speed -= speed_var;
+					}
+					break;
+				case RAMP_ACCEL:
+					// NOTE: Acceleration ramp only computes during first do-while loop.
+					speed_var = ((uint64_t)prep.acceleration*time_var) >> 20;
+					mm_var = st_fx_distance(time_var, prep.current_speed+(speed_var >> 1));
+					if (mm_var > mm_remaining-prep.accelerate_until) { // End of acceleration ramp.
+						// Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+						// NOTE: Timed from this pass, which is not the first one in a slow segment.
+						time_var = st_fx_time(2*(mm_remaining-prep.accelerate_until), (uint64_t)prep.current_speed+prep.maximum_speed);
+						mm_remaining = prep.accelerate_until; // NOTE: 0 at EOB
+						if (mm_remaining == prep.decelerate_after) { prep.ramp_type = RAMP_DECEL; }
+						else { prep.ramp_type = RAMP_CRUISE; }
+						prep.current_speed = prep.maximum_speed;
+					} else { // Acceleration only.
+						mm_remaining -= mm_var;
+						prep.current_speed += speed_var;
+					}
+					break;
+				case RAMP_CRUISE:
+					mm_var = st_fx_distance(time_var, prep.maximum_speed);
+					if ((mm_remaining <= prep.decelerate_after) || (mm_var > mm_remaining-prep.decelerate_after)) { // End of cruise.
+						// Cruise-deceleration junction or end of block.
+						time_var = (mm_remaining > prep.decelerate_after) ? st_fx_time(mm_remaining-prep.decelerate_after, prep.maximum_speed) : 0;
+						mm_remaining = prep.decelerate_after; // NOTE: 0 at EOB
+						prep.ramp_type = RAMP_DECEL;
+						#ifdef ADAPTIVE_SEGMENT_DURATION
+							// Kept, if shorter for an arc chord. Never cut below the time already in the segment,
+							// which a step longer than the cruise segment has taken past dt_segment.
+							if (dt_max > dt_segment) { dt_max = max(dt, dt_segment); }
+						#endif
+					} else { // Cruising only.
+						mm_remaining -= mm_var;
+					}
+					break;
+				default: // case RAMP_DECEL:
+					speed_var = ((uint64_t)prep.acceleration*time_var) >> 20; // Used as delta speed
+					if (prep.current_speed > speed_var) { // Check if at or below zero speed.
+						// Compute distance from end of segment to end of block.
+						mm_var = st_fx_distance(time_var, prep.current_speed-(speed_var >> 1));
+						if (mm_var < mm_remaining-prep.mm_complete) { // Typical case. In deceleration ramp.
+							mm_remaining -= mm_var;
+							prep.current_speed -= speed_var;
+							break; // Segment complete. Exit switch-case statement. Continue do-while loop.
+						}
+					}
+					// Otherwise, at end of block or end of forced-deceleration.
+					time_var = st_fx_time(2*(mm_remaining-prep.mm_complete), (uint64_t)prep.current_speed+prep.exit_speed);
+					mm_remaining = prep.mm_complete;
+					prep.current_speed = prep.exit_speed;
+			}
+			dt += time_var; // Add computed ramp time to total segment time.
+			if (dt < dt_max) { time_var = dt_max - dt; } // **Incomplete** At ramp junction.
+			else {
+				if (mm_remaining > minimum_mm) { // Check for very slow segments with zero steps.
+					// Increase segment time to ensure at least one step in segment. Override and loop
+					// through distance calculations until minimum_mm or mm_complete.
+					dt_max += dt_segment;
+					if (dt_max <= dt) { dt_max = dt+dt_segment; } // Ramp junction past it. Unsigned, must not wrap.
+					time_var = dt_max - dt;
+				} else {
+					break; // **Complete** Exit loop. Segment execution time maxed.
+				}
+			}
+		} while (mm_remaining > prep.mm_complete); // **Complete** Exit loop. Profile complete.
+		#else
 		float dt_max = DT_SEGMENT; // Maximum segment time
+		#ifdef ADAPTIVE_SEGMENT_DURATION
+			// Long segment in cruise. Cut back to DT_SEGMENT if the cruise ends within it.
+			if (prep.ramp_type == RAMP_CRUISE) {
+				float cruise_time = st_cruise_segment_time();
+				if (cruise_time > dt_max) { dt_max = cruise_time; }
+			}
+		#endif
+		#ifdef PLANNER_ARC_BLOCKS
+			// Keep the chord of an arc block within $12, at the highest speed the segment can reach.
+			if (pl_block->arc) {
+				float chord_speed = max(prep.current_speed, prep.maximum_speed);
+				if (chord_speed*dt_max > prep.arc_chord) { dt_max = prep.arc_chord/chord_speed; }
+			}
+		#endif
 		float dt = 0.0f; // Initialize segment time
 		float time_var = dt_max; // Time worker variable
 		float mm_var; // mm-Distance worker variable
-		float speed_var; // Speed worker variable
+		#ifndef ST_RAMP_SHAPING
+			float speed_var; // Speed worker variable
+		#endif
 		float mm_remaining = pl_block->millimeters; // New segment distance from end of block.
 		float minimum_mm = mm_remaining-prep.req_mm_increment; // Guarantee at least one step.
 		if (minimum_mm < 0.0f) { minimum_mm = 0.0f; }
@@ -979,32 +2509,50 @@ void st_prep_buffer()
 		do {
 			switch (prep.ramp_type) {
 				case RAMP_DECEL_OVERRIDE:
+					#ifdef ST_RAMP_SHAPING
+						time_var = st_ramp_advance(time_var, &mm_remaining, prep.accelerate_until);
+						if (prep.ramp_time < prep.ramp_duration) { break; } // Mid-deceleration override ramp.
+						prep.ramp_type = RAMP_CRUISE;
+						prep.current_speed = prep.maximum_speed;
+					#else
 					speed_var = pl_block->pbacceleration*time_var;
 					if (prep.current_speed-prep.maximum_speed <= speed_var) {
 						// Cruise or cruise-deceleration types only for deceleration override.
+						time_var = 2.0f*(mm_remaining-prep.accelerate_until)/(prep.current_speed+prep.maximum_speed);
 						mm_remaining = prep.accelerate_until;
-						time_var = 2.0f*(pl_block->millimeters-mm_remaining)/(prep.current_speed+prep.maximum_speed);
 						prep.ramp_type = RAMP_CRUISE;
 						prep.current_speed = prep.maximum_speed;
 					} else { // Mid-deceleration override ramp.
 						mm_remaining -= time_var*(prep.current_speed - 0.5f*speed_var);
 						prep.current_speed -= speed_var;
 					}
+					#endif
 					break;
 				case RAMP_ACCEL:
 					// NOTE: Acceleration ramp only computes during first do-while loop.
+					#ifdef ST_RAMP_SHAPING
+						time_var = st_ramp_advance(time_var, &mm_remaining, prep.accelerate_until);
+						if (prep.ramp_time < prep.ramp_duration) { break; } // Acceleration only.
+						if (mm_remaining == prep.decelerate_after) { prep.ramp_type = RAMP_DECEL; }
+						else { prep.ramp_type = RAMP_CRUISE; }
+						prep.current_speed = prep.maximum_speed;
+						st_ramp_begin(mm_remaining);
+					#else
 					speed_var = pl_block->pbacceleration*time_var;
-					mm_remaining -= time_var*(prep.current_speed + 0.5f*speed_var);
-					if (mm_remaining < prep.accelerate_until) { // End of acceleration ramp.
+					mm_var = mm_remaining - time_var*(prep.current_speed + 0.5f*speed_var);
+					if (mm_var < prep.accelerate_until) { // End of acceleration ramp.
 						// Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
+						// NOTE: Timed from this pass, which is not the first one in a slow segment.
+						time_var = 2.0f*(mm_remaining-prep.accelerate_until)/(prep.current_speed+prep.maximum_speed);
 						mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
-						time_var = 2.0f*(pl_block->millimeters-mm_remaining)/(prep.current_speed+prep.maximum_speed);
 						if (mm_remaining == prep.decelerate_after) { prep.ramp_type = RAMP_DECEL; }
 						else { prep.ramp_type = RAMP_CRUISE; }
 						prep.current_speed = prep.maximum_speed;
 					} else { // Acceleration only.
+						mm_remaining = mm_var;
 						prep.current_speed += speed_var;
 					}
+					#endif
 					break;
 				case RAMP_CRUISE:
 					// NOTE: mm_var used to retain the last mm_remaining for incomplete segment time_var calculations.
@@ -1016,11 +2564,24 @@ void st_prep_buffer()
 						time_var = (mm_remaining - prep.decelerate_after)/prep.maximum_speed;
 						mm_remaining = prep.decelerate_after; // NOTE: 0.0 at EOB
 						prep.ramp_type = RAMP_DECEL;
+						#ifdef ADAPTIVE_SEGMENT_DURATION
+							// Kept, if shorter for an arc chord. Never cut below the time already in the segment,
+							// which a step longer than the cruise segment has taken past DT_SEGMENT.
+							if (dt_max > DT_SEGMENT) { dt_max = max(dt, DT_SEGMENT); }
+						#endif
+						#ifdef ST_RAMP_SHAPING
+							st_ramp_begin(mm_remaining);
+						#endif
 					} else { // Cruising only.
 						mm_remaining = mm_var;
 					}
 					break;
 				default: // case RAMP_DECEL:
+					#ifdef ST_RAMP_SHAPING
+						time_var = st_ramp_advance(time_var, &mm_remaining, prep.mm_complete);
+						if (prep.ramp_time < prep.ramp_duration) { break; } // In deceleration ramp.
+						prep.current_speed = prep.exit_speed; // End of block or end of forced-deceleration.
+					#else
 					// NOTE: mm_var used as a misc worker variable to prevent errors when near zero speed.
 					speed_var = pl_block->pbacceleration*time_var; // Used as delta speed (mm/min)
 					if (prep.current_speed > speed_var) { // Check if at or below zero speed.
@@ -1034,8 +2595,18 @@ void st_prep_buffer()
 					}
 					// Otherwise, at end of block or end of forced-deceleration.
 					time_var = 2.0f*(mm_remaining-prep.mm_complete)/(prep.current_speed+prep.exit_speed);
+					#ifdef PLANNER_ARC_BLOCKS
+						if (pl_block->arc) {
+							// Round-off over the length of an arc block can leave a sliver of distance past zero
+							// speed, which the division above would stretch over a long time. Take no longer than
+							// braking through it would.
+							float brake_time = sqrtf(2.0f*(mm_remaining-prep.mm_complete)/pl_block->pbacceleration);
+							if (time_var > brake_time) { time_var = brake_time; }
+						}
+					#endif
 					mm_remaining = prep.mm_complete;
 					prep.current_speed = prep.exit_speed;
+					#endif
 			}
 			dt += time_var; // Add computed ramp time to total segment time.
 			if (dt < dt_max) { time_var = dt_max - dt; } // **Incomplete** At ramp junction.
@@ -1050,6 +2621,7 @@ void st_prep_buffer()
 				}
 			}
 		} while (mm_remaining > prep.mm_complete); // **Complete** Exit loop. Profile complete.
+		#endif
 
 		#ifdef VARIABLE_SPINDLE
 			/* -----------------------------------------------------------------------------------
@@ -1060,7 +2632,7 @@ void st_prep_buffer()
 				if (pl_block->condition & (PL_COND_FLAG_SPINDLE_CW | PL_COND_FLAG_SPINDLE_CCW)) {
 					float rpm = pl_block->spindle_speed;
 					// NOTE: Feed and rapid overrides are independent of PWM value and do not alter laser power/rate.
-					if (st_prep_block->is_pwm_rate_adjusted) { rpm *= (prep.current_speed * prep.inv_rate); }
+					if (st_prep_block->is_pwm_rate_adjusted) { rpm *= (st_prep_current_speed() * prep.inv_rate); }
 					// If current_speed is zero, then may need to be rpm_min*(100/MAX_SPINDLE_SPEED_OVERRIDE)
 					// but this would be instantaneous only and during a motion. May not matter at all.
 					prep.current_spindle_pwm = spindle_compute_pwm_value(rpm);
@@ -1084,10 +2656,28 @@ void st_prep_buffer()
 			 Fortunately, this scenario is highly unlikely and unrealistic in CNC machines
 			 supported by Grbl (i.e. exceeding 10 meters axis travel at 200 step/mm).
 		*/
-		float step_dist_remaining = prep.step_per_mm*mm_remaining; // Convert mm_remaining to steps
-		float n_steps_remaining = ceilf(step_dist_remaining); // Round-up current steps remaining
-		float last_n_steps_remaining = ceilf(prep.steps_remaining); // Round-up last steps remaining
-		prep_segment->n_step = (uint16_t)(last_n_steps_remaining-n_steps_remaining); // Compute number of steps to execute.
+		#ifdef ST_PREP_FIXED_POINT
+			// The fixed-point distance is already in steps. steps_remaining is always whole.
+			uint32_t n_steps_remaining = (mm_remaining + ST_FX_STEP-1) >> 32; // Round-up current steps remaining
+			prep_segment->n_step = (uint16_t)(prep.steps_remaining-n_steps_remaining); // Compute number of steps to execute.
+		#else
+			float step_dist_remaining = prep.step_per_mm*mm_remaining; // Convert mm_remaining to steps
+			float n_steps_remaining = ceilf(step_dist_remaining); // Round-up current steps remaining
+			float last_n_steps_remaining = ceilf(prep.steps_remaining); // Round-up last steps remaining
+			prep_segment->n_step = (uint16_t)(last_n_steps_remaining-n_steps_remaining); // Compute number of steps to execute.
+		#endif
+		#ifdef PLANNER_ARC_BLOCKS
+			// An arc block steps the chord to the point of the arc the segment ends at instead.
+			float arc_last_step = 1.0f;
+			if (pl_block->arc) {
+				#ifdef ST_PREP_FIXED_POINT
+					float arc_remaining = (float)(mm_remaining >> 16)/(prep.step_per_mm*65536.0f*prep.arc->millimeters);
+				#else
+					float arc_remaining = mm_remaining/prep.arc->millimeters;
+				#endif
+				prep_segment->n_step = (uint16_t)st_arc_chord(arc_remaining, &arc_last_step);
+			}
+		#endif
 
 		// Bail if we are at the end of a feed hold and don't have a step to execute.
 		if (prep_segment->n_step == 0) {
@@ -1111,26 +2701,67 @@ void st_prep_buffer()
 		// typically very small and do not adversely effect performance, but ensures that Grbl
 		// outputs the exact acceleration and velocity profiles as computed by the planner.
 		dt += prep.dt_remainder; // Apply previous segment partial step execute time
-		float inv_rate = dt/(last_n_steps_remaining - step_dist_remaining); // Compute adjusted step rate inverse
+		// Rounding the step timing up makes each segment step slightly long, which adds up over a
+		// block to a rate error of up to one timer tick per step. It is taken back from the following
+		// segments, at most an eighth of each, so a short one does not step noticeably faster.
+		#ifdef ST_PREP_FIXED_POINT
+			uint32_t dt_excess = min(prep.dt_excess, dt >> 3);
+		#else
+			float dt_excess = min(prep.dt_excess, 0.125f*dt);
+		#endif
+		dt -= dt_excess;
+		prep.dt_excess -= dt_excess;
+		#ifdef ST_PREP_FIXED_POINT
+			// Steps of the segment including the partial steps, then CPU cycles per step, rounded up.
+			uint64_t step_dist = ((uint64_t)prep.steps_remaining << 32) - mm_remaining;
+			uint64_t cycles_fx = 0xffffffff;
+			if (step_dist) { cycles_fx = (((uint64_t)dt << 32) + step_dist-1)/step_dist; }
+			uint32_t cycles = (cycles_fx < 0xffffffff) ? (uint32_t)cycles_fx : 0xffffffff; // (cycles/step)
+		#else
+			float inv_rate = dt/(last_n_steps_remaining - step_dist_remaining); // Compute adjusted step rate inverse
 
-		// Compute CPU cycles per step for the prepped segment.
-		//uint32_t cycles = (uint32_t)ceilf( (TICKS_PER_MICROSECOND*1000000.0f*60.0f)*inv_rate ); // (cycles/step)
-		uint32_t cycles = (uint32_t)ceilf(fTICKS_PER_MINUTE*inv_rate); // (cycles/step)
+			// Compute step timer ticks per step for the prepped segment.
+			//uint32_t cycles = (uint32_t)ceilf( (TICKS_PER_MICROSECOND*1000000.0f*60.0f)*inv_rate ); // (cycles/step)
+			float cycles_f = ceilf(fTICKS_PER_MINUTE*inv_rate);
+			uint32_t cycles = (cycles_f < 4294967295.0f) ? (uint32_t)cycles_f : 0xffffffff; // (cycles/step)
+		#endif
+		#ifdef PLANNER_ARC_BLOCKS
+			// The chord steps at the rate that puts its last step at the time the arc passes it. The
+			// rest of the segment carries over to the next one, all of it if the chord has no steps.
+			#ifdef ST_PREP_FIXED_POINT
+				uint32_t arc_remainder = dt;
+				if (pl_block->arc && prep_segment->n_step) {
+					arc_remainder = (uint32_t)((dt-prep.dt_remainder)*(1.0f-arc_last_step));
+					cycles = (dt-arc_remainder + prep_segment->n_step-1)/prep_segment->n_step;
+				}
+			#else
+				float arc_remainder = dt;
+				if (pl_block->arc && prep_segment->n_step) {
+					arc_remainder = (dt-prep.dt_remainder)*(1.0f-arc_last_step);
+					cycles_f = ceilf(fTICKS_PER_MINUTE*(dt-arc_remainder)/prep_segment->n_step);
+					cycles = (cycles_f < 4294967295.0f) ? (uint32_t)cycles_f : 0xffffffff;
+				}
+			#endif
+		#endif
+		// Steps and their time, before AMASS scales them.
+		uint16_t step_count = prep_segment->n_step;
+		uint64_t step_time = (uint64_t)cycles*step_count; // (ticks)
 
 
 		#ifdef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
 			// Compute step timing and multi-axis smoothing level.
 			// NOTE: AMASS overdrives the timer with each level, so only one prescalar is required.
-			if (cycles < AMASS_LEVEL1) { prep_segment->amass_level = 0; }
-			else {
-				if (cycles < AMASS_LEVEL2) { prep_segment->amass_level = 1; }
-				else if (cycles < AMASS_LEVEL3) { prep_segment->amass_level = 2; }
-				else { prep_segment->amass_level = 3; }
-				cycles >>= prep_segment->amass_level;
-				prep_segment->n_step <<= prep_segment->amass_level;
-			}
-			if (cycles < (1UL << 16)) { prep_segment->cycles_per_tick = cycles; } // < 65536 (4.1ms @ 16MHz)
-			else { prep_segment->cycles_per_tick = 0xffff; } // Just set the slowest speed possible.
+			uint8_t amass_level = 0;
+			while ((amass_level < MAX_AMASS_LEVEL) && (cycles >= (amass_isr_ticks << (amass_level+1)))) { amass_level++; }
+			prep_segment->amass_level = amass_level;
+			cycles >>= amass_level;
+			prep_segment->n_step <<= amass_level;
+			if (cycles < ST_CYCLES_MAX) { prep_segment->cycles_per_tick = cycles; } // < 65536 (0.9ms @ 72MHz) for 16-bit
+			else { prep_segment->cycles_per_tick = ST_CYCLES_MAX; } // Just set the slowest speed possible.
+		#elif defined(STEP_TIMER_32BIT)
+			// A 32-bit period covers 51s per step at 84MHz, slower than any feed rate.
+			prep_segment->prescaler = 0;
+			prep_segment->cycles_per_tick = cycles;
 		#else
 			// Compute step timing and timer prescalar for normal step generation.
 			if (cycles < (1UL << 16)) { // < 65536  (4.1ms @ 16MHz)
@@ -1149,19 +2780,70 @@ void st_prep_buffer()
 			}
 		#endif
 
-		// Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
-		segment_buffer_head = segment_next_head;
-		if ( ++segment_next_head == SEGMENT_BUFFER_SIZE ) { segment_next_head = 0; }
+		// Queue the segment. The chord of an arc block without steps is not, its time carries over.
+		uint8_t queue_segment = true;
+		#ifdef PLANNER_ARC_BLOCKS
+			if (pl_block->arc) {
+				st_arc_commit(prep_segment);
+				queue_segment = (prep_segment->n_step != 0);
+			}
+		#endif
+		if (queue_segment) {
+			#ifdef ST_BUFFER_TIMING
+				#ifdef ST_PREP_FIXED_POINT
+					prep.buffer_time += dt;
+				#else
+					prep.buffer_time += (uint32_t)(dt*fTICKS_PER_MINUTE);
+				#endif
+				prep_segment->end_time = prep.buffer_time;
+				#ifdef STEP_PULSE_DMA
+					prep.buffer_ticks += prep_segment->n_step;
+					prep_segment->end_tick = prep.buffer_ticks;
+				#endif
+			#endif
+
+			// Segment complete! Increment segment buffer indices, so stepper ISR can immediately execute it.
+			segment_buffer_head = segment_next_head;
+			if ( ++segment_next_head == segment_buffer_size ) { segment_next_head = 0; }
+
+			#ifdef ENABLE_PREP_PROFILE
+				uint32_t profile_cycles = GetCycleCount() - profile_start;
+				prep_profile.segments[profile_ramp]++;
+				prep_profile.cycles[profile_ramp] += profile_cycles;
+				if (profile_cycles > prep_profile.cycles_max[profile_ramp]) { prep_profile.cycles_max[profile_ramp] = profile_cycles; }
+			#endif
+		}
 
 		// Update the appropriate planner and segment data.
-		pl_block->millimeters = mm_remaining;
-		prep.steps_remaining = n_steps_remaining;
-		prep.dt_remainder = (n_steps_remaining - step_dist_remaining)*inv_rate;
+		#ifdef ST_PREP_FIXED_POINT
+			pl_block->millimeters = (float)(mm_remaining >> 16)/(prep.step_per_mm*65536.0f);
+			prep.steps_to_go = mm_remaining;
+			if (step_dist) { prep.dt_remainder = ((((uint64_t)n_steps_remaining << 32) - mm_remaining)*dt)/step_dist; }
+			prep.steps_remaining = n_steps_remaining;
+		#else
+			pl_block->millimeters = mm_remaining;
+			prep.steps_remaining = n_steps_remaining;
+			prep.dt_remainder = (n_steps_remaining - step_dist_remaining)*inv_rate;
+		#endif
+		#ifdef PLANNER_ARC_BLOCKS
+			if (pl_block->arc) { prep.dt_remainder = arc_remainder; }
+		#endif
+		// Time the steps take over their share of the segment, less than a tick per step.
+		#ifdef ST_PREP_FIXED_POINT
+			if (step_time > dt-prep.dt_remainder) {
+				prep.dt_excess += min(step_time-(dt-prep.dt_remainder), step_count);
+			}
+		#else
+			float dt_steps = dt-prep.dt_remainder;
+			if (step_time > dt_steps*fTICKS_PER_MINUTE) {
+				prep.dt_excess += min(step_time/fTICKS_PER_MINUTE-dt_steps, step_count/fTICKS_PER_MINUTE);
+			}
+		#endif
 
 		// Check for exit conditions and flag to load next planner block.
 		if (mm_remaining == prep.mm_complete) {
 			// End of planner block or forced-termination. No more distance to be executed.
-			if (mm_remaining > 0.0f) { // At end of forced-termination.
+			if (mm_remaining > 0) { // At end of forced-termination.
 				// Reset prep parameters for resuming and then bail. Allow the stepper ISR to complete
 				// the segment queue, where realtime protocol will set new state upon receiving the
 				// cycle stop flag from the ISR. Prep_segment is blocked until then.
@@ -1188,6 +2870,40 @@ void st_prep_buffer()
 
 
 
+#ifdef ENABLE_PREP_PROFILE
+st_prep_profile_t *st_get_prep_profile()
+{
+  if (prep_profile.low_water > segment_buffer_size) { prep_profile.low_water = segment_buffer_size; }
+  #ifdef SEGMENT_BUFFER_ARENA
+    prep_profile.buffer_size = segment_buffer_size;
+    prep_profile.depth_us = ((uint64_t)segment_buffer_depth*1000000)/STEP_TIMER_CLOCK;
+    prep_profile.low_water_us = (prep_profile_time_low < segment_buffer_depth) ?
+      ((uint64_t)prep_profile_time_low*1000000)/STEP_TIMER_CLOCK : prep_profile.depth_us;
+    prep_profile.mean_us = prep_profile_time_samples ?
+      (prep_profile_time_sum*1000000)/((uint64_t)prep_profile_time_samples*STEP_TIMER_CLOCK) : 0;
+  #endif
+  return(&prep_profile);
+}
+
+void st_prep_profile_reset()
+{
+  memset(&prep_profile, 0, sizeof(st_prep_profile_t));
+  prep_profile.low_water = 0xff; // Cut to the buffer size when read.
+  #ifdef SEGMENT_BUFFER_ARENA
+    prep_profile_time_low = 0xffffffff;
+    prep_profile_time_sum = 0;
+    prep_profile_time_samples = 0;
+  #endif
+}
+#endif
+
+#ifdef ENABLE_STEP_ISR_PROFILE
+st_isr_profile_t *st_get_isr_profile() { return(&isr_profile); }
+
+void st_isr_profile_reset() { memset(&isr_profile, 0, sizeof(st_isr_profile_t)); }
+#endif
+
+
 // Called by realtime status reporting to fetch the current speed being executed. This value
 // however is not exactly the current speed, but the speed computed in the last step segment
 // in the segment buffer. It will always be behind by up to the number of segment blocks (-1)
@@ -1195,7 +2911,7 @@ void st_prep_buffer()
 float st_get_realtime_rate()
 {
   if (sys.state & (STATE_CYCLE | STATE_HOMING | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)){
-    return prep.current_speed;
+    return st_prep_current_speed();
   }
   return 0.0f;
 }
@@ -35,6 +35,25 @@
 	#endif
 #endif
 
+#ifdef SEGMENT_BUFFER_ARENA
+	// RAM the segment buffer and its block data are laid out in, in bytes. Bounds the $60 depth.
+	#ifndef SEGMENT_BUFFER_ARENA_SIZE
+		#ifdef STM32F4
+			#define SEGMENT_BUFFER_ARENA_SIZE 8192
+		#else
+			#define SEGMENT_BUFFER_ARENA_SIZE 2048
+		#endif
+	#endif
+#endif
+
+// Stepper ISR and segment buffer data, placed in the F4 CCM RAM by STEPPER_CCM_RAM. The .ccmbss
+// section is zeroed by the startup code. The DMA controllers cannot reach CCM RAM.
+#if defined(STEPPER_CCM_RAM) && defined(STM32F4)
+	#define ST_CCM_RAM __attribute__((section(".ccmbss")))
+#else
+	#define ST_CCM_RAM
+#endif
+
 // Initialize and setup the stepper motor subsystem
 void stepper_init();
 
@@ -47,6 +66,14 @@ void st_go_idle();
 // Generate the step and direction port invert masks.
 void st_generate_step_dir_invert_masks();
 
+#ifdef INPUT_SHAPING
+// Computes the input shaper impulses of the axes from the $150-$175 settings.
+void st_update_shapers();
+
+// Sets the shaper timing of a new block, for the planner.
+void st_shaper_block_timing(plan_block_t *block);
+#endif
+
 // Reset the stepper subsystem variables
 void st_reset();
 
@@ -65,9 +92,58 @@ void st_update_plan_block_parameters();
 // Called by realtime status reporting if realtime rate reporting is enabled in config.h.
 float st_get_realtime_rate();
 
+// Copies the real-time machine position in steps, including steps of the executing segment.
+void st_get_position(int32_t *position);
+
 #ifdef STM32
 	void HandleStepSetIT(void);
 	void HandleStepResetIT(void);
+	#ifdef STEP_PULSE_DMA
+		void HandleStepDMAIT(uint8_t half);	//-- half 0: first half of the DMA buffer sent, 1: second half
+	#endif
+#endif
+
+#ifdef ENABLE_PREP_PROFILE
+  // Segment generator profile, indexed by ramp type (accel, cruise, decel, decel override).
+  #define PREP_PROFILE_RAMPS 4
+  typedef struct {
+    uint32_t segments[PREP_PROFILE_RAMPS];    // Segments generated
+    uint64_t cycles[PREP_PROFILE_RAMPS];      // Total CPU cycles spent generating them
+    uint32_t cycles_max[PREP_PROFILE_RAMPS];  // Most CPU cycles spent on a single segment
+    uint8_t low_water;                        // Fewest segments queued while stepping
+    uint32_t underruns;                       // Times the buffer ran dry with motion pending
+    #ifdef SEGMENT_BUFFER_ARENA
+      uint8_t buffer_size;                    // Segment buffer entries laid out for $60
+      uint32_t depth_us;                      // Motion time the buffer is filled to
+      uint32_t low_water_us;                  // Least motion time queued while stepping
+      uint32_t mean_us;                       // Mean motion time queued at each refill
+    #endif
+  } st_prep_profile_t;
+
+  // Returns the profile collected since the last st_prep_profile_reset().
+  st_prep_profile_t *st_get_prep_profile();
+
+  void st_prep_profile_reset();
+#endif
+
+#ifdef ENABLE_STEP_ISR_PROFILE
+  // Stepper driver interrupt profile. Histogram bin n counts durations below 64<<n cycles,
+  // the last bin everything above.
+  #define STEP_ISR_HISTOGRAM_BINS 8
+  #define STEP_ISR_HISTOGRAM_SHIFT 6
+  typedef struct {
+    uint32_t histogram[STEP_ISR_HISTOGRAM_BINS];
+    uint32_t cycles_max;  // Longest ISR execution
+    uint64_t cycles_total; // Sum of all ISR executions, over count
+    uint32_t count;
+    uint32_t overruns;    // Next tick already pending on exit
+    uint32_t latency_max; // Most timer ticks from the update to ISR entry
+    uint32_t reentries;   // Ticks dropped by the busy flag
+  } st_isr_profile_t;
+
+  st_isr_profile_t *st_get_isr_profile();
+
+  void st_isr_profile_reset();
 #endif
 
 
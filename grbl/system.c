@@ -164,6 +164,9 @@ uint8_t system_execute_line(char *line)
       return(gc_execute_line(line)); // NOTE: $J= is ignored inside g-code parser and used to detect jog motions.
       break;
     case '$': case 'G': case 'C': case 'X':
+    #if defined(ENABLE_PREP_PROFILE) || defined(ENABLE_STEP_ISR_PROFILE)
+      case 'P':
+    #endif
       if ( line[2] != 0 ) { return(STATUS_INVALID_STATEMENT); }
       switch( line[1] ) {
         case '$' : // Prints Grbl settings
@@ -196,6 +199,20 @@ uint8_t system_execute_line(char *line)
             // Don't run startup script. Prevents stored moves in startup from causing accidents.
           } // Otherwise, no effect.
           break;
+        #if defined(ENABLE_PREP_PROFILE) || defined(ENABLE_STEP_ISR_PROFILE)
+          case 'P' : // Print and restart the segment generator and stepper ISR profiles
+            #ifdef ENABLE_PREP_PROFILE
+              report_prep_profile();
+              st_prep_profile_reset();
+              #ifdef ADAPTIVE_LOOKAHEAD
+                plan_lookahead_reset();
+              #endif
+            #endif
+            #ifdef ENABLE_STEP_ISR_PROFILE
+              st_isr_profile_reset();
+            #endif
+            break;
+        #endif
       }
       break;
     default :
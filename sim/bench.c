@@ -0,0 +1,478 @@
+/*
+  bench.c - Planner throughput benchmark for the host-native Grbl32 build
+  Part of Grbl32
+
+  Copyright (c) 2018-2019 Thomas Truong
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Streams G-code straight through gc_execute_line() -> mc_line() -> plan_buffer_line() with the
+  stepper out of the loop. Whenever the planner buffer fills, the oldest block is retired, as if
+  the machine had just finished it, so the planner always works on a full lookahead like it does
+  during a long streamed job. Each retired block is timed with the profile planned for it at that
+  point, which gives the average feed the lookahead allows.
+    For each program three rates are compared: how fast the core can plan blocks (measured on
+  this host, scaled by -k to estimate the target), how fast the serial link can deliver them,
+  and how fast the machine consumes them at the programmed feed rates. Whichever of the first
+  two falls below the third is what starves the buffer.
+    -g stepper:N times the stepper driver interrupt instead: N ticks of a move on every axis,
+  called back to back with the segment buffer kept full outside the timed batches.
+*/
+
+#define _GNU_SOURCE
+#include "grbl.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+typedef struct {
+  uint32_t lines;           // G-code lines executed.
+  uint32_t errors;          // Lines gc_execute_line() rejected.
+  uint64_t bytes;           // Bytes a sender would transmit, including line ends.
+  uint64_t host_time;       // Time spent in gc_execute_line(), in host ns.
+  double motion_time;       // Time the retired blocks take at nominal speed, in minutes.
+  double planned_time;      // Time the retired blocks take with their planned profile, in minutes.
+  double millimeters;       // Path length of the retired blocks.
+  uint32_t retired;         // Blocks retired.
+  uint64_t window_blocks;   // Blocks buffered when each block is retired.
+  uint32_t window_blocks_max;
+  #ifdef ADAPTIVE_LOOKAHEAD
+    double window_mm;       // Lookahead distance buffered when each block is retired.
+    double window_time;     // Lookahead time in ms.
+  #endif
+} bench_t;
+static bench_t bench;
+
+static uint32_t baud = 115200;
+static double target_slowdown = 1.0;
+static float acceleration = 0.0f; // -a, mm/sec^2 on every axis. Zero keeps the settings.
+#ifdef ENABLE_LINE_COALESCING
+  static float coalesce_tolerance = -1.0f; // -c, mm. Negative keeps the settings.
+#endif
+
+
+// Time of a block run with a trapezoid from its entry to its exit speed, capped at its nominal
+// speed, in minutes. Speeds are in mm/min.
+static double bench_block_time(plan_block_t *block, double nominal_speed, double exit_speed_sqr)
+{
+  double accel = block->pbacceleration;
+  double mm = block->millimeters;
+  double entry_speed = sqrt(block->entry_speed_sqr);
+  double exit_speed = sqrt(exit_speed_sqr);
+  double accel_mm = (nominal_speed*nominal_speed-block->entry_speed_sqr)/(2*accel);
+  double decel_mm = (nominal_speed*nominal_speed-exit_speed_sqr)/(2*accel);
+  if (accel_mm+decel_mm <= mm) {
+    return((nominal_speed-entry_speed)/accel + (nominal_speed-exit_speed)/accel + (mm-accel_mm-decel_mm)/nominal_speed);
+  }
+  double peak_speed = sqrt(accel*mm + 0.5*(block->entry_speed_sqr+exit_speed_sqr));
+  return((peak_speed-entry_speed)/accel + (peak_speed-exit_speed)/accel);
+}
+
+// Retires the oldest planner block and accounts for its run time, both at nominal speed and
+// with the profile planned for it, from the lookahead buffered at this point.
+static void bench_retire_block()
+{
+  plan_block_t *block = plan_get_current_block();
+  if (block == NULL) { return; }
+  float nominal_speed = plan_compute_profile_nominal_speed(block);
+  if (nominal_speed > 0.0f) { bench.motion_time += block->millimeters/nominal_speed; }
+  bench.planned_time += bench_block_time(block, nominal_speed, plan_get_exec_block_exit_speed_sqr());
+  bench.millimeters += block->millimeters;
+  bench.retired++;
+  uint32_t blocks = plan_get_block_buffer_count();
+  bench.window_blocks += blocks;
+  if (blocks > bench.window_blocks_max) { bench.window_blocks_max = blocks; }
+  #ifdef ADAPTIVE_LOOKAHEAD
+    plan_lookahead_t *lookahead = plan_get_lookahead();
+    bench.window_mm += lookahead->millimeters;
+    bench.window_time += lookahead->time;
+  #endif
+  plan_discard_current_block();
+}
+
+// Stands in for the machine while the core waits on it. A full buffer retires blocks until it
+// takes a new one, a cycle start (buffer synchronize) retires them all and a hold (M0, M1) is
+// resumed at once. With ADAPTIVE_LOOKAHEAD, a buffer may still count as full after one block.
+static void bench_poll()
+{
+  if (sys.state & STATE_HOLD) {
+    system_set_exec_state_flag(EXEC_CYCLE_START);
+    return;
+  }
+  if (sys_rt_exec_state & EXEC_CYCLE_START) {
+    system_clear_exec_state_flag(EXEC_CYCLE_START);
+    while (plan_get_current_block() != NULL) { bench_retire_block(); }
+  } else {
+    while (plan_check_full_buffer() && (plan_get_current_block() != NULL)) { bench_retire_block(); }
+  }
+}
+
+static void bench_reset()
+{
+  memset(&bench, 0, sizeof(bench_t));
+  memset(&plan_stats, 0, sizeof(plan_stats_t));
+  memset(&sys, 0, sizeof(system_t));
+  sys.state = STATE_IDLE;
+  sys.f_override = DEFAULT_FEED_OVERRIDE;
+  sys.r_override = DEFAULT_RAPID_OVERRIDE;
+  sys.spindle_speed_ovr = DEFAULT_SPINDLE_SPEED_OVERRIDE;
+  sys_rt_exec_state = 0;
+  sys_rt_exec_alarm = 0;
+  memset(sys_position,0,sizeof(sys_position));
+  gc_init();
+  if (acceleration > 0.0f) {
+    uint8_t idx;
+    for (idx=0; idx<N_AXIS; idx++) {
+      settings.eeacceleration[idx] = acceleration*60*60;
+      #ifdef ENABLE_ACCEL_SCALING
+        adjustments.accel_adjusted[idx] = settings.eeacceleration[idx];
+      #endif
+    }
+  }
+  #ifdef ENABLE_LINE_COALESCING
+    if (coalesce_tolerance >= 0.0f) { settings.coalesce_tolerance = coalesce_tolerance; }
+  #endif
+  plan_reset();
+  st_reset();
+  plan_sync_position();
+  gc_sync_position();
+}
+
+// Filters one raw line the same way protocol_main_loop() does and executes it. System '$'
+// commands are skipped, since a job stream does not contain them.
+static void bench_line(const char *raw)
+{
+  char line[LINE_BUFFER_SIZE];
+  uint8_t char_counter = 0;
+  uint8_t comment = false;
+  uint8_t overflow = false;
+  const char *c;
+
+  bench.bytes += strlen(raw) + 1;
+  for (c = raw; *c && *c != '\n' && *c != '\r'; c++) {
+    if (comment) {
+      if (*c == ')' && comment == '(') { comment = false; }
+    } else if (*c <= ' ' || *c == '/') {
+      // Whitespace, control characters and block delete are dropped.
+    } else if (*c == '(' || *c == ';') {
+      comment = *c;
+    } else if (char_counter >= (LINE_BUFFER_SIZE-1)) {
+      overflow = true;
+    } else if (*c >= 'a' && *c <= 'z') {
+      line[char_counter++] = *c-'a'+'A';
+    } else {
+      line[char_counter++] = *c;
+    }
+  }
+  line[char_counter] = 0;
+  if (overflow) { bench.errors++; return; }
+  if (line[0] == 0 || line[0] == '$') { return; }
+
+  uint64_t start = sim_host_ns();
+  uint8_t status = gc_execute_line(line);
+  bench.host_time += sim_host_ns() - start;
+  bench.lines++;
+  if (status != STATUS_OK) { bench.errors++; }
+}
+
+static void bench_finish()
+{
+  protocol_buffer_synchronize(); // Retires whatever is left through bench_poll().
+}
+
+
+//-- Synthetic programs --------------------------------------------------------------------------
+
+// 3D surfacing finish pass: a zig-zag raster over a wavy surface in 0.1mm steps, the kind of
+// dense tiny-segment output CAM produces for parallel finishing.
+static void bench_synthetic_surface(uint32_t count)
+{
+  char line[64];
+  uint32_t n = 0;
+  float x = 0.0f, y = 0.0f, dx = 0.1f;
+  bench_line("G21 G90 G94 G17");
+  bench_line("G0 X0 Y0 Z5");
+  bench_line("G1 Z0 F2000");
+  while (n < count) {
+    x += dx;
+    if (x > 100.0f || x < 0.0f) {
+      dx = -dx;
+      x += dx;
+      y += 0.2f;
+    }
+    float z = 2.0f*sinf(x*0.1f)*cosf(y*0.1f);
+    snprintf(line, sizeof(line), "G1 X%.3f Y%.3f Z%.4f", x, y, z);
+    bench_line(line);
+    n++;
+  }
+}
+
+// Contour finishing: a 50mm radius circle with a gentle Z wave in 0.05mm chords at F3000. The
+// path is smooth enough to run at feed, but only if the lookahead covers the stopping distance.
+// With override_every set, the feed override is turned down and back up by 10%, one step every
+// override_every segments, as an operator tuning the feed mid-cut would.
+static void bench_synthetic_contour(uint32_t count, uint32_t override_every)
+{
+  char line[64];
+  uint32_t n;
+  bench_line("G21 G90 G94 G17");
+  bench_line("G0 X50 Y0 Z5");
+  bench_line("G1 Z0 F3000");
+  for (n=1; n<=count; n++) {
+    float angle = n*0.001f; // 0.05mm chords at 50mm radius.
+    snprintf(line, sizeof(line), "G1 X%.4f Y%.4f Z%.4f", 50.0f*cosf(angle), 50.0f*sinf(angle), 0.5f*sinf(8.0f*angle));
+    bench_line(line);
+    if (override_every && (n % override_every) == 0) {
+      system_set_exec_motion_override_flag((n/override_every) & 1 ? EXEC_FEED_OVR_COARSE_MINUS : EXEC_FEED_OVR_COARSE_PLUS);
+      // Handled here, so a buffer the new feed leaves full is not taken for a cycle start by the next line.
+      protocol_execute_realtime();
+    }
+  }
+}
+
+// Pocket raster: zig-zag passes 40mm long and 0.5mm apart, with every pass broken into 0.1mm
+// collinear segments, as some CAM output and mesh slicers emit straight cuts.
+static void bench_synthetic_raster(uint32_t count)
+{
+  char line[64];
+  uint32_t n = 0;
+  float x = 0.0f, y = 0.0f, dx = 0.1f;
+  bench_line("G21 G90 G94 G17");
+  bench_line("G0 X0 Y0 Z5");
+  bench_line("G1 Z-1 F3000");
+  while (n < count) {
+    x += dx;
+    if (x > 40.05f || x < -0.05f) {
+      dx = -dx;
+      x += dx;
+      y += 0.5f;
+    }
+    snprintf(line, sizeof(line), "G1 X%.3f Y%.3f", x, y);
+    bench_line(line);
+    n++;
+  }
+}
+
+// Adaptive clearing: a trochoidal slot of full circles stepping 0.3mm along X, linked by short
+// G1 moves. Every circle is broken into segments by mc_arc() using $12, or queued as a single
+// block with PLANNER_ARC_BLOCKS.
+static void bench_synthetic_adaptive(uint32_t count)
+{
+  char line[64];
+  uint32_t n = 0;
+  float x = 0.0f;
+  bench_line("G21 G90 G94 G17");
+  bench_line("G0 X0 Y0 Z5");
+  bench_line("G1 Z-1 F3000");
+  while (n < count) {
+    x += 0.3f;
+    snprintf(line, sizeof(line), "G1 X%.3f Y0", x);
+    bench_line(line);
+    snprintf(line, sizeof(line), "G2 X%.3f Y0 I3.000 J0", x);
+    bench_line(line);
+    n += 2;
+  }
+}
+
+
+//-- Stepper interrupt ---------------------------------------------------------------------------
+
+#define BENCH_STEP_BATCH 64 // Ticks timed per batch, well inside one segment buffer.
+
+// Runs the stepper ISR pair for a number of ticks of diagonal moves, queued as the planner
+// drains. Every axis steps on most ticks, so the cost measured is close to the worst case of
+// the build's axis count.
+static void bench_stepper(uint32_t count)
+{
+  static const char axis_letter[] = "XYZABC";
+  char line[96];
+  int len = snprintf(line, sizeof(line), "G1");
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) { len += snprintf(line+len, sizeof(line)-len, " %c%d", axis_letter[idx], 1000-50*idx); }
+  snprintf(line+len, sizeof(line)-len, " F%.0f", settings.max_rate[X_AXIS]);
+  bench_line("G21 G91 G94");
+
+  sys.state = STATE_CYCLE;
+  sim_options.isr_timing = true;
+  uint64_t host_time = 0;
+  uint32_t ticks = 0;
+  while (ticks < count) {
+    if (plan_get_block_buffer_count() < 2) { bench_line(line); }
+    st_prep_buffer();
+    uint64_t start = sim_host_ns();
+    for (idx=0; idx<BENCH_STEP_BATCH; idx++) {
+      sim_call_isr(HandleStepSetIT);
+      sim_call_isr(HandleStepResetIT);
+    }
+    host_time += sim_host_ns() - start;
+    ticks += BENCH_STEP_BATCH;
+  }
+  sim_options.isr_timing = false;
+  st_go_idle();
+  st_reset();
+  sys.state = STATE_IDLE;
+
+  double ns = (double)host_time/ticks;
+  printf("stepper, %d axes\n", N_AXIS);
+  printf("  ticks        %lu, set and reset interrupt %.1f ns/tick on host\n", (unsigned long)ticks, ns);
+  printf("  target       ~%.0f cycles/tick at %lu MHz", ns*1e-9*SystemCoreClock*target_slowdown,
+         (unsigned long)(SystemCoreClock/1000000));
+  if (target_slowdown != 1.0) { printf(" (host time scaled by %.1f)", target_slowdown); }
+  printf("\n\n");
+}
+
+
+//-- Report -------------------------------------------------------------------------------------
+
+static void bench_report(const char *name)
+{
+  bench_finish();
+  double host_s = bench.host_time*1e-9;
+  double avg_line_bytes = bench.lines ? (double)bench.bytes/bench.lines : 0.0;
+  double blocks_per_line = bench.lines ? (double)plan_stats.block_count/bench.lines : 0.0;
+  double plan_rate = host_s > 0.0 ? plan_stats.block_count/host_s : 0.0;
+  double target_plan_rate = plan_rate/target_slowdown;
+  double serial_rate = avg_line_bytes > 0.0 ? (baud/10.0)/avg_line_bytes*blocks_per_line : 0.0;
+  double motion_s = bench.motion_time*60.0;
+  double demand_rate = motion_s > 0.0 ? plan_stats.block_count/motion_s : 0.0;
+  uint32_t calls = plan_stats.recalculate_count ? plan_stats.recalculate_count : 1;
+
+  printf("%s\n", name);
+  printf("  lines %lu (%lu errors), blocks %lu, %.1f bytes/line\n", (unsigned long)bench.lines,
+         (unsigned long)bench.errors, (unsigned long)plan_stats.block_count, avg_line_bytes);
+  printf("  planner      %.0f blocks/s on host, %.3f us/block incl. parse\n", plan_rate,
+         plan_stats.block_count ? bench.host_time*1e-3/plan_stats.block_count : 0.0);
+  printf("  recalculate  %lu calls, avg %.3f us, worst %.3f us\n", (unsigned long)plan_stats.recalculate_count,
+         plan_stats.recalculate_time*1e-3/calls, plan_stats.recalculate_time_max*1e-3);
+  printf("  reverse pass avg %.1f blocks, max %lu, %lu walks to the tail (BLOCK_BUFFER_SIZE %d)\n",
+         (double)plan_stats.reverse_depth_total/calls, (unsigned long)plan_stats.reverse_depth_max,
+         (unsigned long)plan_stats.reverse_full_count, BLOCK_BUFFER_SIZE);
+  printf("  forward pass avg %.1f blocks\n", (double)plan_stats.forward_depth_total/calls);
+  if (plan_stats.override_count) {
+    uint32_t replans = plan_stats.replan_count ? plan_stats.replan_count : 1;
+    printf("  override     %lu changes, stall avg %.3f us, worst %.3f us\n", (unsigned long)plan_stats.override_count,
+           plan_stats.override_time*1e-3/plan_stats.override_count, plan_stats.override_time_max*1e-3);
+    printf("  replanned    %lu after avg %.3f us, worst %.3f us", (unsigned long)plan_stats.replan_count,
+           plan_stats.replan_latency*1e-3/replans, plan_stats.replan_latency_max*1e-3);
+    #ifdef LAZY_OVERRIDE_REPLAN
+      uint32_t steps = plan_stats.reconcile_count ? plan_stats.reconcile_count : 1;
+      printf(", %lu reconcile steps, avg %.3f us, worst %.3f us", (unsigned long)plan_stats.reconcile_count,
+             plan_stats.reconcile_time*1e-3/steps, plan_stats.reconcile_time_max*1e-3);
+    #endif
+    printf("\n");
+  }
+  printf("  serial       %.0f blocks/s at %lu baud\n", serial_rate, (unsigned long)baud);
+  printf("  machine      %.0f blocks/s at programmed feed (%.1f s of motion)\n", demand_rate, motion_s);
+  uint32_t retired = bench.retired ? bench.retired : 1;
+  printf("  lookahead    avg %.1f blocks, max %lu", (double)bench.window_blocks/retired, (unsigned long)bench.window_blocks_max);
+  #ifdef ADAPTIVE_LOOKAHEAD
+    printf(", avg %.2f mm, %.0f ms (LOOKAHEAD_BLOCKS %d, %d ms)", bench.window_mm/retired, bench.window_time/retired,
+           LOOKAHEAD_BLOCKS, LOOKAHEAD_TIME);
+  #endif
+  printf("\n");
+  if (bench.planned_time > 0.0) {
+    printf("  feed         avg %.0f mm/min planned, %.0f mm/min programmed (%.1f%%, %.1f s of motion)\n",
+           bench.millimeters/bench.planned_time, bench.millimeters/bench.motion_time,
+           100.0*bench.motion_time/bench.planned_time, bench.planned_time*60.0);
+  }
+
+  const char *limit = "none, supply keeps up with the machine";
+  if (target_plan_rate < demand_rate && target_plan_rate <= serial_rate) { limit = "planner CPU"; }
+  else if (serial_rate < demand_rate) { limit = "serial bandwidth"; }
+  printf("  starvation   %s", limit);
+  if (target_slowdown != 1.0) { printf(" (planner rate scaled by 1/%.1f for the target)", target_slowdown); }
+  printf("\n\n");
+}
+
+
+//-- Main ---------------------------------------------------------------------------------------
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+    "usage: %s [options] [file.nc ...]\n"
+    "  -g surface:N   benchmark a synthetic 3D surfacing pass of N segments\n"
+    "  -g adaptive:N  benchmark a synthetic trochoidal clearing job of N lines\n"
+    "  -g raster:N    benchmark a synthetic pocket raster of N collinear 0.1mm segments\n"
+    "  -g contour:N   benchmark a synthetic contour finishing pass of N 0.05mm segments\n"
+    "  -g override:N  the contour pass with the feed override stepped every 1000 segments\n"
+    "  -g stepper:N   time N ticks of the stepper driver interrupt\n"
+    "  -b baud        serial rate the stream is compared against (default 115200)\n"
+    "  -k factor      how much slower the target runs the core than this host (default 1)\n"
+    "  -a accel       acceleration of every axis in mm/sec^2 instead of the settings\n"
+    "  -c mm          line coalescing tolerance instead of $61, 0 to merge nothing\n"
+    "  -f file        load settings from a flash image written by grbl_sim -f\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *synthetic[8];
+  uint8_t synthetic_count = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "g:b:k:a:c:f:h")) != -1) {
+    switch (opt) {
+      case 'g': if (synthetic_count < 8) { synthetic[synthetic_count++] = optarg; } break;
+      case 'b': baud = strtoul(optarg, NULL, 10); break;
+      case 'k': target_slowdown = strtod(optarg, NULL); break;
+      case 'a': acceleration = strtof(optarg, NULL); break;
+      #ifdef ENABLE_LINE_COALESCING
+        case 'c': coalesce_tolerance = strtof(optarg, NULL); break;
+      #endif
+      case 'f': sim_options.flash_file = optarg; break;
+      default: usage(argv[0]); return (opt == 'h') ? 0 : 1;
+    }
+  }
+  if (synthetic_count == 0 && optind == argc) { usage(argv[0]); return 1; }
+  if (target_slowdown <= 0.0) { target_slowdown = 1.0; }
+
+  sim_options.tx_fd = open("/dev/null", O_WRONLY); // Start-up and program messages are noise here.
+  sim_options.poll_hook = bench_poll;
+  sim_init();
+  timing_init();
+  eeprom_init();
+  settings_init();
+  stepper_init();
+
+  uint8_t idx;
+  for (idx=0; idx<synthetic_count; idx++) {
+    char *count = strchr(synthetic[idx], ':');
+    uint32_t n = count ? strtoul(count+1, NULL, 10) : 50000;
+    bench_reset();
+    if (strncmp(synthetic[idx], "surface", 7) == 0) { bench_synthetic_surface(n); }
+    else if (strncmp(synthetic[idx], "adaptive", 8) == 0) { bench_synthetic_adaptive(n); }
+    else if (strncmp(synthetic[idx], "raster", 6) == 0) { bench_synthetic_raster(n); }
+    else if (strncmp(synthetic[idx], "contour", 7) == 0) { bench_synthetic_contour(n, 0); }
+    else if (strncmp(synthetic[idx], "override", 8) == 0) { bench_synthetic_contour(n, 1000); }
+    else if (strncmp(synthetic[idx], "stepper", 7) == 0) { bench_stepper(n); continue; }
+    else { fprintf(stderr, "unknown synthetic program: %s\n", synthetic[idx]); return 1; }
+    bench_report(synthetic[idx]);
+  }
+
+  for (; optind < argc; optind++) {
+    FILE *f = fopen(argv[optind], "r");
+    if (!f) { perror(argv[optind]); return 1; }
+    char *line = NULL;
+    size_t cap = 0;
+    bench_reset();
+    while (getline(&line, &cap, f) >= 0) { bench_line(line); }
+    free(line);
+    fclose(f);
+    bench_report(argv[optind]);
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+/*
+  board.c - Board globals for the host-native Grbl32 builds
+  Part of Grbl32
+
+  Copyright (c) 2018-2019 Thomas Truong
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "grbl.h"
+
+// Declare system global variable structure. Same set as Atollic/*/Src/main.c.
+system_t sys;
+int32_t sys_position[N_AXIS];      // Real-time machine (aka home) position vector in steps.
+int32_t sys_probe_position[N_AXIS]; // Last probe position in machine coordinates and steps.
+volatile uint8_t sys_probe_state;   // Probing state value.  Used to coordinate the probing cycle with stepper ISR.
+volatile uint8_t sys_rt_exec_state;   // Global realtime executor bitflag variable for state management. See EXEC bitmasks.
+volatile uint8_t sys_rt_exec_alarm;   // Global realtime executor bitflag variable for setting various alarms.
+volatile uint8_t sys_rt_exec_motion_override; // Global realtime executor bitflag variable for motion-based overrides.
+volatile uint8_t sys_rt_exec_accessory_override; // Global realtime executor bitflag variable for spindle/coolant overrides.
+#ifdef DEBUG
+  volatile uint8_t sys_rt_exec_debug;
+#endif
+
+#ifdef STM32F46
+  SPI_HandleTypeDef hspi3;
+#endif
+
+#ifdef STM32F4
+// Board code from Atollic/F46/Src/main.c, with the analog output timers as plain registers.
+void Analog_Timer_Init()
+{
+  LL_TIM_CC_EnableChannel(ANA1_TIMER,ANA1_CHANNEL);
+  LL_TIM_CC_EnableChannel(ANA2_TIMER,ANA2_CHANNEL);
+  LL_TIM_CC_EnableChannel(ANA3_TIMER,ANA3_CHANNEL);
+  LL_TIM_CC_EnableChannel(ANA4_TIMER,ANA4_CHANNEL);
+  LL_TIM_EnableAllOutputs(ANA1_TIMER);
+  LL_TIM_EnableCounter(ANA1_TIMER);
+  LL_TIM_CC_EnableChannel(ANA5_TIMER,ANA5_CHANNEL);
+  LL_TIM_CC_EnableChannel(ANA6_TIMER,ANA6_CHANNEL);
+  LL_TIM_CC_EnableChannel(ANA7_TIMER,ANA7_CHANNEL);
+  LL_TIM_CC_EnableChannel(ANA8_TIMER,ANA8_CHANNEL);
+  LL_TIM_EnableAllOutputs(ANA5_TIMER);
+  LL_TIM_EnableCounter(ANA5_TIMER);
+}
+#endif
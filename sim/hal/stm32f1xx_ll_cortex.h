@@ -0,0 +1,2 @@
+/* Host simulator stand-in for the ST device header, see sim/stm32sim.h */
+#include "stm32sim.h"
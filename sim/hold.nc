@@ -0,0 +1,30 @@
+$X
+G21G90G17
+G1X10Y5F250
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+!(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+~(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+!(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+(pad: serial time at 115200 baud while the machine moves or holds.....)
+~G1X2Y8Z-1F250
+G2X6Y8I2J0F300
+G1X0Y0Z0F300
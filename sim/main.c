@@ -0,0 +1,150 @@
+/*
+  main.c - Entry point for the host-native Grbl32 simulator
+  Part of Grbl32
+
+  Copyright (c) 2018-2019 Thomas Truong
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define _GNU_SOURCE
+#include "grbl.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+
+static void usage(const char *name)
+{
+  fprintf(stderr,
+    "usage: %s [options] < program.nc\n"
+    "  -b baud     virtual UART rate, 0 for unthrottled input (default 115200)\n"
+    "  -q us       virtual time per main loop poll (default 10)\n"
+    "  -t seconds  stop after this much virtual time\n"
+    "  -s file     log every step event with its virtual timestamp\n"
+    "  -f file     back the flash array, and so the settings, with a file\n"
+    "  -p          serve a PTY instead of stdin/stdout, paced in real time\n"
+    "  -r          pace the virtual clock against the wall clock\n"
+    "  -l ns       enter step timer interrupts up to this late, pseudo-randomly\n"
+    "  -R          restart the step timer counter in its interrupt, like Grbl32 1.1f\n", name);
+}
+
+// Opens a raw pseudo terminal for a sender such as bCNC or UGS to connect to.
+static int open_pty()
+{
+  int fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0) { perror("pty"); exit(1); }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) {
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  fprintf(stderr, "[sim] listening on %s\n", ptsname(fd));
+  return fd;
+}
+
+int main(int argc, char *argv[])
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "b:q:t:s:f:l:prRh")) != -1) {
+    switch (opt) {
+      case 'b': sim_options.baud = strtoul(optarg, NULL, 10); break;
+      case 'q': sim_options.poll_us = strtoul(optarg, NULL, 10); break;
+      case 't': sim_options.time_limit = strtod(optarg, NULL); break;
+      case 's':
+        sim_options.step_log = fopen(optarg, "w");
+        if (!sim_options.step_log) { perror(optarg); return 1; }
+        break;
+      case 'f': sim_options.flash_file = optarg; break;
+      case 'p':
+        sim_options.rx_fd = sim_options.tx_fd = open_pty();
+        sim_options.rx_interactive = true;
+        sim_options.realtime = true;
+        break;
+      case 'r': sim_options.realtime = true; break;
+      case 'l': sim_options.step_latency_ns = strtoul(optarg, NULL, 10); break;
+      case 'R': sim_options.step_restart = true; break;
+      default: usage(argv[0]); return (opt == 'h') ? 0 : 1;
+    }
+  }
+  if (sim_options.poll_us == 0) { sim_options.poll_us = 1; }
+
+  HAL_Init();
+  sim_init();
+
+  // Same start-up sequence as Atollic/*/Src/main.c, less the CubeMX peripheral init.
+  timing_init();
+  uart_init();
+  eeprom_init();
+  serial_init();   // Setup serial baud rate and interrupts
+  settings_init(); // Load Grbl settings from EEPROM
+  stepper_init();  // Configure stepper pins and interrupt timers
+  system_init();   // Configure pinout pins and pin-change interrupt
+
+  memset(sys_position,0,sizeof(sys_position)); // Clear machine position.
+
+  // Initialize system state.
+  #ifdef FORCE_INITIALIZATION_ALARM
+    // Force Grbl into an ALARM state upon a power-cycle or hard reset.
+    sys.state = STATE_ALARM;
+  #else
+    sys.state = STATE_IDLE;
+  #endif
+
+  #ifdef HOMING_INIT_LOCK
+    if (bit_istrue(settings.flags,BITFLAG_HOMING_ENABLE)) { sys.state = STATE_ALARM; }
+  #endif
+
+  // Grbl initialization loop upon power-up or a system abort.
+  for (;;) {
+    // Reset system variables.
+    uint8_t prior_state = sys.state;
+    memset(&sys, 0, sizeof(system_t)); // Clear system struct variable.
+    sys.state = prior_state;
+    sys.f_override = DEFAULT_FEED_OVERRIDE;  // Set to 100%
+    sys.r_override = DEFAULT_RAPID_OVERRIDE; // Set to 100%
+    sys.spindle_speed_ovr = DEFAULT_SPINDLE_SPEED_OVERRIDE; // Set to 100%
+    memset(sys_probe_position,0,sizeof(sys_probe_position)); // Clear probe position.
+    sys_probe_state = 0;
+    sys_rt_exec_state = 0;
+    sys_rt_exec_alarm = 0;
+    sys_rt_exec_motion_override = 0;
+    sys_rt_exec_accessory_override = 0;
+
+    // Reset Grbl primary systems.
+    serial_reset_read_buffer(); // Clear serial read buffer
+    gc_init(); // Set g-code parser to default state
+    spindle_init();
+    coolant_init();
+    limits_init();
+    probe_init();
+    inoutputs_init();
+    plan_reset(); // Clear block buffer and planner variables
+    st_reset(); // Clear stepper subsystem variables.
+
+    // Sync cleared gcode and planner positions to current system position.
+    plan_sync_position();
+    gc_sync_position();
+
+    // Print welcome message. Indicates an initialization has occured at power-up or with a reset.
+    report_init_message();
+
+    // Start Grbl main loop. Processes program inputs and executes them.
+    protocol_main_loop();
+  }
+  return 0;
+}
@@ -0,0 +1,400 @@
+$X
+G21G90G17
+G0X5Y5Z2
+G1X30Y5Z0F1200
+G1X30Y25F1200
+G2X10Y25I-10J0F1500
+G1X0Y0F1500
+G0X20Y10Z3
+G0X0Y0Z0
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+(pad: serial time at 115200 baud while the overrides take effect.......)
+
\ No newline at end of file
@@ -0,0 +1,11 @@
+$X
+G21G90G17
+G0X10Y5Z2
+G1X20Y15F500
+G1X25Y15Z-1F800
+G2X35Y15I5J0F1000
+G3X25Y15I-5J0
+G1X0Y0Z0F1500
+G0X-5Y3
+G1X3Y-2F300
+G0X0Y0Z0
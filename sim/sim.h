@@ -0,0 +1,63 @@
+/*
+  sim.h - Virtual MCU control for the host-native Grbl32 simulator
+  Part of Grbl32
+
+  Copyright (c) 2018-2019 Thomas Truong
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+typedef struct {
+  uint32_t poll_us;         // Virtual time consumed by each main loop poll, in microseconds.
+  uint32_t baud;            // Virtual UART rate. 0 delivers input as fast as the RX buffer accepts it.
+  double time_limit;        // Stop after this many virtual seconds. 0 runs until input is exhausted.
+  uint8_t realtime;         // Pace the virtual clock against the wall clock.
+  int rx_fd;                // Byte source for HandleUartIT.
+  int tx_fd;                // Sink for uart_sendch.
+  uint8_t rx_interactive;   // Input is a PTY: never block on it and never stop at end of input.
+  FILE *step_log;           // When set, every step event is logged with its virtual timestamp.
+  const char *flash_file;   // When set, the flash array is backed by this file and persists.
+  void (*poll_hook)(void);  // When set, replaces the virtual clock in sim_poll(). Used by tools that
+                            //   drive the core directly instead of running the machine.
+  uint32_t step_latency_ns; // Step timer interrupts are entered up to this late, pseudo-randomly, as
+                            //   if the CPU were busy in another handler or with interrupts disabled.
+  uint8_t step_restart;     // Restart the step timer counter on interrupt entry, as the Grbl32 1.1f
+                            //   handlers did, so that entry latency adds to every period.
+  uint8_t isr_timing;       // Set by tools timing interrupt handlers in batches: step outputs are not
+                            //   traced and GetCycleCount() returns 0, so neither adds to the handlers.
+} sim_options_t;
+extern sim_options_t sim_options;
+
+// Maps flash, resets the virtual peripherals and starts the virtual clock at zero.
+void sim_init();
+
+// Flushes output, prints the run summary to stderr and exits.
+void sim_shutdown(int status);
+
+// Virtual CPU clock, in SystemCoreClock cycles since sim_init().
+uint64_t sim_get_cycles();
+
+// Runs an interrupt handler as if the NVIC had taken it. Interrupts it pends wait until it returns.
+void sim_call_isr(void (*handler)(void));
+
+// Host monotonic clock in nanoseconds, for measuring the cost of core code on the build machine.
+uint64_t sim_host_ns();
+
+#endif /* SIM_H_ */
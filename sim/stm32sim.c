@@ -0,0 +1,740 @@
+/*
+  stm32sim.c - Virtual peripherals and clock for the host-native Grbl32 simulator
+  Part of Grbl32
+
+  Copyright (c) 2018-2019 Thomas Truong
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  The simulator is single threaded and fully deterministic. Grbl code runs in zero virtual time;
+  the virtual clock only moves when the main program polls (protocol_exec_rt_system(), input
+  port reads, HAL_Delay(), _delay_us()). Each poll advances the clock by sim_options.poll_us and
+  fires every timer update and UART receive event that falls inside that window, in time order,
+  by calling the same handlers the stm32f?xx_it.c files call on the target.
+    Timers count in CPU cycles scaled by their bus clock, honour ARR/PSC as written (PSC is
+  preloaded, ARR is not, matching the CubeMX setup), wrap at 16 or 32 bits and only generate
+  events when their update interrupt or DMA request could actually be taken, so free-running
+  PWM timers cost nothing. DMA requests are served at the update that raises them.
+*/
+
+#define _GNU_SOURCE
+#include "grbl.h"
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+  #define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+unsigned long SystemCoreClock = SIM_SYSCLK;
+GPIO_TypeDef sim_gpio[SIM_GPIO_PORTS];
+TIM_TypeDef sim_tim[SIM_TIM_COUNT];
+USART_TypeDef sim_usart1;
+DMA_TypeDef sim_dma1;
+SysTick_Type sim_systick;
+FLASH_TypeDef sim_flash;
+DWT_Type sim_dwt;
+CoreDebug_Type sim_coredebug;
+
+sim_options_t sim_options = { .poll_us = 10, .baud = 115200, .rx_fd = STDIN_FILENO, .tx_fd = STDOUT_FILENO };
+
+static uint64_t sim_cycles;             // Virtual CPU clock.
+static uint8_t nvic_enabled[SIM_IRQ_COUNT];
+static uint8_t primask;
+static uint8_t in_isr;
+
+// UART receive side. One byte is staged ahead so its arrival can be scheduled.
+static uint8_t rx_staged;
+static uint8_t rx_has_staged;
+static uint8_t rx_eof;
+static uint8_t rx_hold = true;          // Input waits for the welcome banner, as a sender would.
+static uint64_t rx_next_cycle;
+static uint8_t rx_buf[4096];
+static int rx_buf_len, rx_buf_pos;
+
+// UART transmit side. Responses are counted against delivered line ends to detect completion.
+static uint8_t tx_buf[4096];
+static int tx_buf_len;
+static char tx_line_start[2];
+static uint8_t tx_line_pos;
+static uint32_t lines_sent, responses_received;
+
+// Step output tracing.
+static int32_t sim_position[N_AXIS];
+static uint64_t sim_steps[N_AXIS];
+static uint64_t step_isr_count, step_reset_isr_count, poll_count;
+#ifdef STEP_PULSE_DMA
+  static uint64_t step_dma_irq_count;
+#endif
+
+static struct timespec wall_start;
+
+
+//-- Timers -------------------------------------------------------------------------------------
+
+// Bus clock divider for each timer relative to SystemCoreClock, from the board RCC setup.
+static uint32_t sim_timer_div(TIM_TypeDef *t)
+{
+  #ifdef STM32F4
+    // APB1 runs at HCLK/4, so its timers are clocked at HCLK/2. APB2 timers run at HCLK.
+    if (t == TIM2 || t == TIM3 || t == TIM4 || t == TIM5 || t == TIM6 || t == TIM7) { return 2; }
+  #endif
+  (void)t;
+  return 1; // F1 runs APB1 at HCLK/2, so its timers are clocked at HCLK.
+}
+
+static uint32_t sim_timer_max(TIM_TypeDef *t)
+{
+  #ifdef STM32F4
+    if (t == TIM2 || t == TIM5) { return 0xffffffff; }
+  #endif
+  (void)t;
+  return 0xffff;
+}
+
+// ARR in effect for the current period: its shadow register while ARPE preloads it.
+static uint32_t sim_timer_arr(TIM_TypeDef *t)
+{
+  return (t->CR1 & TIM_CR1_ARPE) ? t->sim_arr_active : t->ARR;
+}
+
+// Counter ticks from CNT up to and including the next overflow at ARR. A counter already past
+// ARR, after ARR was lowered without preload, first has to wrap through its full range.
+static uint64_t sim_timer_counts_to_update(TIM_TypeDef *t)
+{
+  uint64_t max = sim_timer_max(t);
+  uint64_t arr = sim_timer_arr(t) & max;
+  uint64_t cnt = t->CNT & max;
+  if (cnt <= arr) { return arr - cnt + 1; }
+  return (max - cnt + 1) + arr + 1;
+}
+
+static uint64_t sim_timer_cycles_to_update(TIM_TypeDef *t)
+{
+  uint64_t cycles_per_count = (uint64_t)sim_timer_div(t)*(t->sim_psc_active + 1);
+  return sim_timer_counts_to_update(t)*cycles_per_count - t->sim_psc_count;
+}
+
+// Cycles until CNT next counts up to CCR1, for a CC1 DMA request with 0 < CCR1 <= ARR. A match
+// at CCR1 = 0 coincides with the update and is served with it.
+static uint64_t sim_timer_cycles_to_compare(TIM_TypeDef *t)
+{
+  if (t->CCR1 == 0 || t->CCR1 > sim_timer_arr(t)) { return UINT64_MAX; }
+  uint64_t cycles_per_count = (uint64_t)sim_timer_div(t)*(t->sim_psc_active + 1);
+  if (t->CNT < t->CCR1) { return (t->CCR1 - t->CNT)*cycles_per_count - t->sim_psc_count; }
+  if (t->CR1 & TIM_CR1_OPM) { return UINT64_MAX; } // Stops at the update.
+  return sim_timer_cycles_to_update(t) + (uint64_t)t->CCR1*cycles_per_count;
+}
+
+#define SIM_TIM_UPDATE  0x01 // Events a timer advance ends on exactly, for its DMA requests.
+#define SIM_TIM_CC1     0x02
+
+// Runs a timer forward by a number of CPU cycles, raising UIF on every overflow, and stopping
+// at the first in one-pulse mode. Returns the events the last cycle ends exactly on, which is
+// when their DMA requests are served.
+static uint8_t sim_timer_advance(TIM_TypeDef *t, uint64_t cycles)
+{
+  if (!(t->CR1 & TIM_CR1_CEN) || cycles == 0) { return 0; }
+  uint64_t to_update = sim_timer_cycles_to_update(t);
+  if (cycles < to_update) {
+    uint64_t cycles_per_count = (uint64_t)sim_timer_div(t)*(t->sim_psc_active + 1);
+    uint64_t total = t->sim_psc_count + cycles;
+    t->CNT = (uint32_t)((t->CNT + total/cycles_per_count) & sim_timer_max(t));
+    t->sim_psc_count = (uint32_t)(total % cycles_per_count);
+    if (t->sim_psc_count == 0 && t->CCR1 != 0 && t->CNT == t->CCR1) { return SIM_TIM_CC1; }
+    return 0;
+  }
+  cycles -= to_update;
+  t->CNT = 0;
+  t->sim_psc_count = 0;
+  t->sim_psc_active = t->PSC;
+  t->sim_arr_active = t->ARR;
+  t->SR |= TIM_SR_UIF;
+  if (t->CR1 & TIM_CR1_OPM) {
+    t->CR1 &= ~TIM_CR1_CEN;
+    return (cycles == 0) ? SIM_TIM_UPDATE : 0;
+  }
+  if (cycles == 0) { return SIM_TIM_UPDATE; }
+  uint64_t period = (uint64_t)(sim_timer_arr(t) + 1)*sim_timer_div(t)*(t->sim_psc_active + 1);
+  return sim_timer_advance(t, cycles % period);
+}
+
+
+//-- DMA ----------------------------------------------------------------------------------------
+
+// Only the F1 step pulse engine uses DMA, through the fixed F1 request map.
+#ifdef STM32F1
+// Moves one item on a channel. A write to a GPIO BSRR is applied to the port like the hardware does.
+static void sim_dma_transfer(DMA_TypeDef *dma, uint8_t channel)
+{
+  DMA_Channel_TypeDef *ch = &dma->CH[channel-1];
+  if (!(ch->CCR & DMA_CCR_EN) || ch->CNDTR == 0) { return; }
+  uint32_t item = ch->sim_length - ch->CNDTR;
+  uint32_t value;
+  if (!(ch->CCR & LL_DMA_MEMORY_INCREMENT)) { item = 0; }
+  if (ch->CCR & LL_DMA_MDATAALIGN_WORD) { value = ((uint32_t *)ch->CMAR)[item]; }
+  else { value = ((uint16_t *)ch->CMAR)[item]; }
+  if (!(ch->CCR & LL_DMA_PDATAALIGN_WORD)) { value = (uint16_t)value; } // 16-bit registers, zero extended.
+
+  uint8_t idx;
+  for (idx=0; idx<SIM_GPIO_PORTS; idx++) {
+    if (ch->CPAR == (uintptr_t)&sim_gpio[idx].BSRR) { break; }
+  }
+  if (idx < SIM_GPIO_PORTS) { sim_gpio_write_bsrr(&sim_gpio[idx], value); }
+  else { *(__IO uint32_t *)ch->CPAR = value; }
+
+  // ISR holds a GIF, TCIF, HTIF, TEIF nibble per channel.
+  uint32_t flags = 0;
+  if (--ch->CNDTR == ch->sim_length/2) { flags |= 0x4; }
+  if (ch->CNDTR == 0) {
+    flags |= 0x2;
+    if (ch->CCR & LL_DMA_MODE_CIRCULAR) { ch->CNDTR = ch->sim_length; }
+  }
+  if (flags) { dma->ISR |= (flags | 0x1) << 4*(channel-1); }
+}
+
+// DMA requests raised by timer events, with the fixed F1 request map. A CC1 match at CCR1 = 0
+// coincides with the update.
+static void sim_timer_dma_request(TIM_TypeDef *t, uint8_t events)
+{
+  uint8_t update = (events & SIM_TIM_UPDATE) && (t->DIER & TIM_DIER_UDE);
+  uint8_t cc1 = (t->DIER & TIM_DIER_CC1DE) && ((events & SIM_TIM_CC1) || ((events & SIM_TIM_UPDATE) && t->CCR1 == 0));
+  if (t == TIM2) {
+    if (update) { sim_dma_transfer(DMA1, 2); }
+    if (cc1) { sim_dma_transfer(DMA1, 5); }
+  }
+  if (t == TIM3) {
+    if (cc1) { sim_dma_transfer(DMA1, 6); }
+    if (update) { sim_dma_transfer(DMA1, 3); }
+  }
+}
+#else
+static void sim_timer_dma_request(TIM_TypeDef *t, uint8_t events)
+{
+  (void)t;
+  (void)events;
+}
+#endif
+
+
+//-- Interrupts ---------------------------------------------------------------------------------
+
+static void sim_step_set_irq()
+{
+  if (LL_TIM_IsActiveFlag_UPDATE(STEP_SET_TIMER)) {
+    LL_TIM_ClearFlag_UPDATE(STEP_SET_TIMER);
+    if (sim_options.step_restart) { LL_TIM_SetCounter(STEP_SET_TIMER, 0); }
+    step_isr_count++;
+    HandleStepSetIT();
+  }
+}
+
+static void sim_step_reset_irq()
+{
+  if (LL_TIM_IsActiveFlag_UPDATE(STEP_RESET_TIMER)) {
+    LL_TIM_ClearFlag_UPDATE(STEP_RESET_TIMER);
+    LL_TIM_SetCounter(STEP_RESET_TIMER, 0);
+    NVIC_DisableIRQ(STEP_RESET_IRQ);
+    step_reset_isr_count++;
+    HandleStepResetIT();
+  }
+}
+
+#ifdef STEP_PULSE_DMA
+static void sim_step_dma_irq()
+{
+  step_dma_irq_count++;
+  if (LL_DMA_IsActiveFlag_HT2(DMA1)) {
+    LL_DMA_ClearFlag_HT2(DMA1);
+    HandleStepDMAIT(0);
+  }
+  if (LL_DMA_IsActiveFlag_TC2(DMA1)) {
+    LL_DMA_ClearFlag_TC2(DMA1);
+    HandleStepDMAIT(1);
+  }
+}
+#endif
+
+static void sim_usart1_irq()
+{
+  if (LL_USART_IsEnabledIT_RXNE(USART1)) {
+    uint8_t data = LL_USART_ReceiveData8(USART1);
+    HandleUartIT(data);
+    LL_USART_ClearFlag_RXNE(USART1);
+  }
+}
+
+// Returns true when the interrupt line is requesting service.
+static uint8_t sim_irq_pending(IRQn_Type irq)
+{
+  if (irq == STEP_SET_IRQ) { return (STEP_SET_TIMER->SR & TIM_SR_UIF) && (STEP_SET_TIMER->DIER & TIM_DIER_UIE); }
+  if (irq == STEP_RESET_IRQ) { return (STEP_RESET_TIMER->SR & TIM_SR_UIF) && (STEP_RESET_TIMER->DIER & TIM_DIER_UIE); }
+  if (irq == USART1_IRQn) { return (USART1->SR & USART_SR_RXNE) && (USART1->CR1 & USART_CR1_RXNEIE); }
+  #ifdef STEP_PULSE_DMA
+    if (irq == STEP_DMA_IRQ) {
+      DMA_Channel_TypeDef *ch = &STEP_DMA->CH[STEP_DMA_BSRR_CHANNEL-1];
+      return ((STEP_DMA->ISR & DMA_ISR_HTIF2) && (ch->CCR & DMA_CCR_HTIE)) ||
+             ((STEP_DMA->ISR & DMA_ISR_TCIF2) && (ch->CCR & DMA_CCR_TCIE));
+    }
+  #endif
+  return false;
+}
+
+// Interrupt lines with a handler in the simulator, as in stm32f?xx_it.c.
+static const IRQn_Type sim_irq_lines[] = {
+  STEP_SET_IRQ, STEP_RESET_IRQ, USART1_IRQn,
+  #ifdef STEP_PULSE_DMA
+    STEP_DMA_IRQ,
+  #endif
+};
+
+static void sim_run_until(uint64_t target);
+
+// Holds off the step timer interrupt by a pseudo-random latency of up to -l ns. Timers and DMA
+// keep running meanwhile, other interrupts wait as if behind another handler.
+static void sim_step_latency()
+{
+  static uint32_t seed = 1;
+  if (sim_options.step_latency_ns == 0) { return; }
+  seed = seed*1664525 + 1013904223; // Same sequence every run, so runs are repeatable.
+  uint64_t ns = (seed >> 8) % (sim_options.step_latency_ns + 1);
+  sim_run_until(sim_cycles + ns*(SystemCoreClock/1000000)/1000);
+}
+
+// Takes every pending, enabled interrupt in priority order. All Grbl interrupts share one
+// priority level, so the NVIC picks the lowest IRQ number and never nests them.
+static void sim_dispatch()
+{
+  if (primask || in_isr) { return; }
+  for (;;) {
+    uint8_t idx;
+    int irq = SIM_IRQ_COUNT;
+    for (idx=0; idx<sizeof(sim_irq_lines)/sizeof(sim_irq_lines[0]); idx++) {
+      IRQn_Type line = sim_irq_lines[idx];
+      if ((int)line < irq && nvic_enabled[line] && sim_irq_pending(line)) { irq = line; }
+    }
+    if (irq == SIM_IRQ_COUNT) { return; }
+    in_isr = true;
+    if (irq == STEP_SET_IRQ) {
+      sim_step_latency();
+      sim_step_set_irq();
+    }
+    else if (irq == STEP_RESET_IRQ) { sim_step_reset_irq(); }
+    #ifdef STEP_PULSE_DMA
+      else if (irq == STEP_DMA_IRQ) { sim_step_dma_irq(); }
+    #endif
+    else { sim_usart1_irq(); }
+    in_isr = false;
+  }
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+  nvic_enabled[IRQn] = true;
+  sim_dispatch(); // A flag raised while the line was masked is taken immediately.
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn) { nvic_enabled[IRQn] = false; }
+
+void __enable_irq(void)
+{
+  primask = false;
+  sim_dispatch();
+}
+
+void __disable_irq(void) { primask = true; }
+
+uint32_t __get_PRIMASK(void) { return primask; }
+
+void __set_PRIMASK(uint32_t priMask)
+{
+  primask = priMask & 1;
+  if (!primask) { sim_dispatch(); }
+}
+
+
+//-- UART ---------------------------------------------------------------------------------------
+
+static void sim_tx_flush()
+{
+  int pos = 0;
+  while (pos < tx_buf_len) {
+    ssize_t n = write(sim_options.tx_fd, tx_buf+pos, tx_buf_len-pos);
+    if (n <= 0) { if (n < 0 && errno == EINTR) { continue; } break; }
+    pos += n;
+  }
+  tx_buf_len = 0;
+}
+
+void sim_uart_transmit(uint8_t Value)
+{
+  tx_buf[tx_buf_len++] = Value;
+  if (tx_buf_len == sizeof(tx_buf) || sim_options.rx_interactive) { sim_tx_flush(); }
+
+  // Track 'ok' and 'error:' responses. A welcome banner means a reset flushed the RX buffer,
+  // so any lines still queued there will never be answered.
+  if (Value == '\n') {
+    if (tx_line_pos >= 2) {
+      if ((tx_line_start[0] == 'o' && tx_line_start[1] == 'k') ||
+          (tx_line_start[0] == 'e' && tx_line_start[1] == 'r')) { responses_received++; }
+      if (tx_line_start[0] == 'G' && tx_line_start[1] == 'r') {
+        lines_sent = responses_received;
+        rx_hold = false;
+      }
+    }
+    tx_line_pos = 0;
+  } else if (Value != '\r') {
+    if (tx_line_pos < 2) { tx_line_start[tx_line_pos] = Value; }
+    if (tx_line_pos < 255) { tx_line_pos++; }
+  }
+}
+
+// Stages the next input byte, if there is one. Blocks on non-interactive input, which is what
+// keeps the simulation deterministic regardless of how fast the producer writes.
+static void sim_rx_stage()
+{
+  if (rx_has_staged || rx_eof) { return; }
+  if (rx_buf_pos == rx_buf_len) {
+    if (!sim_options.rx_interactive) { sim_tx_flush(); } // Producer may be waiting on a response.
+    ssize_t n = read(sim_options.rx_fd, rx_buf, sizeof(rx_buf));
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) { return; }
+    if (n <= 0) {
+      if (!sim_options.rx_interactive) { rx_eof = true; }
+      return;
+    }
+    rx_buf_len = n;
+    rx_buf_pos = 0;
+  }
+  rx_staged = rx_buf[rx_buf_pos++];
+  rx_has_staged = true;
+  if (rx_next_cycle < sim_cycles) { rx_next_cycle = sim_cycles; }
+}
+
+// Input is held back while the RX ring is full, as hardware flow control would.
+static uint8_t sim_rx_ready()
+{
+  if (rx_hold || serial_get_rx_buffer_count() >= (RX_BUFFER_SIZE-1)) { return false; }
+  sim_rx_stage();
+  return rx_has_staged;
+}
+
+static void sim_rx_deliver()
+{
+  USART1->DR = rx_staged;
+  USART1->SR |= USART_SR_RXNE;
+  rx_has_staged = false;
+  if ((rx_staged == '\n') || (rx_staged == '\r')) { lines_sent++; }
+  if (sim_options.baud) { rx_next_cycle = sim_cycles + ((uint64_t)SystemCoreClock*10)/sim_options.baud; }
+}
+
+
+//-- Virtual clock ------------------------------------------------------------------------------
+
+// Runs the virtual MCU up to the target cycle, taking every interrupt on the way.
+static void sim_run_until(uint64_t target)
+{
+  uint8_t idx;
+  sim_dispatch();
+  while (sim_cycles < target) {
+    uint64_t next = target;
+    for (idx=1; idx<SIM_TIM_COUNT; idx++) {
+      TIM_TypeDef *t = &sim_tim[idx];
+      uint8_t wanted = ((t->DIER & TIM_DIER_UIE) && !(t->SR & TIM_SR_UIF)) || (t->DIER & (TIM_DIER_UDE | TIM_DIER_CC1DE));
+      if ((t->CR1 & TIM_CR1_CEN) && wanted) {
+        uint64_t due = sim_cycles + sim_timer_cycles_to_update(t);
+        if (due < next) { next = due; }
+        if (t->DIER & TIM_DIER_CC1DE) {
+          uint64_t to_compare = sim_timer_cycles_to_compare(t);
+          if (to_compare < next - sim_cycles) { next = sim_cycles + to_compare; }
+        }
+      }
+    }
+    uint8_t rx_due = false;
+    if (!(USART1->SR & USART_SR_RXNE) && sim_rx_ready() && rx_next_cycle <= next) {
+      next = rx_next_cycle;
+      rx_due = true;
+    }
+    uint8_t events[SIM_TIM_COUNT] = { 0 };
+    for (idx=1; idx<SIM_TIM_COUNT; idx++) { events[idx] = sim_timer_advance(&sim_tim[idx], next - sim_cycles); }
+    sim_cycles = next;
+    for (idx=1; idx<SIM_TIM_COUNT; idx++) {
+      if (events[idx]) { sim_timer_dma_request(&sim_tim[idx], events[idx]); }
+    }
+    if (rx_due) { sim_rx_deliver(); }
+    sim_dispatch();
+  }
+}
+
+static void sim_pace()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  double wall = (now.tv_sec - wall_start.tv_sec) + (now.tv_nsec - wall_start.tv_nsec)*1e-9;
+  double ahead = (double)sim_cycles/SystemCoreClock - wall;
+  if (ahead > 0.001) {
+    struct timespec nap = { (time_t)ahead, (long)((ahead - (time_t)ahead)*1e9) };
+    nanosleep(&nap, NULL);
+  }
+}
+
+// End of a non-interactive run: all input consumed and answered, and the machine at rest.
+static uint8_t sim_run_complete()
+{
+  if (sim_options.rx_interactive || !rx_eof || rx_has_staged) { return false; }
+  if (serial_get_rx_buffer_count() || (USART1->SR & USART_SR_RXNE)) { return false; }
+  if (responses_received < lines_sent) { return false; }
+  if (plan_get_current_block() != NULL) { return false; }
+  #ifdef MC_LINE_HOLD
+    if (mc_hold_pending()) { return false; } // Planned by the main loop once the buffer runs low.
+  #endif
+  return !(sys.state & (STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_HOMING | STATE_SAFETY_DOOR));
+}
+
+void sim_poll()
+{
+  if (in_isr || primask) { return; }
+  if (sim_options.poll_hook) {
+    sim_options.poll_hook();
+    return;
+  }
+  poll_count++;
+  sim_run_until(sim_cycles + ((uint64_t)SystemCoreClock/1000000)*sim_options.poll_us);
+  if (sim_options.realtime) { sim_pace(); }
+  if (sim_options.time_limit > 0.0 && (double)sim_cycles/SystemCoreClock >= sim_options.time_limit) {
+    fprintf(stderr, "[sim] time limit reached\n");
+    sim_shutdown(2);
+  }
+  if (sim_run_complete()) { sim_shutdown(0); }
+}
+
+uint64_t sim_get_cycles() { return sim_cycles; }
+
+uint64_t sim_host_ns()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec*1000000000 + now.tv_nsec;
+}
+
+uint32_t sim_cycle_count(void)
+{
+  if (sim_options.isr_timing) { return 0; }
+  return (uint32_t)(sim_host_ns()*(SystemCoreClock/1000000)/1000);
+}
+
+void sim_call_isr(void (*handler)(void))
+{
+  uint8_t nested = in_isr;
+  in_isr = true;
+  handler();
+  in_isr = nested;
+  sim_dispatch();
+}
+
+#ifdef PLANNER_STATS
+  // Planner workload is timed on the host, in nanoseconds.
+  uint32_t plan_stats_timestamp() { return (uint32_t)sim_host_ns(); }
+#endif
+
+void HAL_Init(void) {}
+
+uint32_t HAL_GetTick(void) { return (uint32_t)(sim_cycles/(SystemCoreClock/1000)); }
+
+void HAL_Delay(uint32_t Delay)
+{
+  if (in_isr) { return; }
+  sim_run_until(sim_cycles + ((uint64_t)SystemCoreClock/1000)*Delay);
+}
+
+void _delay_us(uint32_t x)
+{
+  if (in_isr) { return; }
+  sim_run_until(sim_cycles + ((uint64_t)SystemCoreClock/1000000)*x);
+}
+
+
+//-- GPIO ---------------------------------------------------------------------------------------
+
+// BSRR write: set bits win over reset bits, as on the target.
+void sim_gpio_write_bsrr(GPIO_TypeDef *GPIOx, uint32_t value)
+{
+  uint32_t old_odr = GPIOx->ODR;
+  GPIOx->ODR = (old_odr & ~(value >> 16)) | (value & 0xffff);
+  if (old_odr != GPIOx->ODR) { sim_gpio_output_changed(GPIOx, old_odr); }
+}
+
+// Counts step pulses on their leading edge, signed by the direction pins at that instant.
+void sim_gpio_output_changed(GPIO_TypeDef *GPIOx, uint32_t old_odr)
+{
+  if (GPIOx != STEP_GPIO_Port || sim_options.isr_timing) { return; }
+  uint32_t step_invert = 0, dir_invert = 0;
+  uint8_t idx;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (bit_istrue(settings.step_invert_mask, bit(idx))) { step_invert |= step_pin_mask[idx]; }
+    if (bit_istrue(settings.dir_invert_mask, bit(idx))) { dir_invert |= direction_pin_mask[idx]; }
+  }
+  uint32_t rising = (GPIOx->ODR ^ step_invert) & ~(old_odr ^ step_invert) & STEP_MASK;
+  if (!rising) { return; }
+  uint32_t dir = DIR_GPIO_Port->ODR ^ dir_invert;
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (rising & step_pin_mask[idx]) {
+      if (dir & direction_pin_mask[idx]) { sim_position[idx]--; }
+      else { sim_position[idx]++; }
+      sim_steps[idx]++;
+    }
+  }
+  if (sim_options.step_log) {
+    fprintf(sim_options.step_log, "%.3f", (double)sim_cycles*1e6/SystemCoreClock);
+    for (idx=0; idx<N_AXIS; idx++) { fprintf(sim_options.step_log, " %ld", (long)sim_position[idx]); }
+    fputc('\n', sim_options.step_log);
+  }
+}
+
+
+//-- Flash --------------------------------------------------------------------------------------
+
+static uint8_t *sim_flash_ptr(uint32_t Address, uint32_t Size)
+{
+  if (Address < SIM_FLASH_BASE || Address + Size > SIM_FLASH_BASE + SIM_FLASH_SIZE) {
+    fprintf(stderr, "[sim] flash access out of range: 0x%08x\n", (unsigned)Address);
+    sim_shutdown(3);
+  }
+  return (uint8_t *)(uintptr_t)Address;
+}
+
+// Maps the flash array at its real address, erased, or from the image file if one was given.
+static void sim_flash_init()
+{
+  int flags = MAP_FIXED_NOREPLACE;
+  int fd = -1;
+  uint8_t fresh = true;
+  if (sim_options.flash_file) {
+    struct stat st;
+    fd = open(sim_options.flash_file, O_RDWR | O_CREAT, 0644);
+    if (fd < 0 || fstat(fd, &st) < 0) { perror(sim_options.flash_file); exit(1); }
+    fresh = (st.st_size < (off_t)SIM_FLASH_SIZE);
+    if (fresh && ftruncate(fd, SIM_FLASH_SIZE) < 0) { perror(sim_options.flash_file); exit(1); }
+    flags |= MAP_SHARED;
+  } else {
+    flags |= MAP_PRIVATE | MAP_ANONYMOUS;
+  }
+  void *p = mmap((void *)SIM_FLASH_BASE, SIM_FLASH_SIZE, PROT_READ | PROT_WRITE, flags, fd, 0);
+  if (p != (void *)SIM_FLASH_BASE) {
+    fprintf(stderr, "[sim] unable to map flash at 0x%08lx\n", SIM_FLASH_BASE);
+    exit(1);
+  }
+  if (fresh) { memset(p, 0xff, SIM_FLASH_SIZE); }
+  if (fd >= 0) { close(fd); }
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) { return HAL_OK; }
+HAL_StatusTypeDef HAL_FLASH_Lock(void) { return HAL_OK; }
+HAL_StatusTypeDef FLASH_WaitForLastOperation(uint32_t Timeout) { (void)Timeout; return HAL_OK; }
+
+// Programming can only clear bits, so like the real controller it refuses unerased half-words.
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  (void)TypeProgram;
+  uint16_t *p = (uint16_t *)sim_flash_ptr(Address, 2);
+  if (*p != 0xffff) { return HAL_ERROR; }
+  *p = (uint16_t)Data;
+  return HAL_OK;
+}
+
+#ifdef STM32F1
+void FLASH_PageErase(uint32_t PageAddress)
+{
+  PageAddress &= ~(FLASH_PAGE_SIZE-1);
+  memset(sim_flash_ptr(PageAddress, FLASH_PAGE_SIZE), 0xff, FLASH_PAGE_SIZE);
+}
+#endif
+
+#ifdef STM32F4
+void FLASH_Erase_Sector(uint32_t Sector, uint8_t VoltageRange)
+{
+  (void)VoltageRange;
+  uint32_t address, size;
+  if (Sector < 4) { address = SIM_FLASH_BASE + Sector*0x4000; size = 0x4000; }
+  else if (Sector == 4) { address = SIM_FLASH_BASE + 0x10000; size = 0x10000; }
+  else { address = SIM_FLASH_BASE + 0x20000*(Sector-4); size = 0x20000; }
+  memset(sim_flash_ptr(address, size), 0xff, size);
+}
+#endif
+
+
+//-- SPI ----------------------------------------------------------------------------------------
+
+// The F46 I/O expanders have pull-ups on every input, so an idle bus reads all ones.
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  (void)hspi; (void)pData; (void)Size; (void)Timeout;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  (void)hspi; (void)Timeout;
+  memset(pData, 0xff, Size);
+  return HAL_OK;
+}
+
+
+//-- Control ------------------------------------------------------------------------------------
+
+void sim_init()
+{
+  uint8_t idx;
+  sim_flash_init();
+  for (idx=0; idx<SIM_GPIO_PORTS; idx++) { sim_gpio[idx].IDR = 0xffff; } // Inputs pulled up.
+  // Interrupt lines CubeMX enables in MX_NVIC_Init() and the peripheral init functions.
+  nvic_enabled[STEP_SET_IRQ] = true;
+  nvic_enabled[STEP_RESET_IRQ] = true;
+  nvic_enabled[USART1_IRQn] = true;
+  clock_gettime(CLOCK_MONOTONIC, &wall_start);
+}
+
+void sim_shutdown(int status)
+{
+  uint8_t idx;
+  sim_tx_flush();
+  if (sim_options.step_log) { fflush(sim_options.step_log); }
+  fprintf(stderr, "[sim] %.6f s virtual, %llu polls, %llu step interrupts, %llu pulse reset interrupts",
+          (double)sim_cycles/SystemCoreClock, (unsigned long long)poll_count, (unsigned long long)step_isr_count,
+          (unsigned long long)step_reset_isr_count);
+  #ifdef STEP_PULSE_DMA
+    fprintf(stderr, ", %llu step DMA interrupts", (unsigned long long)step_dma_irq_count);
+  #endif
+  fputc('\n', stderr);
+  fprintf(stderr, "[sim] steps:");
+  for (idx=0; idx<N_AXIS; idx++) { fprintf(stderr, " %llu", (unsigned long long)sim_steps[idx]); }
+  fprintf(stderr, "\n[sim] position:");
+  for (idx=0; idx<N_AXIS; idx++) { fprintf(stderr, " %ld", (long)sim_position[idx]); }
+  fputc('\n', stderr);
+  if (memcmp(sim_position, sys_position, sizeof(sim_position)) != 0) {
+    fprintf(stderr, "[sim] WARNING: step outputs disagree with sys_position:");
+    for (idx=0; idx<N_AXIS; idx++) { fprintf(stderr, " %ld", (long)sys_position[idx]); }
+    fputc('\n', stderr);
+    if (status == 0) { status = 4; }
+  }
+  exit(status);
+}
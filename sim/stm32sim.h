@@ -0,0 +1,412 @@
+/*
+  stm32sim.h - Host stand-in for the STM32 HAL/LL subset used by Grbl32
+  Part of Grbl32
+
+  Copyright (c) 2018-2019 Thomas Truong
+
+  Grbl is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Grbl is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Grbl.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Only the registers and calls that grbl/ and stm32/ actually touch are modelled. Peripherals
+  are plain structs with the same register names as CMSIS, so code like STEP_SET_TIMER->ARR
+  compiles unchanged. Anything with timing side effects (timers, NVIC, UART, flash, SysTick)
+  is routed to stm32sim.c, which owns the virtual clock.
+*/
+
+#ifndef STM32SIM_H_
+#define STM32SIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO volatile
+#define __STATIC_INLINE static inline
+
+#define SET_BIT(REG, BIT)     ((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)   ((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT)    ((REG) & (BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK)  ((REG) = (((REG) & ~(CLEARMASK)) | (SETMASK)))
+
+typedef enum { HAL_OK = 0x00U, HAL_ERROR = 0x01U, HAL_BUSY = 0x02U, HAL_TIMEOUT = 0x03U } HAL_StatusTypeDef;
+
+//-- Interrupt numbers, same values as the F1/F4 device headers -----------------------------
+typedef enum {
+  EXTI0_IRQn = 6, EXTI1_IRQn = 7, EXTI2_IRQn = 8, EXTI3_IRQn = 9, EXTI4_IRQn = 10,
+  DMA1_Channel2_IRQn = 12, // F1 only
+  TIM1_BRK_TIM9_IRQn = 24, TIM1_UP_TIM10_IRQn = 25,
+  TIM2_IRQn = 28, TIM3_IRQn = 29, TIM4_IRQn = 30,
+  USART1_IRQn = 37, EXTI15_10_IRQn = 40,
+  TIM5_IRQn = 50, TIM7_IRQn = 55
+} IRQn_Type;
+#define SIM_IRQ_COUNT 64
+
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+#define HAL_NVIC_EnableIRQ(irq)             NVIC_EnableIRQ(irq)
+#define HAL_NVIC_DisableIRQ(irq)            NVIC_DisableIRQ(irq)
+#define HAL_NVIC_ClearPendingIRQ(irq)       ((void)(irq))
+#define HAL_NVIC_SetPriority(irq, p, s)     ((void)(irq))
+#define NVIC_SetPriority(irq, p)            ((void)(irq))
+#define NVIC_GetPriorityGrouping()          0U
+#define NVIC_EncodePriority(g, p, s)        0U
+
+//-- RCC --------------------------------------------------------------------------------------
+#define LL_AHB1_GRP1_PERIPH_DMA1            0x00000001U
+#define LL_AHB1_GRP1_EnableClock(periphs)   ((void)(periphs))
+
+//-- GPIO -------------------------------------------------------------------------------------
+typedef struct {
+  __IO uint32_t IDR;  // Input levels, driven by the simulator. Defaults to all pulled high.
+  __IO uint32_t ODR;
+  __IO uint32_t BSRR; // Only written through sim_gpio_write_bsrr(), which applies it to ODR.
+} GPIO_TypeDef;
+
+#define SIM_GPIO_PORTS 5
+extern GPIO_TypeDef sim_gpio[SIM_GPIO_PORTS];
+#define GPIOA (&sim_gpio[0])
+#define GPIOB (&sim_gpio[1])
+#define GPIOC (&sim_gpio[2])
+#define GPIOD (&sim_gpio[3])
+#define GPIOE (&sim_gpio[4])
+
+#define GPIO_PIN_0    ((uint16_t)0x0001)
+#define GPIO_PIN_1    ((uint16_t)0x0002)
+#define GPIO_PIN_2    ((uint16_t)0x0004)
+#define GPIO_PIN_3    ((uint16_t)0x0008)
+#define GPIO_PIN_4    ((uint16_t)0x0010)
+#define GPIO_PIN_5    ((uint16_t)0x0020)
+#define GPIO_PIN_6    ((uint16_t)0x0040)
+#define GPIO_PIN_7    ((uint16_t)0x0080)
+#define GPIO_PIN_8    ((uint16_t)0x0100)
+#define GPIO_PIN_9    ((uint16_t)0x0200)
+#define GPIO_PIN_10   ((uint16_t)0x0400)
+#define GPIO_PIN_11   ((uint16_t)0x0800)
+#define GPIO_PIN_12   ((uint16_t)0x1000)
+#define GPIO_PIN_13   ((uint16_t)0x2000)
+#define GPIO_PIN_14   ((uint16_t)0x4000)
+#define GPIO_PIN_15   ((uint16_t)0x8000)
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+void sim_gpio_output_changed(GPIO_TypeDef *GPIOx, uint32_t old_odr);
+void sim_gpio_write_bsrr(GPIO_TypeDef *GPIOx, uint32_t value);
+void sim_poll();
+
+__STATIC_INLINE uint32_t LL_GPIO_ReadInputPort(GPIO_TypeDef *GPIOx)
+{
+  sim_poll(); // Polling an input from the main loop costs time, so let interrupts catch up.
+  return GPIOx->IDR;
+}
+__STATIC_INLINE uint32_t LL_GPIO_ReadOutputPort(GPIO_TypeDef *GPIOx) { return GPIOx->ODR; }
+__STATIC_INLINE void LL_GPIO_WriteOutputPort(GPIO_TypeDef *GPIOx, uint32_t PortValue)
+{
+  uint32_t old_odr = GPIOx->ODR;
+  GPIOx->ODR = PortValue;
+  if (old_odr != PortValue) { sim_gpio_output_changed(GPIOx, old_odr); }
+}
+__STATIC_INLINE void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+  if (PinState != GPIO_PIN_RESET) { LL_GPIO_WriteOutputPort(GPIOx, GPIOx->ODR | GPIO_Pin); }
+  else { LL_GPIO_WriteOutputPort(GPIOx, GPIOx->ODR & ~(uint32_t)GPIO_Pin); }
+}
+__STATIC_INLINE GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+  return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+//-- EXTI -------------------------------------------------------------------------------------
+__STATIC_INLINE void LL_EXTI_ClearFlag_0_31(uint32_t ExtiLine) { (void)ExtiLine; }
+
+//-- Timers -----------------------------------------------------------------------------------
+typedef struct {
+  __IO uint32_t CR1;
+  __IO uint32_t DIER;
+  __IO uint32_t SR;
+  __IO uint32_t EGR;
+  __IO uint32_t CCER;
+  __IO uint32_t CNT;
+  __IO uint32_t PSC;
+  __IO uint32_t ARR;
+  __IO uint32_t CCR1;
+  __IO uint32_t CCR2;
+  __IO uint32_t CCR3;
+  __IO uint32_t CCR4;
+  __IO uint32_t BDTR;
+  uint32_t sim_psc_active;  // Simulator only: PSC is preloaded and takes effect on the next update event.
+  uint32_t sim_arr_active;  // Simulator only: ARR in effect while ARPE preloads it until the next update.
+  uint32_t sim_psc_count;   // Simulator only: CPU cycles elapsed into the current counter tick.
+} TIM_TypeDef;
+
+#define SIM_TIM_COUNT 15
+extern TIM_TypeDef sim_tim[SIM_TIM_COUNT];
+#define TIM1  (&sim_tim[1])
+#define TIM2  (&sim_tim[2])
+#define TIM3  (&sim_tim[3])
+#define TIM4  (&sim_tim[4])
+#define TIM5  (&sim_tim[5])
+#define TIM6  (&sim_tim[6])
+#define TIM7  (&sim_tim[7])
+#define TIM8  (&sim_tim[8])
+#define TIM9  (&sim_tim[9])
+#define TIM10 (&sim_tim[10])
+#define TIM11 (&sim_tim[11])
+
+#define TIM_CR1_CEN     0x0001U
+#define TIM_CR1_OPM     0x0008U
+#define TIM_CR1_ARPE    0x0080U
+#define TIM_DIER_UIE    0x0001U
+#define TIM_DIER_UDE    0x0100U
+#define TIM_DIER_CC1DE  0x0200U
+#define TIM_SR_UIF      0x0001U
+#define TIM_EGR_UG      0x0001U
+#define TIM_BDTR_MOE    0x8000U
+
+#define LL_TIM_ONEPULSEMODE_SINGLE      TIM_CR1_OPM
+#define LL_TIM_ONEPULSEMODE_REPETITIVE  0x00000000U
+
+#define LL_TIM_CHANNEL_CH1  0x0001U
+#define LL_TIM_CHANNEL_CH2  0x0010U
+#define LL_TIM_CHANNEL_CH3  0x0100U
+#define LL_TIM_CHANNEL_CH4  0x1000U
+
+__STATIC_INLINE void LL_TIM_EnableCounter(TIM_TypeDef *TIMx) { SET_BIT(TIMx->CR1, TIM_CR1_CEN); }
+__STATIC_INLINE void LL_TIM_DisableCounter(TIM_TypeDef *TIMx) { CLEAR_BIT(TIMx->CR1, TIM_CR1_CEN); }
+__STATIC_INLINE void LL_TIM_EnableARRPreload(TIM_TypeDef *TIMx)
+{
+  // ARR written so far went straight to the shadow register.
+  if (!(TIMx->CR1 & TIM_CR1_ARPE)) { TIMx->sim_arr_active = TIMx->ARR; }
+  SET_BIT(TIMx->CR1, TIM_CR1_ARPE);
+}
+__STATIC_INLINE void LL_TIM_DisableARRPreload(TIM_TypeDef *TIMx) { CLEAR_BIT(TIMx->CR1, TIM_CR1_ARPE); }
+__STATIC_INLINE void LL_TIM_SetOnePulseMode(TIM_TypeDef *TIMx, uint32_t OnePulseMode) { MODIFY_REG(TIMx->CR1, TIM_CR1_OPM, OnePulseMode); }
+__STATIC_INLINE void LL_TIM_EnableIT_UPDATE(TIM_TypeDef *TIMx) { SET_BIT(TIMx->DIER, TIM_DIER_UIE); }
+__STATIC_INLINE void LL_TIM_DisableIT_UPDATE(TIM_TypeDef *TIMx) { CLEAR_BIT(TIMx->DIER, TIM_DIER_UIE); }
+__STATIC_INLINE void LL_TIM_EnableDMAReq_UPDATE(TIM_TypeDef *TIMx) { SET_BIT(TIMx->DIER, TIM_DIER_UDE); }
+__STATIC_INLINE void LL_TIM_DisableDMAReq_UPDATE(TIM_TypeDef *TIMx) { CLEAR_BIT(TIMx->DIER, TIM_DIER_UDE); }
+__STATIC_INLINE void LL_TIM_EnableDMAReq_CC1(TIM_TypeDef *TIMx) { SET_BIT(TIMx->DIER, TIM_DIER_CC1DE); }
+__STATIC_INLINE void LL_TIM_DisableDMAReq_CC1(TIM_TypeDef *TIMx) { CLEAR_BIT(TIMx->DIER, TIM_DIER_CC1DE); }
+__STATIC_INLINE void LL_TIM_SetAutoReload(TIM_TypeDef *TIMx, uint32_t AutoReload) { TIMx->ARR = AutoReload; }
+__STATIC_INLINE uint32_t LL_TIM_GetAutoReload(TIM_TypeDef *TIMx) { return TIMx->ARR; }
+__STATIC_INLINE void LL_TIM_SetPrescaler(TIM_TypeDef *TIMx, uint32_t Prescaler) { TIMx->PSC = Prescaler; }
+__STATIC_INLINE void LL_TIM_SetCounter(TIM_TypeDef *TIMx, uint32_t Counter) { TIMx->CNT = Counter; }
+__STATIC_INLINE uint32_t LL_TIM_GetCounter(TIM_TypeDef *TIMx) { return TIMx->CNT; }
+__STATIC_INLINE void LL_TIM_ClearFlag_UPDATE(TIM_TypeDef *TIMx) { CLEAR_BIT(TIMx->SR, TIM_SR_UIF); }
+__STATIC_INLINE uint32_t LL_TIM_IsActiveFlag_UPDATE(TIM_TypeDef *TIMx) { return READ_BIT(TIMx->SR, TIM_SR_UIF) == TIM_SR_UIF; }
+__STATIC_INLINE void LL_TIM_GenerateEvent_UPDATE(TIM_TypeDef *TIMx)
+{
+  // UG re-initializes the counter and prescaler and, with URS clear, raises the update flag.
+  TIMx->CNT = 0;
+  TIMx->sim_psc_active = TIMx->PSC;
+  TIMx->sim_arr_active = TIMx->ARR;
+  TIMx->sim_psc_count = 0;
+  SET_BIT(TIMx->SR, TIM_SR_UIF);
+}
+__STATIC_INLINE void LL_TIM_EnableAllOutputs(TIM_TypeDef *TIMx) { SET_BIT(TIMx->BDTR, TIM_BDTR_MOE); }
+__STATIC_INLINE void LL_TIM_DisableAllOutputs(TIM_TypeDef *TIMx) { CLEAR_BIT(TIMx->BDTR, TIM_BDTR_MOE); }
+__STATIC_INLINE void LL_TIM_CC_EnableChannel(TIM_TypeDef *TIMx, uint32_t Channels) { SET_BIT(TIMx->CCER, Channels); }
+__STATIC_INLINE void LL_TIM_CC_DisableChannel(TIM_TypeDef *TIMx, uint32_t Channels) { CLEAR_BIT(TIMx->CCER, Channels); }
+__STATIC_INLINE uint32_t LL_TIM_CC_IsEnabledChannel(TIM_TypeDef *TIMx, uint32_t Channels) { return READ_BIT(TIMx->CCER, Channels) == Channels; }
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH1(TIM_TypeDef *TIMx, uint32_t CompareValue) { TIMx->CCR1 = CompareValue; }
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH2(TIM_TypeDef *TIMx, uint32_t CompareValue) { TIMx->CCR2 = CompareValue; }
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH3(TIM_TypeDef *TIMx, uint32_t CompareValue) { TIMx->CCR3 = CompareValue; }
+__STATIC_INLINE void LL_TIM_OC_SetCompareCH4(TIM_TypeDef *TIMx, uint32_t CompareValue) { TIMx->CCR4 = CompareValue; }
+
+//-- DMA (F1 channel model) ------------------------------------------------------------------
+// Timer requests are routed to channels by stm32sim.c. Each request moves one item from CMAR
+// to CPAR, with the sizes from CCR, and counts CNDTR down, reloading it in circular mode.
+typedef struct {
+  __IO uint32_t CCR;
+  __IO uint32_t CNDTR;
+  uintptr_t CPAR;     // Host pointers, so wider than on the target.
+  uintptr_t CMAR;
+  uint32_t sim_length; // Simulator only: CNDTR value to reload and the item index base.
+} DMA_Channel_TypeDef;
+
+typedef struct {
+  __IO uint32_t ISR;
+  DMA_Channel_TypeDef CH[7];
+} DMA_TypeDef;
+
+extern DMA_TypeDef sim_dma1;
+#define DMA1 (&sim_dma1)
+
+#define DMA_CCR_EN      0x0001U
+#define DMA_CCR_TCIE    0x0002U
+#define DMA_CCR_HTIE    0x0004U
+#define DMA_ISR_GIF2    0x0010U
+#define DMA_ISR_TCIF2   0x0020U
+#define DMA_ISR_HTIF2   0x0040U
+
+#define LL_DMA_CHANNEL_1  0x00000001U
+#define LL_DMA_CHANNEL_2  0x00000002U
+#define LL_DMA_CHANNEL_3  0x00000003U
+#define LL_DMA_CHANNEL_4  0x00000004U
+#define LL_DMA_CHANNEL_5  0x00000005U
+#define LL_DMA_CHANNEL_6  0x00000006U
+#define LL_DMA_CHANNEL_7  0x00000007U
+
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH 0x00000010U
+#define LL_DMA_MODE_CIRCULAR              0x00000020U
+#define LL_DMA_PERIPH_NOINCREMENT         0x00000000U
+#define LL_DMA_MEMORY_NOINCREMENT         0x00000000U
+#define LL_DMA_MEMORY_INCREMENT           0x00000080U
+#define LL_DMA_PDATAALIGN_HALFWORD        0x00000100U
+#define LL_DMA_PDATAALIGN_WORD            0x00000200U
+#define LL_DMA_MDATAALIGN_HALFWORD        0x00000400U
+#define LL_DMA_MDATAALIGN_WORD            0x00000800U
+#define LL_DMA_PRIORITY_VERYHIGH          0x00003000U
+
+__STATIC_INLINE void LL_DMA_ConfigTransfer(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Configuration)
+{
+  DMAx->CH[Channel-1].CCR = (DMAx->CH[Channel-1].CCR & (DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_HTIE)) | Configuration;
+}
+__STATIC_INLINE void LL_DMA_ConfigAddresses(DMA_TypeDef *DMAx, uint32_t Channel, uintptr_t SrcAddress, uintptr_t DstAddress, uint32_t Direction)
+{
+  (void)Direction; // Memory to peripheral only.
+  DMAx->CH[Channel-1].CMAR = SrcAddress;
+  DMAx->CH[Channel-1].CPAR = DstAddress;
+}
+__STATIC_INLINE void LL_DMA_SetDataLength(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t NbData)
+{
+  DMAx->CH[Channel-1].CNDTR = NbData;
+  DMAx->CH[Channel-1].sim_length = NbData;
+}
+__STATIC_INLINE uint32_t LL_DMA_GetDataLength(DMA_TypeDef *DMAx, uint32_t Channel) { return DMAx->CH[Channel-1].CNDTR; }
+__STATIC_INLINE void LL_DMA_EnableChannel(DMA_TypeDef *DMAx, uint32_t Channel) { SET_BIT(DMAx->CH[Channel-1].CCR, DMA_CCR_EN); }
+__STATIC_INLINE void LL_DMA_DisableChannel(DMA_TypeDef *DMAx, uint32_t Channel) { CLEAR_BIT(DMAx->CH[Channel-1].CCR, DMA_CCR_EN); }
+__STATIC_INLINE void LL_DMA_EnableIT_HT(DMA_TypeDef *DMAx, uint32_t Channel) { SET_BIT(DMAx->CH[Channel-1].CCR, DMA_CCR_HTIE); }
+__STATIC_INLINE void LL_DMA_EnableIT_TC(DMA_TypeDef *DMAx, uint32_t Channel) { SET_BIT(DMAx->CH[Channel-1].CCR, DMA_CCR_TCIE); }
+__STATIC_INLINE uint32_t LL_DMA_IsActiveFlag_HT2(DMA_TypeDef *DMAx) { return READ_BIT(DMAx->ISR, DMA_ISR_HTIF2) == DMA_ISR_HTIF2; }
+__STATIC_INLINE uint32_t LL_DMA_IsActiveFlag_TC2(DMA_TypeDef *DMAx) { return READ_BIT(DMAx->ISR, DMA_ISR_TCIF2) == DMA_ISR_TCIF2; }
+__STATIC_INLINE void LL_DMA_ClearFlag_HT2(DMA_TypeDef *DMAx) { CLEAR_BIT(DMAx->ISR, DMA_ISR_HTIF2); }
+__STATIC_INLINE void LL_DMA_ClearFlag_TC2(DMA_TypeDef *DMAx) { CLEAR_BIT(DMAx->ISR, DMA_ISR_TCIF2); }
+__STATIC_INLINE void LL_DMA_ClearFlag_GI2(DMA_TypeDef *DMAx) { CLEAR_BIT(DMAx->ISR, DMA_ISR_GIF2 | DMA_ISR_TCIF2 | DMA_ISR_HTIF2); }
+
+//-- USART ------------------------------------------------------------------------------------
+typedef struct {
+  __IO uint32_t SR;
+  __IO uint32_t DR;
+  __IO uint32_t CR1;
+} USART_TypeDef;
+
+#define USART_CR1_RXNEIE  0x0020U
+#define USART_SR_RXNE     0x0020U
+
+extern USART_TypeDef sim_usart1;
+#define USART1_BASE ((uintptr_t)&sim_usart1)
+#define USART1      ((USART_TypeDef *)USART1_BASE)
+
+void sim_uart_transmit(uint8_t Value);
+
+__STATIC_INLINE void LL_USART_TransmitData8(USART_TypeDef *USARTx, uint8_t Value) { (void)USARTx; sim_uart_transmit(Value); }
+__STATIC_INLINE uint32_t LL_USART_IsActiveFlag_TXE(USART_TypeDef *USARTx) { (void)USARTx; return 1; }
+__STATIC_INLINE uint8_t LL_USART_ReceiveData8(USART_TypeDef *USARTx) { return (uint8_t)USARTx->DR; }
+__STATIC_INLINE void LL_USART_EnableIT_RXNE(USART_TypeDef *USARTx) { SET_BIT(USARTx->CR1, USART_CR1_RXNEIE); }
+__STATIC_INLINE uint32_t LL_USART_IsEnabledIT_RXNE(USART_TypeDef *USARTx) { return READ_BIT(USARTx->CR1, USART_CR1_RXNEIE) == USART_CR1_RXNEIE; }
+__STATIC_INLINE void LL_USART_ClearFlag_RXNE(USART_TypeDef *USARTx) { CLEAR_BIT(USARTx->SR, USART_SR_RXNE); }
+
+//-- SysTick and HAL time base ----------------------------------------------------------------
+typedef struct {
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+} SysTick_Type;
+extern SysTick_Type sim_systick;
+#define SysTick (&sim_systick)
+
+// unsigned long, as uint32_t is on ARM, so the firmware's %ld debug print matches it.
+extern unsigned long SystemCoreClock;
+
+//-- DWT cycle counter -------------------------------------------------------------------------
+// The virtual clock charges nothing for executing code, so profiling reads sim_cycle_count(),
+// host time expressed in SystemCoreClock cycles, instead of a CYCCNT register.
+typedef struct {
+  __IO uint32_t CTRL;
+  __IO uint32_t CYCCNT;
+} DWT_Type;
+extern DWT_Type sim_dwt;
+#define DWT (&sim_dwt)
+#define DWT_CTRL_CYCCNTENA_Msk        0x1UL
+
+typedef struct {
+  __IO uint32_t DEMCR;
+} CoreDebug_Type;
+extern CoreDebug_Type sim_coredebug;
+#define CoreDebug (&sim_coredebug)
+#define CoreDebug_DEMCR_TRCENA_Msk    0x01000000UL
+
+uint32_t sim_cycle_count(void);
+
+void HAL_Init(void);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+//-- Flash ------------------------------------------------------------------------------------
+// The flash array is mapped at its real address, so eeprom.c reads it through plain pointers.
+#define SIM_FLASH_BASE        0x08000000UL
+#define SIM_FLASH_SIZE        0x00100000UL
+// Pointer sized, so eeprom.c can add an offset and dereference it on a 64-bit host.
+#ifdef STM32F1
+  #define EEPROM_START_ADDRESS      ((uintptr_t)0x0800FC00)  // ADDR_FLASH_PAGE_63
+#else
+  #define EEPROM_START_ADDRESS      ((uintptr_t)0x08040000)  // ADDR_FLASH_SECTOR_6
+#endif
+
+typedef struct {
+  __IO uint32_t SR;
+  __IO uint32_t CR;
+} FLASH_TypeDef;
+extern FLASH_TypeDef sim_flash;
+#define FLASH (&sim_flash)
+
+#define FLASH_TYPEPROGRAM_HALFWORD  0x01U
+#define FLASH_TIMEOUT_VALUE         50000U
+#define FLASH_CR_PER                0x00000002U
+#define FLASH_CR_SER                0x00000002U
+#define FLASH_CR_SNB                0x000000F8U
+#define FLASH_FLAG_EOP              0x00000001U
+#define FLASH_FLAG_OPERR            0x00000002U
+#define FLASH_FLAG_WRPERR           0x00000010U
+#define FLASH_FLAG_PGAERR           0x00000020U
+#define FLASH_FLAG_PGPERR           0x00000040U
+#define FLASH_FLAG_PGSERR           0x00000080U
+#define __HAL_FLASH_CLEAR_FLAG(flag) CLEAR_BIT(FLASH->SR, (flag))
+#define VOLTAGE_RANGE_3             0x02U
+#define FLASH_SECTOR_6              6U
+
+#ifdef STM32F1
+  #define FLASH_PAGE_SIZE           0x400U  // STM32F103C8, medium density
+#endif
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef FLASH_WaitForLastOperation(uint32_t Timeout);
+void FLASH_PageErase(uint32_t PageAddress);
+void FLASH_Erase_Sector(uint32_t Sector, uint8_t VoltageRange);
+
+//-- SPI (F46 limit/input expanders) ----------------------------------------------------------
+typedef struct {
+  void *Instance;
+} SPI_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef *hspi, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+#endif /* STM32SIM_H_ */
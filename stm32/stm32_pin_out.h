@@ -45,6 +45,8 @@
   #define STEP_SET_IRQ      TIM2_IRQn
   #define STEP_RESET_TIMER  TIM3        //-- Reset Timer : Step pulse END - typically falling
   #define STEP_RESET_IRQ    TIM3_IRQn
+  #define STEP_TIMER_CLOCK  SystemCoreClock   //-- TIM2/3 on APB1 at HCLK/2, so timer clock = HCLK
+  #define STEP_ISR_CYCLES   450               //-- CPU cycles of a step ISR tick, estimated. See AMASS_ISR_LOAD
 
   #define Step_Set_EnableIRQ()        NVIC_EnableIRQ(STEP_SET_IRQ)
   #define Step_Reset_EnableIRQ()      NVIC_EnableIRQ(STEP_RESET_IRQ)
@@ -54,6 +56,17 @@
   #define Step_Set_Enable()           { LL_TIM_EnableIT_UPDATE(STEP_SET_TIMER); LL_TIM_EnableCounter(STEP_SET_TIMER); }
   #define Step_Reset_Enable()         { LL_TIM_EnableIT_UPDATE(STEP_RESET_TIMER); LL_TIM_EnableCounter(STEP_RESET_TIMER); }
 
+  //-- DMA step engine, STEP_PULSE_DMA. Fixed F103 request mapping.
+  #define STEP_DMA                    DMA1
+  #define STEP_DMA_BSRR_CHANNEL       LL_DMA_CHANNEL_2    //-- TIM2_UP  : port word to GPIOA->BSRR
+  #define STEP_DMA_ARR_CHANNEL        LL_DMA_CHANNEL_5    //-- TIM2_CH1 : next interval to TIM2->ARR, CCR1 = 0
+  #define STEP_DMA_IRQ                DMA1_Channel2_IRQn
+  #define Step_DMA_ClearFlags()       LL_DMA_ClearFlag_GI2(STEP_DMA)
+
+  //-- One-shot step pulse, STEP_PULSE_ONE_SHOT. Fixed F103 request mapping.
+  #define STEP_PULSE_SET_CHANNEL      LL_DMA_CHANNEL_6    //-- TIM3_CH1 : step word to GPIOA->BSRR after the direction setup
+  #define STEP_PULSE_RESET_CHANNEL    LL_DMA_CHANNEL_3    //-- TIM3_UP  : idle word to GPIOA->BSRR at the end of the pulse
+
   #define CON_GPIO_Port GPIOB
 
   #define OUTPUTS_PWM_FREQUENCY       10000
@@ -138,6 +151,8 @@
 	#define STEP_SET_IRQ			TIM2_IRQn
 	#define STEP_RESET_TIMER	TIM3				//-- Reset Timer : Step pulse END - typically falling
 	#define STEP_RESET_IRQ		TIM3_IRQn
+	#define STEP_TIMER_CLOCK	SystemCoreClock		//-- TIM2/3 on APB1 at HCLK/2, so timer clock = HCLK
+	#define STEP_ISR_CYCLES		600					//-- CPU cycles of a step ISR tick, estimated. See AMASS_ISR_LOAD
 
 	#define Step_Set_EnableIRQ() 				NVIC_EnableIRQ(STEP_SET_IRQ)
 	#define Step_Reset_EnableIRQ() 			NVIC_EnableIRQ(STEP_RESET_IRQ)
@@ -147,6 +162,17 @@
 	#define Step_Set_Enable()						{	LL_TIM_EnableIT_UPDATE(STEP_SET_TIMER); LL_TIM_EnableCounter(STEP_SET_TIMER); }
 	#define Step_Reset_Enable()					{ LL_TIM_EnableIT_UPDATE(STEP_RESET_TIMER); LL_TIM_EnableCounter(STEP_RESET_TIMER); }
 
+	//-- DMA step engine, STEP_PULSE_DMA. Fixed F103 request mapping.
+	#define STEP_DMA 										DMA1
+	#define STEP_DMA_BSRR_CHANNEL 			LL_DMA_CHANNEL_2		//-- TIM2_UP  : port word to GPIOA->BSRR
+	#define STEP_DMA_ARR_CHANNEL 				LL_DMA_CHANNEL_5		//-- TIM2_CH1 : next interval to TIM2->ARR, CCR1 = 0
+	#define STEP_DMA_IRQ 								DMA1_Channel2_IRQn
+	#define Step_DMA_ClearFlags() 			LL_DMA_ClearFlag_GI2(STEP_DMA)
+
+	//-- One-shot step pulse, STEP_PULSE_ONE_SHOT. Fixed F103 request mapping.
+	#define STEP_PULSE_SET_CHANNEL 			LL_DMA_CHANNEL_6		//-- TIM3_CH1 : step word to GPIOA->BSRR after the direction setup
+	#define STEP_PULSE_RESET_CHANNEL 		LL_DMA_CHANNEL_3		//-- TIM3_UP  : idle word to GPIOA->BSRR at the end of the pulse
+
 	#define CON_GPIO_Port GPIOB
 
 	#define OUTPUTS_PWM_FREQUENCY       10000
@@ -223,6 +249,8 @@
 	#define STEP_SET_IRQ			TIM5_IRQn
 	#define STEP_RESET_TIMER	TIM7				//-- Reset Timer : Step pulse END - typically falling
 	#define STEP_RESET_IRQ		TIM7_IRQn
+	#define STEP_TIMER_CLOCK	(SystemCoreClock/2)	//-- TIM5/7 on APB1 at HCLK/4, so timer clock = HCLK/2 = 84MHz. See README, F46 step timing
+	#define STEP_ISR_CYCLES		500					//-- CPU cycles of a step ISR tick, estimated. See AMASS_ISR_LOAD
 
 /*
 #define STEP_SET_TIMER 		TIM9				//-- Set Timer : Step pulse START - typically rising
@@ -187,7 +187,9 @@
 	#define ADDR_FLASH_PAGE_127   ((uint32_t)0x0801FC00) /* Base @ of Page 127, 1 Kbytes */
 
 //	#define EEPROM_START_ADDRESS  ADDR_FLASH_PAGE_127		//-- use the last page
+#ifndef EEPROM_START_ADDRESS
   #define EEPROM_START_ADDRESS  ADDR_FLASH_PAGE_63   //-- use the last page of 64K
+#endif
 	extern void FLASH_PageErase(uint32_t PageAddress);	//-- this was NOT exported from stem32f1xx_hal_flash_ex.c for some reason
 
 
@@ -213,7 +215,9 @@
 	#define ADDR_FLASH_SECTOR_11 		((uint32_t)0x080E0000) /* Base @ of Sector 11, 128 Kbytes */
 
 	#define EEPROM_START_SECTOR   	FLASH_SECTOR_6   			/* Start sector of user Flash area */
+#ifndef EEPROM_START_ADDRESS
 	#define EEPROM_START_ADDRESS   	ADDR_FLASH_SECTOR_6   /* Start @ of user Flash area */
+#endif
 
 
 #endif
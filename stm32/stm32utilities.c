@@ -105,8 +105,14 @@ char pDbgVal16[17];
 //-------------------------------------------------------------------
 void timing_init()
 {
-	uTICKS_PER_MICROSECOND = SystemCoreClock / 1000000;
-	fTICKS_PER_MINUTE = SystemCoreClock * 60.0f;
+	//-- step and pulse timers count at their bus timer clock, not necessarily the core clock
+	uTICKS_PER_MICROSECOND = STEP_TIMER_CLOCK / 1000000;
+	fTICKS_PER_MINUTE = STEP_TIMER_CLOCK * 60.0f;
+
+	//-- start the DWT cycle counter, used for profiling
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 //-- quick debug functions ------------------------------------------
@@ -168,6 +174,7 @@ void uart_sendch(uint8_t uC)
 
 //------------------------------------------------------------------------
 //------------------------------------------------------------------------
+#ifndef Spindle_Disable	//-- F16 and F46 map these to timer macros in stm32_pin_out.h
 void Spindle_Disable()
 {
 #ifdef VARIABLE_SPINDLE_ENABLE_PIN
@@ -191,6 +198,7 @@ void Spindle_Enable()
 
   LL_TIM_EnableAllOutputs(SPINDLE_TIMER);
 }
+#endif
 
 
     //------------------------------------------------------------------------
@@ -206,6 +214,92 @@ void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
 }
 //------------------------------------------------------------------------
 
+#ifdef STEP_PULSE_DMA
+//-- DMA step engine. Every STEP_SET_TIMER update requests two circular transfers: the next port
+//-- word to the step port BSRR, and, through the CC1 match at CNT = 0, the next interval to ARR.
+void Step_DMA_Init()
+{
+	LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+	LL_DMA_ConfigTransfer(STEP_DMA, STEP_DMA_BSRR_CHANNEL, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_CIRCULAR |
+		LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD | LL_DMA_PRIORITY_VERYHIGH);
+	LL_DMA_ConfigTransfer(STEP_DMA, STEP_DMA_ARR_CHANNEL, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_CIRCULAR |
+		LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_INCREMENT | LL_DMA_PDATAALIGN_HALFWORD | LL_DMA_MDATAALIGN_HALFWORD | LL_DMA_PRIORITY_VERYHIGH);
+	LL_DMA_EnableIT_HT(STEP_DMA, STEP_DMA_BSRR_CHANNEL);
+	LL_DMA_EnableIT_TC(STEP_DMA, STEP_DMA_BSRR_CHANNEL);
+	LL_TIM_OC_SetCompareCH1(STEP_SET_TIMER, 0);
+
+	NVIC_SetPriority(STEP_DMA_IRQ, NVIC_EncodePriority(NVIC_GetPriorityGrouping(),0, 0));
+	NVIC_EnableIRQ(STEP_DMA_IRQ);
+}
+
+void Step_DMA_Start(uint32_t *pBSRR, uint16_t *pARR, uint16_t uLength, uint16_t uFirstARR)
+{
+	LL_DMA_ConfigAddresses(STEP_DMA, STEP_DMA_BSRR_CHANNEL, (uintptr_t)pBSRR, (uintptr_t)&STEP_GPIO_Port->BSRR, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+	LL_DMA_ConfigAddresses(STEP_DMA, STEP_DMA_ARR_CHANNEL, (uintptr_t)pARR, (uintptr_t)&STEP_SET_TIMER->ARR, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+	LL_DMA_SetDataLength(STEP_DMA, STEP_DMA_BSRR_CHANNEL, uLength);
+	LL_DMA_SetDataLength(STEP_DMA, STEP_DMA_ARR_CHANNEL, uLength);
+	LL_DMA_EnableChannel(STEP_DMA, STEP_DMA_BSRR_CHANNEL);
+	LL_DMA_EnableChannel(STEP_DMA, STEP_DMA_ARR_CHANNEL);
+
+	//-- ARR is not preloaded, each interval written by the DMA runs from its own update
+	LL_TIM_DisableARRPreload(STEP_SET_TIMER);
+	LL_TIM_SetAutoReload(STEP_SET_TIMER, uFirstARR);
+	LL_TIM_SetCounter(STEP_SET_TIMER, 0);
+	LL_TIM_EnableDMAReq_UPDATE(STEP_SET_TIMER);
+	LL_TIM_EnableDMAReq_CC1(STEP_SET_TIMER);
+}
+
+//-- returns the number of transfers left before the buffer wraps
+uint16_t Step_DMA_Stop()
+{
+	LL_TIM_DisableDMAReq_UPDATE(STEP_SET_TIMER);
+	LL_TIM_DisableDMAReq_CC1(STEP_SET_TIMER);
+	uint16_t uRemaining = LL_DMA_GetDataLength(STEP_DMA, STEP_DMA_BSRR_CHANNEL);
+	LL_DMA_DisableChannel(STEP_DMA, STEP_DMA_BSRR_CHANNEL);
+	LL_DMA_DisableChannel(STEP_DMA, STEP_DMA_ARR_CHANNEL);
+	Step_DMA_ClearFlags();
+	return uRemaining;
+}
+#endif
+
+#ifdef STEP_PULSE_ONE_SHOT
+//-- One-shot step pulse. STEP_RESET_TIMER runs once per step in one-pulse mode: its CC1 match
+//-- after the direction setup time requests the step word, its update at the end of the pulse
+//-- the idle word, each a circular one-word transfer to the step port BSRR, and the counter stops.
+void Step_Pulse_Init(uint32_t *pStepBSRR, uint32_t *pIdleBSRR)
+{
+	LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+	LL_DMA_ConfigTransfer(DMA1, STEP_PULSE_SET_CHANNEL, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_CIRCULAR |
+		LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_NOINCREMENT | LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD | LL_DMA_PRIORITY_VERYHIGH);
+	LL_DMA_ConfigTransfer(DMA1, STEP_PULSE_RESET_CHANNEL, LL_DMA_DIRECTION_MEMORY_TO_PERIPH | LL_DMA_MODE_CIRCULAR |
+		LL_DMA_PERIPH_NOINCREMENT | LL_DMA_MEMORY_NOINCREMENT | LL_DMA_PDATAALIGN_WORD | LL_DMA_MDATAALIGN_WORD | LL_DMA_PRIORITY_VERYHIGH);
+	LL_DMA_ConfigAddresses(DMA1, STEP_PULSE_SET_CHANNEL, (uintptr_t)pStepBSRR, (uintptr_t)&STEP_GPIO_Port->BSRR, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+	LL_DMA_ConfigAddresses(DMA1, STEP_PULSE_RESET_CHANNEL, (uintptr_t)pIdleBSRR, (uintptr_t)&STEP_GPIO_Port->BSRR, LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+	LL_DMA_SetDataLength(DMA1, STEP_PULSE_SET_CHANNEL, 1);
+	LL_DMA_SetDataLength(DMA1, STEP_PULSE_RESET_CHANNEL, 1);
+	LL_DMA_EnableChannel(DMA1, STEP_PULSE_SET_CHANNEL);
+	LL_DMA_EnableChannel(DMA1, STEP_PULSE_RESET_CHANNEL);
+
+	LL_TIM_DisableCounter(STEP_RESET_TIMER);
+	LL_TIM_DisableIT_UPDATE(STEP_RESET_TIMER);
+	LL_TIM_SetOnePulseMode(STEP_RESET_TIMER, LL_TIM_ONEPULSEMODE_SINGLE);
+	LL_TIM_EnableDMAReq_CC1(STEP_RESET_TIMER);
+	LL_TIM_EnableDMAReq_UPDATE(STEP_RESET_TIMER);
+}
+
+//-- Both in timer ticks. The CC1 match needs a count of at least 1, the update comes one count
+//-- after CNT = ARR.
+void Step_Pulse_Timing(uint32_t uSetupTicks, uint32_t uPulseTicks)
+{
+	if (uSetupTicks == 0) { uSetupTicks = 1; }
+	if (uPulseTicks == 0) { uPulseTicks = 1; }
+	LL_TIM_DisableCounter(STEP_RESET_TIMER);
+	LL_TIM_SetCounter(STEP_RESET_TIMER, 0);
+	LL_TIM_OC_SetCompareCH1(STEP_RESET_TIMER, uSetupTicks);
+	LL_TIM_SetAutoReload(STEP_RESET_TIMER, uSetupTicks + uPulseTicks - 1);
+}
+#endif
+
 #ifdef STM32F46   //-- board specific hardware, SPI driven limits
 uint8_t SPIDataC0W[3]; // 		= { 0x40, 0x00, 0x00 };		//-- Chip0, Limits P & N
 uint8_t SPIDataC0R[3]; //		= { 0x41, 0x00, 0x00 };
@@ -46,6 +46,13 @@ extern const PIN_MASK limit_pin_mask[N_AXIS];
 extern uint32_t uTICKS_PER_MICROSECOND;
 extern float fTICKS_PER_MINUTE;
 
+//-- CPU cycle counter for profiling, enabled by timing_init()
+#ifdef STM32_SIM
+	#define GetCycleCount()		sim_cycle_count()
+#else
+	#define GetCycleCount()		(DWT->CYCCNT)
+#endif
+
 //-- Stepper
 /*
 void Step_IT_Stop();
@@ -77,17 +84,38 @@ void Limit_IT_Start();
 */
 
 
+#ifndef Spindle_Disable	//-- F16 and F46 map these to timer macros in stm32_pin_out.h
 void Spindle_Disable();
 void Spindle_Enable();
+#endif
 
 
 void timing_init();
 
+#ifdef STEP_PULSE_DMA
+void Step_DMA_Init();
+void Step_DMA_Start(uint32_t *pBSRR, uint16_t *pARR, uint16_t uLength, uint16_t uFirstARR);
+uint16_t Step_DMA_Stop();
+#endif
+
+#ifdef STEP_PULSE_ONE_SHOT
+void Step_Pulse_Init(uint32_t *pStepBSRR, uint32_t *pIdleBSRR);
+void Step_Pulse_Timing(uint32_t uSetupTicks, uint32_t uPulseTicks);
+//-- Restarts the one-pulse timer from the step interrupt: step edge after the setup time
+#define Step_Pulse_Fire()		{ LL_TIM_SetCounter(STEP_RESET_TIMER, 0); LL_TIM_EnableCounter(STEP_RESET_TIMER); }
+#endif
+
 //-- PIN IO, to replace legacy SPL calls to LL and HAL
 //-- Port based calls
 #define GPIO_ReadInputData 		LL_GPIO_ReadInputPort
 #define GPIO_ReadOutputData		LL_GPIO_ReadOutputPort
 #define GPIO_Write 						LL_GPIO_WriteOutputPort
+//-- Atomic port update through BSRR: bits 0-15 set pins, bits 16-31 reset them. No read-modify-write.
+#ifdef STM32_SIM
+	#define GPIO_SetResetBits(GPIOx, uBSRR)		sim_gpio_write_bsrr(GPIOx, uBSRR)
+#else
+	#define GPIO_SetResetBits(GPIOx, uBSRR)		WRITE_REG((GPIOx)->BSRR, (uBSRR))
+#endif
 //-- Pin based calls, need to use HAL since LL pins and HAL pins are incompatible for F1
 void GPIO_ResetBits (GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
 void GPIO_SetBits	(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);